@@ -7,8 +7,8 @@
 # Library dependency graph:
 #   **add_sub_bf16** -> ln_bf16
 #
-# Version: 0.1.0
-# Tested: 2023-10-09T11:32:00+08:00
+# Version: 0.1.1
+# Tested: 2026-10-18T17:50:00+08:00
 
 .text
 
@@ -91,6 +91,13 @@ add_sub_bf16_test:
         li   t0, 0xC0900000
         li   t1, 7 # error code
         bne  t0, a0, asbt_epilogue
+    asbt_t8:
+        li   a0, 0x3F800000
+        li   a1, 0x2F800000
+        jal  ra, add_bf16
+        li   t0, 0x3F800000
+        li   t1, 8 # error code
+        bne  t0, a0, asbt_epilogue
     asbt_all_passed:
         li   t1, 0
     asbt_epilogue:
@@ -147,12 +154,20 @@ add_sub_bf16:
         blt  t2, t3, asb_normalization_1
         mv   t6, t2      # t6 = ea
         sub  t2, t2, t3 # t2 = ea - eb
+        li   t0, 8
+        bge  t0, t2, asb_clamp_b
+        li   t2, 8       # mb >> 8 is already 0; srl only uses 5 bits
+    asb_clamp_b:
         srl  t5, t5, t2 # mb >>= t2
         mv   t2, t6      # e = t6
         j    asb_normalization_end
     asb_normalization_1:
         mv   t6, t3      # t6 = eb
         sub  t2, t3, t2 # t2 = ea - eb
+        li   t0, 8
+        bge  t0, t2, asb_clamp_a
+        li   t2, 8       # ma >> 8 is already 0; srl only uses 5 bits
+    asb_clamp_a:
         srl  t4, t4, t2 # ma >>= t2
         mv   t2, t6      # e = t6
     asb_normalization_end:
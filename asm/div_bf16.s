@@ -0,0 +1,827 @@
+# This program implements and tests reciprocal and division of bf16
+# numbers, with an initial guess of the reciprocal of the mantissa from
+# a 16-entry table, and Newton steps.
+#
+# For including as a library, include only codes in…
+# (1) all of the "Required Library" sections, and
+# (2) the "Library" and "Library Data" sections.
+#
+# Library dependency graph:
+#                    add_sub_bf16 ↘
+#   mul_shift_u32 -> mul_bf16 ----> **recip_bf16**, **div_bf16**
+#
+# Version: 0.0.0
+# Tested: 2026-10-18T21:40:00+08:00
+#
+# reference: ../src/div_bf16.c
+
+.text
+
+# ┌-------------------------------------------------------┐
+# |                     Testing Suite                     |
+# └-------------------------------------------------------┘
+
+.equ DB_N, 128 # all the bf16 mantissas
+
+.globl main
+main:
+    # test all functionalities
+    jal  ra, div_bf16_test
+    # returns a0 = 0 for success, or non-zero for index of failed test
+
+    # print result
+    jal ra, print_int
+    li a0, '\n'
+    jal ra, print_char
+
+    # print the number of cycles of recip_bf16 and div_bf16
+    jal ra, div_bf16_bench
+
+    # exit program
+    li a0, 0
+    j exit
+
+
+# --- div_bf16_hash ---
+    # fold a result into the hash of a sweep, h = (h * 33) ^ (r >> 16)
+    # input:
+    #   a0: r (bf16): result
+    #   a1: h (u32): hash so far
+    # output:
+    #   a0: h (u32): new hash
+div_bf16_hash:
+        slli t0, a1, 5
+        add  t0, t0, a1
+        srli a0, a0, 16
+        xor  a0, a0, t0
+        ret
+
+
+# --- div_bf16_test ---
+    # test the functionalities of recip_bf16 and div_bf16
+    # input: nothing
+    # output:
+    #   a0: error_code: 0 for success
+    #                   otherwise, index of the first failed test
+    # notes:
+    #   the answers are generated by the C program, for the
+    #   results of both should be identical
+    #   s0: x, or index of a pair
+    #   s1: hash of the results
+div_bf16_test:
+    dbt_prologue:
+        addi sp, sp, -12
+        sw   ra, 0(sp)
+        sw   s0, 4(sp)
+        sw   s1, 8(sp)
+    dbt_t1:
+        li   a0, 0x40000000 # 2.0
+        jal  ra, recip_bf16
+        li   t0, 0x3F000000 # 0.5
+        li   t1, 1 # error code
+        bne  t0, a0, dbt_epilogue
+    dbt_t2:
+        li   a0, 0xC0400000 # -3.0
+        jal  ra, recip_bf16
+        li   t0, 0xBEAA0000 # -0.3320
+        li   t1, 2 # error code
+        bne  t0, a0, dbt_epilogue
+    dbt_t3:
+        li   a0, 0x80000000 # -0.0
+        jal  ra, recip_bf16
+        li   t0, 0xFF800000 # -inf
+        li   t1, 3 # error code
+        bne  t0, a0, dbt_epilogue
+        li   a0, 0xFF800000 # -inf
+        jal  ra, recip_bf16
+        li   t0, 0x80000000 # -0.0
+        li   t1, 3 # error code
+        bne  t0, a0, dbt_epilogue
+        li   a0, 0x7FC10000 # NaN
+        jal  ra, recip_bf16
+        li   t0, 0x7FC00000 # NaN
+        li   t1, 3 # error code
+        bne  t0, a0, dbt_epilogue
+        li   a0, 0x7F000000 # 2^127
+        jal  ra, recip_bf16
+        li   t1, 3 # error code
+        bnez a0, dbt_epilogue # 0 (underflow)
+    dbt_t4:
+        li   a0, 0x40C00000 # 6.0
+        li   a1, 0x40400000 # 3.0
+        jal  ra, div_bf16
+        li   t0, 0x40000000 # 2.0
+        li   t1, 4 # error code
+        bne  t0, a0, dbt_epilogue
+        li   a0, 0x3F800000 # 1.0
+        li   a1, 0x41200000 # 10.0
+        jal  ra, div_bf16
+        li   t0, 0x3DCD0000 # 0.1001
+        li   t1, 4 # error code
+        bne  t0, a0, dbt_epilogue
+        li   a0, 0xC0E00000 # -7.0
+        li   a1, 0x3F000000 # 0.5
+        jal  ra, div_bf16
+        li   t0, 0xC1600000 # -14.0
+        li   t1, 4 # error code
+        bne  t0, a0, dbt_epilogue
+    dbt_t5:
+        li   a0, 0x00000000 # 0.0
+        li   a1, 0x80000000 # -0.0
+        jal  ra, div_bf16
+        li   t0, 0x7FC00000 # NaN
+        li   t1, 5 # error code
+        bne  t0, a0, dbt_epilogue
+        li   a0, 0x7F800000 # inf
+        li   a1, 0xFF800000 # -inf
+        jal  ra, div_bf16
+        li   t0, 0x7FC00000 # NaN
+        li   t1, 5 # error code
+        bne  t0, a0, dbt_epilogue
+        li   a0, 0xBF800000 # -1.0
+        li   a1, 0x00000000 # 0.0
+        jal  ra, div_bf16
+        li   t0, 0xFF800000 # -inf
+        li   t1, 5 # error code
+        bne  t0, a0, dbt_epilogue
+        li   a0, 0xFF800000 # -inf
+        li   a1, 0x40000000 # 2.0
+        jal  ra, div_bf16
+        li   t0, 0xFF800000 # -inf
+        li   t1, 5 # error code
+        bne  t0, a0, dbt_epilogue
+        li   a0, 0x80000000 # -0.0
+        li   a1, 0x40000000 # 2.0
+        jal  ra, div_bf16
+        li   t0, 0x80000000 # -0.0
+        li   t1, 5 # error code
+        bne  t0, a0, dbt_epilogue
+        li   a0, 0x3F800000 # 1.0
+        li   a1, 0xFF800000 # -inf
+        jal  ra, div_bf16
+        li   t0, 0x80000000 # -0.0
+        li   t1, 5 # error code
+        bne  t0, a0, dbt_epilogue
+    dbt_t6:
+        li   a0, 0x7F000000 # 2^127
+        li   a1, 0x3F000000 # 0.5
+        jal  ra, div_bf16
+        li   t0, 0x7F800000 # inf (overflow)
+        li   t1, 6 # error code
+        bne  t0, a0, dbt_epilogue
+        li   a0, 0x00800000 # 2^-126
+        li   a1, 0x40800000 # 4.0
+        jal  ra, div_bf16
+        li   t1, 6 # error code
+        bnez a0, dbt_epilogue # 0 (underflow)
+    dbt_t7:
+        # recip_bf16 of all the 65536 bf16 numbers
+        li   s0, 0
+        li   s1, 0
+    dbt_t7_loop:
+        slli a0, s0, 16
+        jal  ra, recip_bf16
+        mv   a1, s1
+        jal  ra, div_bf16_hash
+        mv   s1, a0
+        addi s0, s0, 1
+        li   t0, 0x10000
+        bne  s0, t0, dbt_t7_loop
+        li   t0, 0xE5907A00 # hash of the C program
+        li   t1, 7 # error code
+        bne  t0, s1, dbt_epilogue
+    dbt_t8:
+        # div_bf16 of all the pairs of mantissas and signs, which decide
+        # the results except for overflow and underflow (test 6), i.e.,
+        # a = (-1)^s(14) * 1.f(6:0) and b = (-1)^s(15) * 1.f(13:7)
+        li   s0, 0
+        li   s1, 0
+    dbt_t8_loop:
+        srli t0, s0, 14
+        andi t0, t0, 1
+        slli t0, t0, 31
+        andi t1, s0, 0x7F
+        slli t1, t1, 16
+        or   a0, t0, t1
+        li   t0, 0x3F800000
+        or   a0, a0, t0 # a
+        srli t0, s0, 15
+        slli t0, t0, 31
+        srli t1, s0, 7
+        andi t1, t1, 0x7F
+        slli t1, t1, 16
+        or   a1, t0, t1
+        li   t0, 0x3F800000
+        or   a1, a1, t0 # b
+        jal  ra, div_bf16
+        mv   a1, s1
+        jal  ra, div_bf16_hash
+        mv   s1, a0
+        addi s0, s0, 1
+        li   t0, 0x10000
+        bne  s0, t0, dbt_t8_loop
+        li   t0, 0x7F46B880 # hash of the C program
+        li   t1, 8 # error code
+        bne  t0, s1, dbt_epilogue
+    dbt_all_passed:
+        li   t1, 0
+    dbt_epilogue:
+        mv   a0, t1 # error code
+        lw   ra, 0(sp)
+        lw   s0, 4(sp)
+        lw   s1, 8(sp)
+        addi sp, sp, 12
+        ret
+
+
+# --- div_bf16_bench ---
+    # print the number of cycles of recip_bf16 for the DB_N numbers in
+    # [1, 2), and of div_bf16 for them divided by 1.5
+    # input: nothing
+    # output: nothing
+    # notes:
+    #   s0: x
+    #   s1: cycle counter at the beginning
+    #   s2: the end of x
+div_bf16_bench:
+    dbb_prologue:
+        addi sp, sp, -16
+        sw   ra, 0(sp)
+        sw   s0, 4(sp)
+        sw   s1, 8(sp)
+        sw   s2, 12(sp)
+    dbb_recip:
+        li   s0, 0x3F800000
+        li   s2, 0x40000000
+        rdcycle s1
+    dbb_recip_loop:
+        mv   a0, s0
+        jal  ra, recip_bf16
+        li   t0, 0x10000
+        add  s0, s0, t0
+        bne  s0, s2, dbb_recip_loop
+        rdcycle s0
+        sub  s0, s0, s1
+        la   a0, db_str_recip_bf16
+        jal  ra, print_string
+        mv   a0, s0
+        jal  ra, print_int
+        la   a0, db_str_cycles
+        jal  ra, print_string
+    dbb_div:
+        li   s0, 0x3F800000
+        rdcycle s1
+    dbb_div_loop:
+        mv   a0, s0
+        li   a1, 0x3FC00000 # 1.5
+        jal  ra, div_bf16
+        li   t0, 0x10000
+        add  s0, s0, t0
+        bne  s0, s2, dbb_div_loop
+        rdcycle s0
+        sub  s0, s0, s1
+        la   a0, db_str_div_bf16
+        jal  ra, print_string
+        mv   a0, s0
+        jal  ra, print_int
+        la   a0, db_str_cycles
+        jal  ra, print_string
+    dbb_epilogue:
+        lw   ra, 0(sp)
+        lw   s0, 4(sp)
+        lw   s1, 8(sp)
+        lw   s2, 12(sp)
+        addi sp, sp, 16
+        ret
+
+
+# ┌-------------------------------------------------------┐
+# |         Required Library - add_sub_bf16 v0.1.1        |
+# └-------------------------------------------------------┘
+
+# --- add_sub_bf16 ---
+    # addition or subtraction of two bf16 numbers
+    # input:
+    #   a0: a (bf16): add/sub candidate
+    #   a1: b (bf16): add/sub candidate
+    #   a2: to_add (int): 1 for addition; 0 for subtraction
+    # output:
+    #   a0: r (bf16): result of (a + b) or (a - b)
+    # notes:
+    #   t0: sa, s
+    #   t1: sb
+    #   t2: ea, e
+    #   t3: eb
+    #   t4: ma, m
+    #   t5: mb
+    #   t6: (always temp)
+add_sub_bf16:
+    asb_prologue:
+        addi sp, sp, -4
+        sw   ra, 0(sp)
+    asb_body:
+        # extract expoent and mantissa from a and b
+        li   t6, 0x7F800000
+        and  t2, a0, t6 # ea
+        srli t2, t2, 23
+        addi t2, t2, -127
+        li   t6, 0x7F800000
+        and  t3, a1, t6 # eb
+        srli t3, t3, 23
+        addi t3, t3, -127
+        li   t6, 0x007F0000
+        and  t4, a0, t6 # ma
+        srli t4, t4, 16
+        ori  t4, t4, 0x80
+        li   t6, 0x007F0000
+        and  t5, a1, t6 # mb
+        srli t5, t5, 16
+        ori  t5, t5, 0x80
+
+        # normalization: make 2 numbers have the same exponent
+        blt  t2, t3, asb_normalization_1
+        mv   t6, t2      # t6 = ea
+        sub  t2, t2, t3 # t2 = ea - eb
+        li   t0, 8
+        bge  t0, t2, asb_clamp_b
+        li   t2, 8       # mb >> 8 is already 0; srl only uses 5 bits
+    asb_clamp_b:
+        srl  t5, t5, t2 # mb >>= t2
+        mv   t2, t6      # e = t6
+        j    asb_normalization_end
+    asb_normalization_1:
+        mv   t6, t3      # t6 = eb
+        sub  t2, t3, t2 # t2 = ea - eb
+        li   t0, 8
+        bge  t0, t2, asb_clamp_a
+        li   t2, 8       # ma >> 8 is already 0; srl only uses 5 bits
+    asb_clamp_a:
+        srl  t4, t4, t2 # ma >>= t2
+        mv   t2, t6      # e = t6
+    asb_normalization_end:
+        # addition or subtraction
+        li   t6, 0x80000000
+        and  t0, a0, t6 # sa
+        beqz t0, asb_not_invert_ma
+        sub  t4, zero, t4
+    asb_not_invert_ma:
+        li   t6, 0x80000000
+        and  t1, a1, t6 # sb
+        beqz t1, asb_not_invert_mb_1
+        sub  t5, zero, t5
+    asb_not_invert_mb_1:
+        bnez a2, asb_not_invert_mb_2
+        sub  t5, zero, t5
+    asb_not_invert_mb_2:
+        add  t4, t4, t5 # m = ma + mb
+        # handle negative result
+        li   t0, 0
+        bgez t4, asb_positive_m
+        sub  t4, zero, t4
+        li   t0, 1
+    asb_positive_m:
+        # handle carry bit
+        andi t5, t4, 0x100
+        beqz t5, asb_no_carry
+        srli t4, t4, 1
+        addi t2, t2, 1
+    asb_no_carry:
+        # handle result of 0
+        li   t5, 0x80
+        bnez t4, asb_small
+        li   t2, -127     # e = -127
+        j    asb_small_end
+    asb_small:
+        bge  t4, t5, asb_small_end # while (m < 0x80)
+        addi t2, t2, -1 # e -= 1
+        slli t4, t4, 1  # m <<= 1
+        j    asb_small
+    asb_small_end:
+        # construct the result
+        slli t0, t0, 31   # s = s << 31
+        addi t2, t2, 127  # e = (e + 127) << 23
+        slli t2, t2, 23
+        andi t4, t4, 0x7F # m = (m & 0x7F) << 16
+        slli t4, t4, 16
+        or   a0, t0, t2   # r = s | e | m
+        or   a0, a0, t4
+    asb_epilogue:
+        lw   ra, 0(sp)
+        addi sp, sp, 4
+        ret
+
+
+# --- add_bf16 ---
+    # addition of two bf16 numbers.
+    # input:
+    #   a0: a (bf16): addition candidate
+    #   a1: b (bf16): addition candidate
+    # output:
+    #   a0: r (bf16): reslut of (a + b)
+add_bf16:
+        addi sp, sp, -4
+        sw   ra, 0(sp)
+        li   a2, 1
+        jal  ra, add_sub_bf16
+        lw   ra, 0(sp)
+        addi sp, sp, 4
+        ret
+
+
+# --- sub_bf16 ---
+    # subtraction of two bf16 numbers.
+    # input:
+    #   a0: a (bf16): subtraction candidate
+    #   a1: b (bf16): subtraction candidate
+    # output:
+    #   a0: r (bf16): reslut of (a - b)
+sub_bf16:
+        addi sp, sp, -4
+        sw   ra, 0(sp)
+        li   a2, 0
+        jal  ra, add_sub_bf16
+        lw   ra, 0(sp)
+        addi sp, sp, 4
+        ret
+
+
+# ┌-------------------------------------------------------┐
+# |        Required Library - mul_shift_u32 v0.0.0        |
+# └-------------------------------------------------------┘
+
+# --- mul_shift_u32 ---
+    # binary multiplication of two u32 numbers
+    # input:
+    #   a0: a (u32): multiplier
+    #   a1: b (u32): multiplicand
+    # output:
+    #   a0: r (u32): product of a and b (a * b)
+mul_shift_u32:
+    mhu_prologue:
+        addi sp, sp, -4
+        sw   ra, 0(sp)
+        bge  a0, a1, mhu_no_swap
+        # make a1 <= a0
+        addi t0, a1, 0
+        mv   a1, a0
+        mv   a0, t0
+    mhu_no_swap:
+        # binary multiplication of t0 = a0 * a1
+        addi t0, zero, 0 # t0 = result
+    mhu_loop:
+        beq  a1, zero, mhu_epilogue
+        andi t2, a1, 1 # the least significant bit of a1
+        beq  t2, zero, mhu_next
+        add  t0, t0, a0
+    mhu_next:
+        slli a0, a0, 1
+        srli a1, a1, 1
+        j mhu_loop
+    mhu_epilogue:
+        mv   a0, t0
+        lw   ra, 0(sp)
+        addi sp, sp, 4
+        ret
+
+
+# ┌-------------------------------------------------------┐
+# |           Required Library - mul_bf16 v0.1.0          |
+# └-------------------------------------------------------┘
+
+# --- mul_bf16 ---
+    # multiplication of two bf16 numbers
+    # input:
+    #   a0: a (bf16): multiplier
+    #   a1: b (bf16): multiplicand
+    # output:
+    #   a0: m, r (bf16): product of a and b (a * b)
+    # notes:
+    #   s0: s
+    #   s1: e
+    #   t0: sa
+    #   t1: sb
+    #   t2: ea
+    #   t3: eb
+    #   t4: ma
+    #   t5: mb
+mul_bf16:
+    mb_prologue:
+        addi sp, sp, -12
+        sw   ra, 0(sp)
+        sw   s0, 4(sp)
+        sw   s1, 8(sp)
+    mb_body:
+        beqz a0, mb_epilogue
+        bnez a1, mb_nonzero_input
+        mv   a0, zero
+        j    mb_epilogue
+    mb_nonzero_input:
+        # extract sign, exponent and mantissa of a and b
+        sltz t0, a0 # sa
+        sltz t1, a1 # sb
+        li   t3, 0x7F800000
+        and  t2, a0, t3
+        srli t2, t2, 23
+        addi t2, t2, -127 # ea
+        and  t3, a1, t3
+        srli t3, t3, 23
+        addi t3, t3, -127 # eb
+        li   t5, 0x007F0000
+        and  t4, a0, t5
+        srli t4, t4, 16
+        ori  t4, t4, 0x80 # ma
+        and  t5, a1, t5
+        srli t5, t5, 16
+        ori  t5, t5, 0x80 # mb
+        # calculate the initial result
+        xor  s0, t0, t1 # s = sa ^ sb
+        add  s1, t2, t3 # e = ea + eb
+        mv   a0, t4
+        mv   a1, t5
+        jal  ra, mul_shift_u32
+        srli a0, a0, 7  # m = (ma * mb) >> 7
+        # handle carry bit
+        andi t1, a0, 0x100
+        beqz t1, mb_no_carry
+        srli a0, a0, 1
+        addi s1, s1, 1
+    mb_no_carry:
+        # handle result of +-0
+        bnez a0, mb_nonzero_result
+        slli a0, s0, 31   # r = s << 31
+        j    mb_epilogue
+    mb_nonzero_result:
+        # construct the result
+        slli s0, s0, 31   # s = s << 31
+        addi s1, s1, 127
+        slli s1, s1, 23   # e = (e + 127) << 23
+        andi a0, a0, 0x7F
+        slli a0, a0, 16   # m = (m & 0x7F) << 16
+        or   a0, a0, s0
+        or   a0, a0, s1   # r = s | e | m
+    mb_epilogue:
+        lw   ra, 0(sp)
+        lw   s0, 4(sp)
+        lw   s1, 8(sp)
+        addi sp, sp, 12
+        ret
+
+
+
+# ┌-------------------------------------------------------┐
+# |                        Library                        |
+# └-------------------------------------------------------┘
+
+# --- recip_mantissa_bf16 ---
+    # reciprocal of the mantissa of a bf16 number, 1 / 1.f in (0.5, 1]
+    # input:
+    #   a0: x (bf16): its sign and exponent are ignored
+    # output:
+    #   a0: y (bf16): 1 / 1.f, within 1 ulp
+    # notes:
+    #   s0: m = 1.f
+    #   s1: y, the initial guess from the table
+recip_mantissa_bf16:
+    rmb_prologue:
+        addi sp, sp, -12
+        sw   ra, 0(sp)
+        sw   s0, 4(sp)
+        sw   s1, 8(sp)
+    rmb_body:
+        li   t0, 0x007F0000
+        and  s0, a0, t0
+        li   t0, 0x3F800000
+        or   s0, s0, t0       # m = 1.f
+        # initial guess: y = recip_bf16_table[upper 4 bits of f]
+        srli t0, a0, 19
+        andi t0, t0, 0xF
+        slli t0, t0, 2
+        la   t1, recip_bf16_table
+        add  t0, t0, t1
+        lw   s1, 0(t0)
+        # one Newton step: y = y + y * (1 - m * y)
+        mv   a0, s0
+        mv   a1, s1
+        jal  ra, mul_bf16     # m * y
+        mv   a1, a0
+        li   a0, 0x3F800000
+        jal  ra, sub_bf16     # e = 1 - m * y, which is small
+        mv   a1, a0
+        mv   a0, s1
+        jal  ra, mul_bf16     # y * e
+        mv   a1, a0
+        mv   a0, s1
+        jal  ra, add_bf16
+    rmb_epilogue:
+        lw   ra, 0(sp)
+        lw   s0, 4(sp)
+        lw   s1, 8(sp)
+        addi sp, sp, 12
+        ret
+
+
+# --- recip_bf16 ---
+    # reciprocal of a bf16 number
+    # input:
+    #   a0: x (bf16)
+    # output:
+    #   a0: r (bf16): 1 / x, within 1 ulp for the normal numbers;
+    #       +-inf for +-0, +-0 for +-inf and for |1 / x| < 2^-126,
+    #       and NaN for NaN
+    # notes:
+    #   s0: s, the sign of x
+    #   s1: ex, the biased exponent of x
+recip_bf16:
+    rcb_prologue:
+        addi sp, sp, -12
+        sw   ra, 0(sp)
+        sw   s0, 4(sp)
+        sw   s1, 8(sp)
+    rcb_body:
+        # remove extra bits and catch the special cases
+        li   t0, 0xFFFF0000
+        and  a0, a0, t0
+        li   t0, 0x80000000
+        and  s0, a0, t0       # s
+        srli s1, a0, 23
+        andi s1, s1, 0xFF     # ex
+        li   t0, 0xFF
+        bne  s1, t0, rcb_finite
+        li   t0, 0x007F0000
+        and  t0, a0, t0
+        mv   a0, s0           # +-0 for +-inf
+        beqz t0, rcb_epilogue
+        li   a0, 0x7FC00000   # NaN
+        j    rcb_epilogue
+    rcb_finite:
+        bnez s1, rcb_nonzero
+        li   t0, 0x7F800000
+        or   a0, s0, t0       # +-inf for +-0
+        j    rcb_epilogue
+    rcb_nonzero:
+        jal  ra, recip_mantissa_bf16
+        # 1 / (1.f * 2^(ex - 127)) = (1 / 1.f) * 2^(127 - ex)
+        srli t0, a0, 23
+        andi t0, t0, 0xFF
+        addi t0, t0, 127
+        sub  t0, t0, s1       # e = ey + 127 - ex, which is < 0xFF
+        bgtz t0, rcb_pack
+        mv   a0, s0           # underflow
+        j    rcb_epilogue
+    rcb_pack:
+        slli t0, t0, 23
+        li   t1, 0x007F0000
+        and  a0, a0, t1
+        or   a0, a0, t0
+        or   a0, a0, s0       # r = s | e | m
+    rcb_epilogue:
+        lw   ra, 0(sp)
+        lw   s0, 4(sp)
+        lw   s1, 8(sp)
+        addi sp, sp, 12
+        ret
+
+
+# --- div_bf16 ---
+    # division of two bf16 numbers
+    # input:
+    #   a0: a (bf16): dividend
+    #   a1: b (bf16): divisor
+    # output:
+    #   a0: r (bf16): a / b, within 1.5 ulp for the normal numbers;
+    #       NaN for 0 / 0, inf / inf and NaN operands, +-inf for x / 0,
+    #       inf / x and overflow, and +-0 for 0 / x, x / inf and underflow
+    # notes:
+    #   s0: s, the sign of the result
+    #   s1: ea - eb
+    #   s2: ma = 1.fa
+    #   s3: mb = 1.fb
+    #   s4: y = 1 / mb
+    #   s5: q = ma / mb
+div_bf16:
+    db_prologue:
+        addi sp, sp, -28
+        sw   ra, 0(sp)
+        sw   s0, 4(sp)
+        sw   s1, 8(sp)
+        sw   s2, 12(sp)
+        sw   s3, 16(sp)
+        sw   s4, 20(sp)
+        sw   s5, 24(sp)
+    db_body:
+        # remove extra bits and extract sign, exponents and mantissas
+        li   t0, 0xFFFF0000
+        and  a0, a0, t0
+        and  a1, a1, t0
+        xor  s0, a0, a1
+        li   t0, 0x80000000
+        and  s0, s0, t0       # s
+        srli t1, a0, 23
+        andi t1, t1, 0xFF     # ea
+        srli t2, a1, 23
+        andi t2, t2, 0xFF     # eb
+        li   t0, 0x007F0000
+        and  t3, a0, t0       # fa
+        and  t4, a1, t0       # fb
+        # handle NaN, +-inf and +-0
+        li   t0, 0xFF
+        bne  t1, t0, db_a_not_nan
+        bnez t3, db_nan       # NaN / x
+    db_a_not_nan:
+        bne  t2, t0, db_b_not_nan
+        bnez t4, db_nan       # x / NaN
+    db_b_not_nan:
+        bne  t1, t0, db_a_finite
+        beq  t2, t0, db_nan   # inf / inf
+        j    db_inf           # inf / x
+    db_a_finite:
+        beq  t2, t0, db_zero  # x / inf
+        bnez t2, db_b_nonzero
+        beqz t1, db_nan       # 0 / 0
+        j    db_inf           # x / 0
+    db_b_nonzero:
+        beqz t1, db_zero      # 0 / x
+        # q = 1.fa / 1.fb in (0.5, 2), and then add the exponents back
+        sub  s1, t1, t2       # ea - eb
+        li   t0, 0x3F800000
+        or   s2, t3, t0       # ma
+        or   s3, t4, t0       # mb
+        mv   a0, s3
+        jal  ra, recip_mantissa_bf16
+        mv   s4, a0           # y
+        mv   a0, s2
+        mv   a1, s4
+        jal  ra, mul_bf16
+        mv   s5, a0           # q = ma * y
+        # the second Newton step, on q: q = q + y * (ma - mb * q)
+        mv   a0, s3
+        mv   a1, s5
+        jal  ra, mul_bf16     # mb * q
+        mv   a1, a0
+        mv   a0, s2
+        jal  ra, sub_bf16     # r = ma - mb * q, which is small
+        mv   a1, s4
+        jal  ra, mul_bf16     # r * y
+        mv   a1, a0
+        mv   a0, s5
+        jal  ra, add_bf16     # q
+        # e = eq + ea - eb
+        srli t0, a0, 23
+        andi t0, t0, 0xFF
+        add  t0, t0, s1
+        li   t1, 0xFF
+        bge  t0, t1, db_inf   # overflow
+        blez t0, db_zero      # underflow
+        slli t0, t0, 23
+        li   t1, 0x007F0000
+        and  a0, a0, t1
+        or   a0, a0, t0
+        or   a0, a0, s0       # r = s | e | m
+        j    db_epilogue
+    db_nan:
+        li   a0, 0x7FC00000
+        j    db_epilogue
+    db_inf:
+        li   t0, 0x7F800000
+        or   a0, s0, t0
+        j    db_epilogue
+    db_zero:
+        mv   a0, s0
+    db_epilogue:
+        lw   ra, 0(sp)
+        lw   s0, 4(sp)
+        lw   s1, 8(sp)
+        lw   s2, 12(sp)
+        lw   s3, 16(sp)
+        lw   s4, 20(sp)
+        lw   s5, 24(sp)
+        addi sp, sp, 28
+        ret
+
+
+# ┌-------------------------------------------------------┐
+# |                      Library Data                     |
+# └-------------------------------------------------------┘
+
+.data
+
+.align 2
+# the initial guesses of 1 / 1.f, indexed by the upper 4 bits of f
+# (from the C program)
+recip_bf16_table:
+    .word 0x3F730000, 0x3F650000, 0x3F530000, 0x3F4B0000
+    .word 0x3F420000, 0x3F380000, 0x3F410000, 0x3F2D0000
+    .word 0x3F220000, 0x3F1C0000, 0x3F170000, 0x3F120000
+    .word 0x3F1D0000, 0x3F060000, 0x3F120000, 0x3F000000
+
+
+# ┌-------------------------------------------------------┐
+# |                   Testing Suite Data                  |
+# └-------------------------------------------------------┘
+
+db_str_recip_bf16:
+    .string "recip_bf16: "
+db_str_div_bf16:
+    .string "div_bf16: "
+db_str_cycles:
+    .string " cycles for 128 elements\n"
@@ -9,8 +9,8 @@
 #   mul_shift_u32 -> mul_bf16 ----> **ln_bf16**
 #                    i32_bf16     ↗
 #
-# Version: 0.2.0
-# Tested: 2023-10-00T12:37:00+08:00
+# Version: 0.3.0
+# Tested: 2026-10-18T18:40:00+08:00
 
 .text
 
@@ -18,6 +18,9 @@
 # |                     Testing Suite                     |
 # └-------------------------------------------------------┘
 
+.equ LB_N, 256     # number of elements of tests 8 and 9
+.equ LB_LOG2_N, 8
+
 .globl main
 main:
     # test all functionalities
@@ -29,7 +32,11 @@ main:
     li a0, '\n'
     jal ra, print_char
 
+    # print the number of cycles per element of ln_bf16 and ln_bf16_array
+    jal ra, ln_bf16_array_bench
+
     # exit program
+    li a0, 0
     j exit
 
 
@@ -89,6 +96,42 @@ ln_bf16_test:
         li   t0, 0x3F330000 # -0.006
         li   t1, 7 # error code
         bne  t0, a0, lbt_epilogue
+    lbt_t8:
+        # ln_bf16_array gives the same results as ln_bf16, for an odd n
+        jal  ra, lb_fill_x
+        la   a0, lb_buf_x
+        la   a1, lb_buf_y
+        li   a2, LB_N - 1
+        jal  ra, ln_bf16_array
+        la   a0, lb_buf_y
+        li   a1, LB_N - 1
+        jal  ra, lb_check_y
+        li   t1, 8 # error code
+        bnez a0, lbt_epilogue
+    lbt_t9:
+        # in place, for an even n
+        la   a0, lb_buf_x
+        la   a1, lb_buf_x
+        li   a2, LB_N
+        jal  ra, ln_bf16_array
+        la   a0, lb_buf_x
+        li   a1, LB_N
+        jal  ra, lb_check_y
+        li   t1, 9 # error code
+        bnez a0, lbt_epilogue
+    lbt_t10:
+        # n = 0 writes nothing
+        la   a1, lb_buf_y
+        li   t0, 0x12345678
+        sw   t0, 0(a1)
+        la   a0, lb_buf_x
+        li   a2, 0
+        jal  ra, ln_bf16_array
+        la   a1, lb_buf_y
+        lw   t0, 0(a1)
+        li   t2, 0x12345678
+        li   t1, 10 # error code
+        bne  t0, t2, lbt_epilogue
     lbt_all_passed:
         li   t1, 0
     lbt_epilogue:
@@ -99,8 +142,188 @@ ln_bf16_test:
 
 
 
+# --- lb_x ---
+    # the i-th input of tests 8 and 9: 0.5 + i / 128 (i.e., all the
+    # bf16 numbers in [0.5, 2.5)), except for 0, -1 and a subnormal
+    # number at i = 0, 1 and 2
+    # input:
+    #   a0: i (u32)
+    # output:
+    #   a0: x (bf16)
+lb_x:
+    lbx_body:
+        beqz a0, lbx_epilogue # 0
+        li   t0, 1
+        bne  a0, t0, lbx_not_1
+        li   a0, 0xBF800000   # -1
+        ret
+    lbx_not_1:
+        li   t0, 2
+        bne  a0, t0, lbx_not_2
+        li   a0, 0x00010000   # subnormal
+        ret
+    lbx_not_2:
+        slli a0, a0, 16
+        li   t0, 0x3F000000
+        add  a0, a0, t0
+    lbx_epilogue:
+        ret
+
+
+# --- lb_fill_x ---
+    # fill lb_buf_x with the LB_N inputs of lb_x
+    # input: nothing
+    # output: nothing
+    # notes:
+    #   s0: i
+lb_fill_x:
+    lbfx_prologue:
+        addi sp, sp, -8
+        sw   ra, 0(sp)
+        sw   s0, 4(sp)
+    lbfx_body:
+        li   s0, 0
+    lbfx_loop:
+        mv   a0, s0
+        jal  ra, lb_x
+        la   t0, lb_buf_x
+        slli t1, s0, 2
+        add  t0, t0, t1
+        sw   a0, 0(t0)
+        addi s0, s0, 1
+        li   t0, LB_N
+        bne  s0, t0, lbfx_loop
+    lbfx_epilogue:
+        lw   ra, 0(sp)
+        lw   s0, 4(sp)
+        addi sp, sp, 8
+        ret
+
+
+# --- lb_check_y ---
+    # check y[i] == ln_bf16(lb_x(i)) for i = 0, 1, ..., n - 1
+    # input:
+    #   a0: y: pointer to n bf16 numbers
+    #   a1: n (u32)
+    # output:
+    #   a0: 0 if all are identical; otherwise, 1
+    # notes:
+    #   s0: y
+    #   s1: n
+    #   s2: i
+lb_check_y:
+    lbcy_prologue:
+        addi sp, sp, -16
+        sw   ra, 0(sp)
+        sw   s0, 4(sp)
+        sw   s1, 8(sp)
+        sw   s2, 12(sp)
+    lbcy_body:
+        mv   s0, a0
+        mv   s1, a1
+        li   s2, 0
+    lbcy_loop:
+        mv   a0, s2
+        jal  ra, lb_x
+        jal  ra, ln_bf16
+        slli t0, s2, 2
+        add  t0, s0, t0
+        lw   t0, 0(t0)
+        bne  t0, a0, lbcy_different
+        addi s2, s2, 1
+        bne  s2, s1, lbcy_loop
+        li   a0, 0
+        j    lbcy_epilogue
+    lbcy_different:
+        li   a0, 1
+    lbcy_epilogue:
+        lw   ra, 0(sp)
+        lw   s0, 4(sp)
+        lw   s1, 8(sp)
+        lw   s2, 12(sp)
+        addi sp, sp, 16
+        ret
+
+
+# --- ln_bf16_array_bench ---
+    # print the number of cycles per element of calling ln_bf16 in a
+    # loop and of ln_bf16_array, for the LB_N inputs of lb_x
+    # input: nothing
+    # output: nothing
+    # notes:
+    #   s0: i
+    #   s1: cycle counter at the beginning
+ln_bf16_array_bench:
+    lbab_prologue:
+        addi sp, sp, -12
+        sw   ra, 0(sp)
+        sw   s0, 4(sp)
+        sw   s1, 8(sp)
+    lbab_body:
+        jal  ra, lb_fill_x
+        # y[i] = ln_bf16(x[i])
+        li   s0, 0
+        rdcycle s1
+    lbab_loop:
+        la   t0, lb_buf_x
+        add  t0, t0, s0
+        lw   a0, 0(t0)
+        jal  ra, ln_bf16
+        la   t0, lb_buf_y
+        add  t0, t0, s0
+        sw   a0, 0(t0)
+        addi s0, s0, 4
+        li   t0, 4 * LB_N
+        bne  s0, t0, lbab_loop
+        rdcycle a0
+        sub  a0, a0, s1
+        la   a1, lb_str_ln_bf16
+        jal  ra, lb_print_cycles
+        # ln_bf16_array(x, y, LB_N)
+        rdcycle s1
+        la   a0, lb_buf_x
+        la   a1, lb_buf_y
+        li   a2, LB_N
+        jal  ra, ln_bf16_array
+        rdcycle a0
+        sub  a0, a0, s1
+        la   a1, lb_str_ln_bf16_array
+        jal  ra, lb_print_cycles
+    lbab_epilogue:
+        lw   ra, 0(sp)
+        lw   s0, 4(sp)
+        lw   s1, 8(sp)
+        addi sp, sp, 12
+        ret
+
+
+# --- lb_print_cycles ---
+    # print "<name>: <cycles / LB_N> cycles per element"
+    # input:
+    #   a0: cycles
+    #   a1: name (null-terminated string)
+    # output: nothing
+lb_print_cycles:
+    lbpc_prologue:
+        addi sp, sp, -8
+        sw   ra, 0(sp)
+        sw   a0, 4(sp)
+    lbpc_body:
+        mv   a0, a1
+        jal  ra, print_string
+        lw   a0, 4(sp)
+        srli a0, a0, LB_LOG2_N
+        jal  ra, print_int
+        la   a0, lb_str_cycles
+        jal  ra, print_string
+    lbpc_epilogue:
+        lw   ra, 0(sp)
+        addi sp, sp, 8
+        ret
+
+
 # ┌-------------------------------------------------------┐
-# |         Required Library - add_sub_bf16 v0.1.0        |
+# |         Required Library - add_sub_bf16 v0.1.1        |
 # └-------------------------------------------------------┘
 
 # --- add_sub_bf16 ---
@@ -146,12 +369,20 @@ add_sub_bf16:
         blt  t2, t3, asb_normalization_1
         mv   t6, t2      # t6 = ea
         sub  t2, t2, t3 # t2 = ea - eb
+        li   t0, 8
+        bge  t0, t2, asb_clamp_b
+        li   t2, 8       # mb >> 8 is already 0; srl only uses 5 bits
+    asb_clamp_b:
         srl  t5, t5, t2 # mb >>= t2
         mv   t2, t6      # e = t6
         j    asb_normalization_end
     asb_normalization_1:
         mv   t6, t3      # t6 = eb
         sub  t2, t3, t2 # t2 = ea - eb
+        li   t0, 8
+        bge  t0, t2, asb_clamp_a
+        li   t2, 8       # ma >> 8 is already 0; srl only uses 5 bits
+    asb_clamp_a:
         srl  t4, t4, t2 # ma >>= t2
         mv   t2, t6      # e = t6
     asb_normalization_end:
@@ -497,3 +728,192 @@ ln_bf16:
         lw   s1, 8(sp)
         addi sp, sp, 12
         ret
+
+
+# --- ln_bf16_array ---
+    # y[i] = ln(abs(x[i])) for i = 0, 1, ..., n - 1; gives the same
+    # results as calling ln_bf16 on each element, but the pointers and
+    # ln2 * exp are kept in the saved registers for the whole array,
+    # ln2 * exp is reused while the exponent does not change, and two
+    # elements are processed at a time, with their independent steps
+    # interleaved
+    # input:
+    #   a0: x: pointer to n bf16 numbers
+    #   a1: y: pointer to n bf16 numbers, the output; y may be x
+    #   a2: n (u32)
+    # output: nothing
+    # notes:
+    #   s0: pointer to x[i]
+    #   s1: pointer to y[i]
+    #   s2: pointer to x[n]
+    #   s3, s4: x[i], x[i + 1] with exponents set to 0
+    #   s5, s6: t of x[i], x[i + 1]
+    #   s8, s9: ln2 * exp of x[i], x[i + 1]
+    #   s10: the last exponent field
+    #   s11: ln2 * exp of s10
+    #   the low 12 bits of the constants are 0, so `li` is one `lui`,
+    #   as cheap as `mv` from a saved register
+    # reference: ln_bf16
+ln_bf16_array:
+    lba_prologue:
+        addi sp, sp, -48
+        sw   ra, 0(sp)
+        sw   s0, 4(sp)
+        sw   s1, 8(sp)
+        sw   s2, 12(sp)
+        sw   s3, 16(sp)
+        sw   s4, 20(sp)
+        sw   s5, 24(sp)
+        sw   s6, 28(sp)
+        sw   s8, 32(sp)
+        sw   s9, 36(sp)
+        sw   s10, 40(sp)
+        sw   s11, 44(sp)
+    lba_body:
+        mv   s0, a0
+        mv   s1, a1
+        slli a2, a2, 2
+        add  s2, a0, a2
+        li   s10, -1        # no exponent field is -1
+    lba_loop:
+        # stop if fewer than 2 elements are left
+        addi t0, s0, 4
+        bgeu t0, s2, lba_tail
+        # ln2 * exp, reused while the exponent does not change
+        lw   a0, 0(s0)
+        srli a0, a0, 23
+        andi a0, a0, 0xFF
+        beq  a0, s10, lba_same_exp_0
+        mv   s10, a0
+        addi a0, a0, -127
+        jal  ra, i32_to_bf16
+        li   a1, 0x3F310000 # ln2  = 0.69
+        jal  ra, mul_bf16
+        mv   s11, a0
+    lba_same_exp_0:
+        mv   s8, s11
+        lw   a0, 4(s0)
+        srli a0, a0, 23
+        andi a0, a0, 0xFF
+        beq  a0, s10, lba_same_exp_1
+        mv   s10, a0
+        addi a0, a0, -127
+        jal  ra, i32_to_bf16
+        li   a1, 0x3F310000 # ln2  = 0.69
+        jal  ra, mul_bf16
+        mv   s11, a0
+    lba_same_exp_1:
+        mv   s9, s11
+        # set x's exponent to 0
+        li   t1, 0x7F0000
+        li   t2, 0x3F800000
+        lw   t0, 0(s0)
+        and  t0, t0, t1
+        or   s3, t0, t2
+        lw   t0, 4(s0)
+        and  t0, t0, t1
+        or   s4, t0, t2
+        # t = ((lnc3 * x + lnc2) * x + lnc1) * x + lnc0
+        mv   a0, s3
+        li   a1, 0x3DE10000 # lnc3 = 0.109
+        jal  ra, mul_bf16
+        li   a1, 0xBF3B0000 # lnc2 = -0.73
+        jal  ra, add_bf16
+        mv   s5, a0
+        mv   a0, s4
+        li   a1, 0x3DE10000 # lnc3 = 0.109
+        jal  ra, mul_bf16
+        li   a1, 0xBF3B0000 # lnc2 = -0.73
+        jal  ra, add_bf16
+        mv   s6, a0
+        mv   a0, s5
+        mv   a1, s3
+        jal  ra, mul_bf16
+        li   a1, 0x40070000 # lnc1 = 2.11
+        jal  ra, add_bf16
+        mv   s5, a0
+        mv   a0, s6
+        mv   a1, s4
+        jal  ra, mul_bf16
+        li   a1, 0x40070000 # lnc1 = 2.11
+        jal  ra, add_bf16
+        mv   s6, a0
+        mv   a0, s5
+        mv   a1, s3
+        jal  ra, mul_bf16
+        li   a1, 0xBFBF0000 # lnc0 = -1.49
+        jal  ra, add_bf16
+        mv   s5, a0
+        mv   a0, s6
+        mv   a1, s4
+        jal  ra, mul_bf16
+        li   a1, 0xBFBF0000 # lnc0 = -1.49
+        jal  ra, add_bf16
+        mv   s6, a0
+        # result = ln2 * exp + t
+        mv   a0, s8
+        mv   a1, s5
+        jal  ra, add_bf16
+        mv   s5, a0
+        mv   a0, s9
+        mv   a1, s6
+        jal  ra, add_bf16
+        mv   s6, a0
+        # catch zeros (x is read again, before y is written)
+        li   t1, 0xFFFF0000
+        lw   t0, 0(s0)
+        and  t0, t0, t1
+        bnez t0, lba_nonzero_0
+        li   s5, 0xFF800000
+    lba_nonzero_0:
+        lw   t0, 4(s0)
+        and  t0, t0, t1
+        bnez t0, lba_nonzero_1
+        li   s6, 0xFF800000
+    lba_nonzero_1:
+        sw   s5, 0(s1)
+        sw   s6, 4(s1)
+        addi s0, s0, 8
+        addi s1, s1, 8
+        j    lba_loop
+    lba_tail:
+        # the last element, if n is odd
+        beq  s0, s2, lba_epilogue
+        lw   a0, 0(s0)
+        jal  ra, ln_bf16
+        sw   a0, 0(s1)
+    lba_epilogue:
+        lw   ra, 0(sp)
+        lw   s0, 4(sp)
+        lw   s1, 8(sp)
+        lw   s2, 12(sp)
+        lw   s3, 16(sp)
+        lw   s4, 20(sp)
+        lw   s5, 24(sp)
+        lw   s6, 28(sp)
+        lw   s8, 32(sp)
+        lw   s9, 36(sp)
+        lw   s10, 40(sp)
+        lw   s11, 44(sp)
+        addi sp, sp, 48
+        ret
+
+
+# ┌-------------------------------------------------------┐
+# |                   Testing Suite Data                  |
+# └-------------------------------------------------------┘
+
+.data
+
+lb_str_ln_bf16:
+    .string "ln_bf16 (in a loop): "
+lb_str_ln_bf16_array:
+    .string "ln_bf16_array: "
+lb_str_cycles:
+    .string " cycles per element\n"
+
+.align 2
+lb_buf_x:
+    .space 4 * LB_N
+lb_buf_y:
+    .space 4 * LB_N
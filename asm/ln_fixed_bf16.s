@@ -0,0 +1,862 @@
+# This program implements and tests natural logarithm of bf16 numbers
+# in 32-bit fixed point, and compares its number of cycles with the
+# one of ln_bf16 (the 3rd-order polynomial approximation).
+#
+# For including as a library, include only codes in the "Library"
+# section. The "Comparison Library" sections are the ones of ln_bf16.s,
+# which are only used by the testing suite.
+#
+# Library dependency graph:
+#   **ln_fixed_bf16**
+#
+# Version: 0.0.0
+# Tested: 2026-10-18T16:10:00+08:00
+#
+# reference: ../src/ln_fixed_bf16.c
+
+.text
+
+# ┌-------------------------------------------------------┐
+# |                     Testing Suite                     |
+# └-------------------------------------------------------┘
+
+.equ LFB_N, 256 # all the bf16 numbers in [0.5, 2)
+
+.globl main
+main:
+    # test all functionalities
+    jal  ra, ln_fixed_bf16_test
+    # returns a0 = 0 for success, or non-zero for index of failed test
+
+    # print result
+    jal ra, print_int
+    li a0, '\n'
+    jal ra, print_char
+
+    # print the number of cycles of ln_bf16 and ln_fixed_bf16
+    jal ra, ln_fixed_bf16_bench
+
+    # exit program
+    li a0, 0
+    j exit
+
+
+# --- ln_fixed_bf16_test ---
+    # test the functionalities of ln_fixed_bf16
+    # input: nothing
+    # output:
+    #   a0: error_code: 0 for success
+    #                   otherwise, index of the first failed test
+    # notes:
+    #   the answers are generated by the C program, for the
+    #   results of both should be identical
+    #   s0: x
+    #   s1: pointer to the answer of x
+ln_fixed_bf16_test:
+    lfbt_prologue:
+        addi sp, sp, -12
+        sw   ra, 0(sp)
+        sw   s0, 4(sp)
+        sw   s1, 8(sp)
+    lfbt_t1:
+        li   a0, 0x00000000 # 0.0
+        jal  ra, ln_fixed_bf16
+        li   t0, 0xFF800000 # -inf
+        li   t1, 1 # error code
+        bne  t0, a0, lfbt_epilogue
+    lfbt_t2:
+        li   a0, 0x3F800000 # 1.0
+        jal  ra, ln_fixed_bf16
+        li   t0, 0x00000000 # 0.0
+        li   t1, 2 # error code
+        bne  t0, a0, lfbt_epilogue
+    lfbt_t3:
+        li   a0, 0x40000000 # 2.0
+        jal  ra, ln_fixed_bf16
+        li   t0, 0x3F310000 # 0.691
+        li   t1, 3 # error code
+        bne  t0, a0, lfbt_epilogue
+    lfbt_t4:
+        li   a0, 0x3D4D0000 # 0.05
+        jal  ra, ln_fixed_bf16
+        li   t0, 0xC0400000 # -3.0
+        li   t1, 4 # error code
+        bne  t0, a0, lfbt_epilogue
+    lfbt_t5:
+        li   a0, 0x3F810000 # 1.0078
+        jal  ra, ln_fixed_bf16
+        li   t0, 0x3BFF0000 # 0.00778
+        li   t1, 5 # error code
+        bne  t0, a0, lfbt_epilogue
+    lfbt_t6:
+        li   a0, 0xBF7F0000 # -0.9961
+        jal  ra, ln_fixed_bf16
+        li   t0, 0xBB800000 # -0.0039
+        li   t1, 6 # error code
+        bne  t0, a0, lfbt_epilogue
+    lfbt_t7:
+        li   a0, 0x7F7F0000 # 3.39e38
+        jal  ra, ln_fixed_bf16
+        li   t0, 0x42B10000 # 88.5
+        li   t1, 7 # error code
+        bne  t0, a0, lfbt_epilogue
+    lfbt_t8:
+        # all the LFB_N numbers in [0.5, 2)
+        li   s0, 0x3F000000
+        la   s1, lfb_y_ans
+    lfbt_t8_loop:
+        mv   a0, s0
+        jal  ra, ln_fixed_bf16
+        lw   t0, 0(s1)
+        li   t1, 8 # error code
+        bne  t0, a0, lfbt_epilogue
+        li   t0, 0x10000
+        add  s0, s0, t0
+        addi s1, s1, 4
+        li   t0, 0x40000000
+        bne  s0, t0, lfbt_t8_loop
+    lfbt_all_passed:
+        li   t1, 0
+    lfbt_epilogue:
+        mv   a0, t1 # error code
+        lw   ra, 0(sp)
+        lw   s0, 4(sp)
+        lw   s1, 8(sp)
+        addi sp, sp, 12
+        ret
+
+
+# --- ln_fixed_bf16_bench ---
+    # print the number of cycles of ln_bf16 and ln_fixed_bf16
+    # for the LFB_N numbers of test 8
+    # input: nothing
+    # output: nothing
+ln_fixed_bf16_bench:
+    lfbb_prologue:
+        addi sp, sp, -4
+        sw   ra, 0(sp)
+    lfbb_body:
+        la   a0, ln_bf16
+        jal  ra, lfb_cycles
+        la   a1, lfb_str_ln_bf16
+        jal  ra, lfb_print_cycles
+        la   a0, ln_fixed_bf16
+        jal  ra, lfb_cycles
+        la   a1, lfb_str_ln_fixed_bf16
+        jal  ra, lfb_print_cycles
+    lfbb_epilogue:
+        lw   ra, 0(sp)
+        addi sp, sp, 4
+        ret
+
+
+# --- lfb_cycles ---
+    # count the cycles of calling a function for the LFB_N numbers
+    # in [0.5, 2)
+    # input:
+    #   a0: function (bf16 -> bf16)
+    # output:
+    #   a0: cycles
+    # notes:
+    #   s0: function
+    #   s1: x
+    #   s2: cycle counter at the beginning
+lfb_cycles:
+    lfc_prologue:
+        addi sp, sp, -16
+        sw   ra, 0(sp)
+        sw   s0, 4(sp)
+        sw   s1, 8(sp)
+        sw   s2, 12(sp)
+    lfc_body:
+        mv   s0, a0
+        li   s1, 0x3F000000
+        rdcycle s2
+    lfc_loop:
+        mv   a0, s1
+        jalr ra, 0(s0)
+        li   t0, 0x10000
+        add  s1, s1, t0
+        li   t0, 0x40000000
+        bne  s1, t0, lfc_loop
+        rdcycle a0
+        sub  a0, a0, s2
+    lfc_epilogue:
+        lw   ra, 0(sp)
+        lw   s0, 4(sp)
+        lw   s1, 8(sp)
+        lw   s2, 12(sp)
+        addi sp, sp, 16
+        ret
+
+
+# --- lfb_print_cycles ---
+    # print "<name>: <cycles> cycles for LFB_N elements"
+    # input:
+    #   a0: cycles
+    #   a1: name (null-terminated string)
+    # output: nothing
+lfb_print_cycles:
+    lpc_prologue:
+        addi sp, sp, -8
+        sw   ra, 0(sp)
+        sw   a0, 4(sp)
+    lpc_body:
+        mv   a0, a1
+        jal  ra, print_string
+        lw   a0, 4(sp)
+        jal  ra, print_int
+        la   a0, lfb_str_cycles
+        jal  ra, print_string
+    lpc_epilogue:
+        lw   ra, 0(sp)
+        addi sp, sp, 8
+        ret
+
+
+
+# ┌-------------------------------------------------------┐
+# |        Comparison Library - add_sub_bf16 v0.1.1       |
+# └-------------------------------------------------------┘
+
+# --- add_sub_bf16 ---
+    # addition or subtraction of two bf16 numbers
+    # input:
+    #   a0: a (bf16): add/sub candidate
+    #   a1: b (bf16): add/sub candidate
+    #   a2: to_add (int): 1 for addition; 0 for subtraction
+    # output:
+    #   a0: r (bf16): result of (a + b) or (a - b)
+    # notes:
+    #   t0: sa, s
+    #   t1: sb
+    #   t2: ea, e
+    #   t3: eb
+    #   t4: ma, m
+    #   t5: mb
+    #   t6: (always temp)
+add_sub_bf16:
+    asb_prologue:
+        addi sp, sp, -4
+        sw   ra, 0(sp)
+    asb_body:
+        # extract expoent and mantissa from a and b
+        li   t6, 0x7F800000
+        and  t2, a0, t6 # ea
+        srli t2, t2, 23
+        addi t2, t2, -127
+        li   t6, 0x7F800000
+        and  t3, a1, t6 # eb
+        srli t3, t3, 23
+        addi t3, t3, -127
+        li   t6, 0x007F0000
+        and  t4, a0, t6 # ma
+        srli t4, t4, 16
+        ori  t4, t4, 0x80
+        li   t6, 0x007F0000
+        and  t5, a1, t6 # mb
+        srli t5, t5, 16
+        ori  t5, t5, 0x80
+
+        # normalization: make 2 numbers have the same exponent
+        blt  t2, t3, asb_normalization_1
+        mv   t6, t2      # t6 = ea
+        sub  t2, t2, t3 # t2 = ea - eb
+        li   t0, 8
+        bge  t0, t2, asb_clamp_b
+        li   t2, 8       # mb >> 8 is already 0; srl only uses 5 bits
+    asb_clamp_b:
+        srl  t5, t5, t2 # mb >>= t2
+        mv   t2, t6      # e = t6
+        j    asb_normalization_end
+    asb_normalization_1:
+        mv   t6, t3      # t6 = eb
+        sub  t2, t3, t2 # t2 = ea - eb
+        li   t0, 8
+        bge  t0, t2, asb_clamp_a
+        li   t2, 8       # ma >> 8 is already 0; srl only uses 5 bits
+    asb_clamp_a:
+        srl  t4, t4, t2 # ma >>= t2
+        mv   t2, t6      # e = t6
+    asb_normalization_end:
+        # addition or subtraction
+        li   t6, 0x80000000
+        and  t0, a0, t6 # sa
+        beqz t0, asb_not_invert_ma
+        sub  t4, zero, t4
+    asb_not_invert_ma:
+        li   t6, 0x80000000
+        and  t1, a1, t6 # sb
+        beqz t1, asb_not_invert_mb_1
+        sub  t5, zero, t5
+    asb_not_invert_mb_1:
+        bnez a2, asb_not_invert_mb_2
+        sub  t5, zero, t5
+    asb_not_invert_mb_2:
+        add  t4, t4, t5 # m = ma + mb
+        # handle negative result
+        li   t0, 0
+        bgez t4, asb_positive_m
+        sub  t4, zero, t4
+        li   t0, 1
+    asb_positive_m:
+        # handle carry bit
+        andi t5, t4, 0x100
+        beqz t5, asb_no_carry
+        srli t4, t4, 1
+        addi t2, t2, 1
+    asb_no_carry:
+        # handle result of 0
+        li   t5, 0x80
+        bnez t4, asb_small
+        li   t2, -127     # e = -127
+        j    asb_small_end
+    asb_small:
+        bge  t4, t5, asb_small_end # while (m < 0x80)
+        addi t2, t2, -1 # e -= 1
+        slli t4, t4, 1  # m <<= 1
+        j    asb_small
+    asb_small_end:
+        # construct the result
+        slli t0, t0, 31   # s = s << 31
+        addi t2, t2, 127  # e = (e + 127) << 23
+        slli t2, t2, 23
+        andi t4, t4, 0x7F # m = (m & 0x7F) << 16
+        slli t4, t4, 16
+        or   a0, t0, t2   # r = s | e | m
+        or   a0, a0, t4
+    asb_epilogue:
+        lw   ra, 0(sp)
+        addi sp, sp, 4
+        ret
+
+
+# --- add_bf16 ---
+    # addition of two bf16 numbers.
+    # input:
+    #   a0: a (bf16): addition candidate
+    #   a1: b (bf16): addition candidate
+    # output:
+    #   a0: r (bf16): reslut of (a + b)
+add_bf16:
+        addi sp, sp, -4
+        sw   ra, 0(sp)
+        li   a2, 1
+        jal  ra, add_sub_bf16
+        lw   ra, 0(sp)
+        addi sp, sp, 4
+        ret
+
+
+# --- sub_bf16 ---
+    # subtraction of two bf16 numbers.
+    # input:
+    #   a0: a (bf16): subtraction candidate
+    #   a1: b (bf16): subtraction candidate
+    # output:
+    #   a0: r (bf16): reslut of (a - b)
+sub_bf16:
+        addi sp, sp, -4
+        sw   ra, 0(sp)
+        li   a2, 0
+        jal  ra, add_sub_bf16
+        lw   ra, 0(sp)
+        addi sp, sp, 4
+        ret
+
+
+# ┌-------------------------------------------------------┐
+# |       Comparison Library - mul_shift_u32 v0.0.0       |
+# └-------------------------------------------------------┘
+
+# --- mul_shift_u32 ---
+    # binary multiplication of two u32 numbers
+    # input:
+    #   a0: a (u32): multiplier
+    #   a1: b (u32): multiplicand
+    # output:
+    #   a0: r (u32): product of a and b (a * b)
+mul_shift_u32:
+    mhu_prologue:
+        addi sp, sp, -4
+        sw   ra, 0(sp)
+        bge  a0, a1, mhu_no_swap
+        # make a1 <= a0
+        addi t0, a1, 0
+        mv   a1, a0
+        mv   a0, t0
+    mhu_no_swap:
+        # binary multiplication of t0 = a0 * a1
+        addi t0, zero, 0 # t0 = result
+    mhu_loop:
+        beq  a1, zero, mhu_epilogue
+        andi t2, a1, 1 # the least significant bit of a1
+        beq  t2, zero, mhu_next
+        add  t0, t0, a0
+    mhu_next:
+        slli a0, a0, 1
+        srli a1, a1, 1
+        j mhu_loop
+    mhu_epilogue:
+        mv   a0, t0
+        lw   ra, 0(sp)
+        addi sp, sp, 4
+        ret
+
+
+# ┌-------------------------------------------------------┐
+# |          Comparison Library - mul_bf16 v0.1.0         |
+# └-------------------------------------------------------┘
+
+# --- mul_bf16 ---
+    # multiplication of two bf16 numbers
+    # input:
+    #   a0: a (bf16): multiplier
+    #   a1: b (bf16): multiplicand
+    # output:
+    #   a0: m, r (bf16): product of a and b (a * b)
+    # notes:
+    #   s0: s
+    #   s1: e
+    #   t0: sa
+    #   t1: sb
+    #   t2: ea
+    #   t3: eb
+    #   t4: ma
+    #   t5: mb
+mul_bf16:
+    mb_prologue:
+        addi sp, sp, -12
+        sw   ra, 0(sp)
+        sw   s0, 4(sp)
+        sw   s1, 8(sp)
+    mb_body:
+        beqz a0, mb_epilogue
+        bnez a1, mb_nonzero_input
+        mv   a0, zero
+        j    mb_epilogue
+    mb_nonzero_input:
+        # extract sign, exponent and mantissa of a and b
+        sltz t0, a0 # sa
+        sltz t1, a1 # sb
+        li   t3, 0x7F800000
+        and  t2, a0, t3
+        srli t2, t2, 23
+        addi t2, t2, -127 # ea
+        and  t3, a1, t3
+        srli t3, t3, 23
+        addi t3, t3, -127 # eb
+        li   t5, 0x007F0000
+        and  t4, a0, t5
+        srli t4, t4, 16
+        ori  t4, t4, 0x80 # ma
+        and  t5, a1, t5
+        srli t5, t5, 16
+        ori  t5, t5, 0x80 # mb
+        # calculate the initial result
+        xor  s0, t0, t1 # s = sa ^ sb
+        add  s1, t2, t3 # e = ea + eb
+        mv   a0, t4
+        mv   a1, t5
+        jal  ra, mul_shift_u32
+        srli a0, a0, 7  # m = (ma * mb) >> 7
+        # handle carry bit
+        andi t1, a0, 0x100
+        beqz t1, mb_no_carry
+        srli a0, a0, 1
+        addi s1, s1, 1
+    mb_no_carry:
+        # handle result of +-0
+        bnez a0, mb_nonzero_result
+        slli a0, s0, 31   # r = s << 31
+        j    mb_epilogue
+    mb_nonzero_result:
+        # construct the result
+        slli s0, s0, 31   # s = s << 31
+        addi s1, s1, 127
+        slli s1, s1, 23   # e = (e + 127) << 23
+        andi a0, a0, 0x7F
+        slli a0, a0, 16   # m = (m & 0x7F) << 16
+        or   a0, a0, s0
+        or   a0, a0, s1   # r = s | e | m
+    mb_epilogue:
+        lw   ra, 0(sp)
+        lw   s0, 4(sp)
+        lw   s1, 8(sp)
+        addi sp, sp, 12
+        ret
+
+
+# ┌-------------------------------------------------------┐
+# |          Comparison Library - u32_bf16 v0.0.0         |
+# └-------------------------------------------------------┘
+
+# --- bf16_to_i32 ---
+    # (NOT IMPLEMENTED YET!)
+    # convert bf16 to i32
+    # input:
+    #   a0: x (bf16): bf16 number to be processed
+    # output:
+    #   a0: m, r (i32): 32-bit integer (without fraction)
+bf16_to_i32:
+    ret
+
+
+# --- i32_to_bf16 ---
+    # convert i32 to bf16
+    # input:
+    #   a0: x (i32): integer to convert
+    # output:
+    #   a0: m, r (bf16): float with roughly the same
+    #                    value as input
+    # notes:
+    #   t0: s
+    #   t1: e
+i32_to_bf16:
+    itb_prologue:
+        addi sp, sp, -4
+        sw   ra, 0(sp)
+    itb_body:
+        bnez a0, itb_nonzero_x
+        # x == 0
+        j    itb_epilogue
+    itb_nonzero_x:
+        sltz t0, a0 # s = sign bit of x
+        li   t1, 7 # e = 7
+        # `m = x` is `mv a0, a0`, which is nop
+        beqz t0, itb_positive_x
+        sub  a0, zero, a0 # m = -x
+    itb_positive_x:
+        li   t2, 0x80
+    itb_small_x:
+        bge  a0, t2, itb_large_x_outer
+        addi t1, t1, -1
+        slli a0, a0, 1
+        j    itb_small_x
+    itb_large_x_outer:
+        li   t2, 0x100
+    itb_large_x_inner:
+        blt  a0, t2, itb_result
+        addi t1, t1, 1
+        srli a0, a0, 1
+        j    itb_large_x_inner
+    itb_result:
+        andi a0, a0, 0x7F
+        slli a0, a0, 16
+        addi t1, t1, 127
+        slli t1, t1, 23
+        slli t0, t0, 31
+        or   a0, a0, t1
+        or   a0, a0, t0
+    itb_epilogue:
+        lw   ra, 0(sp)
+        addi sp, sp, 4
+        ret
+
+
+
+
+# ┌-------------------------------------------------------┐
+# |          Comparison Library - ln_bf16 v0.2.0          |
+# └-------------------------------------------------------┘
+
+# --- ln_bf16 ---
+    # return ln(abs(x))
+    # input:
+    #   a0: x (bf16): number to transform
+    # output:
+    #   a0: t (bf16): result of ln(abs(x))
+    # notes:
+    #   s0: x, t (around last mul_bf16)
+    #   s1: exp
+    # reference: ln_bf16.c
+ln_bf16:
+    lb_prologue:
+        addi sp, sp, -12
+        sw   ra, 0(sp)
+        sw   s0, 4(sp)
+        sw   s1, 8(sp)
+    lb_body:
+        # remove extra bits (otherwise, offset-by-one bug occurs)
+        li   t0, 0xFFFF0000
+        and  a0, a0, t0
+        # catch zero
+        bnez a0, lb_nonzero_input
+        li   a0, 0xFF800000
+        j    lb_epilogue
+    lb_nonzero_input:
+        mv   s0, a0 # s0 = x, for x will be used later
+        li   t0, 0x7F800000
+        and  a0, s0, t0     # a0 = *px & 0x7F800000
+        srli a0, a0, 23
+        addi a0, a0, -127   # a0 = (a0 >> 23) - 127
+        jal  i32_to_bf16    # a0 = (bf16) a0
+        mv   s1, a0         # exp = a0
+        # set x's exponent to 0
+        li   t1, 0x7F0000
+        li   t2, 0x3F800000
+        and  s0, s0, t1
+        or   s0, s0, t2     # x = 0x3F800000 | (*px & 0x7F0000)
+        # calculate result (t)
+        mv   a0, s0         # a0 = x
+        li   a1, 0x3DE10000 # lnc3 = 0.109
+        jal  mul_bf16       # a0 = lnc3 * x
+        li   a1, 0xBF3B0000 # lnc2 = -0.73
+        jal  add_bf16       # a0 = a0 + lnc2
+        mv   a1, s0         # a1 = x
+        jal  mul_bf16       # a0 = a0 * x
+        li   a1, 0x40070000 # lnc1 = 2.11
+        jal  add_bf16       # a0 = a0 + lnc1
+        mv   a1, s0         # a1 = x
+        jal  mul_bf16       # a0 = a0 * x
+        li   a1, 0xBFBF0000 # lnc0 = -1.49
+        jal  add_bf16       # a0 = a0 + lnc0
+        mv   s0, a0         # s0 = t
+        li   a0, 0x3F310000 # ln2  = 0.69
+        mv   a1, s1         # a1 = exp
+        jal  mul_bf16       # a0 = ln2 * exp
+        mv   a1, s0         # a1 = t
+        jal  add_bf16       # a0 = a0 + t (result)
+    lb_epilogue:
+        lw   ra, 0(sp)
+        lw   s0, 4(sp)
+        lw   s1, 8(sp)
+        addi sp, sp, 12
+        ret
+
+
+# ┌-------------------------------------------------------┐
+# |                        Library                        |
+# └-------------------------------------------------------┘
+
+# --- ln_fixed_bf16 ---
+    # return ln(abs(x)) in 32-bit fixed point
+    # input:
+    #   a0: x (bf16): number to transform
+    # output:
+    #   a0: ln(abs(x)) (bf16), rounded to the nearest (ties away from 0)
+    # notes:
+    #   t0: e, then s (sign of the result)
+    #   t1: z (mantissa of x in Q30), then l (abs(log2(x)) in Q24)
+    #   t2: f (log2 of the mantissa of x in Q24)
+    #   t3: k, then ep (exponent of the result)
+    #   a1: pointer to log2(1 + 2^-k) in the table
+    #   a2: 2.0 in Q30
+    #   a3: 9 (the end of k)
+    # reference: ln_fixed_bf16.c
+ln_fixed_bf16:
+    lfb_zero:
+        # remove sign and extra bits
+        li   t4, 0x7FFF0000
+        and  a0, a0, t4
+        bnez a0, lfb_log2_mantissa
+        li   a0, 0xFF800000 # ln(0) = -inf
+        ret
+    lfb_log2_mantissa:
+        srli t0, a0, 23
+        addi t0, t0, -127   # e
+        li   t4, 0x7F0000
+        and  t1, a0, t4
+        slli t1, t1, 7      # z, without the leading 1
+        li   t2, 0          # f = log2(1.0) = 0 exactly
+        beqz t1, lfb_log2_x
+        li   t4, 0x40000000
+        or   t1, t1, t4     # z = 1.xxx in Q30
+        li   t2, 0x1000000  # f = 1.0 in Q24
+        la   a1, ln_fixed_log2_table
+        li   a2, 0x80000000
+        li   a3, 9
+        li   t3, 1          # k
+    lfb_log2_loop:
+        # take z * (1 + 2^-k) if it is <= 2.0
+        srl  t4, t1, t3
+        add  t4, t4, t1
+        bgtu t4, a2, lfb_log2_next
+        mv   t1, t4
+        lw   t4, 0(a1)
+        sub  t2, t2, t4     # f -= log2(1 + 2^-k)
+    lfb_log2_next:
+        addi a1, a1, 4
+        addi t3, t3, 1
+        bne  t3, a3, lfb_log2_loop
+        # f -= log2(2 / z) ~= d * 1.4375, where d = (2 - z) / 2 in Q24
+        sub  t4, a2, t1
+        srli t4, t4, 7      # d
+        sub  t2, t2, t4
+        srli t5, t4, 1
+        sub  t2, t2, t5
+        srli t5, t4, 4
+        add  t2, t2, t5
+    lfb_log2_x:
+        # l = abs(log2(x)) = abs(e + log2(m)) in Q24, s = sign
+        bltz t0, lfb_negative
+        slli t1, t0, 24
+        add  t1, t1, t2     # l = (e << 24) + f
+        li   t0, 0          # s
+        bnez t1, lfb_normalize
+        li   a0, 0          # ln(1) = 0
+        ret
+    lfb_negative:
+        neg  t1, t0
+        slli t1, t1, 24
+        sub  t1, t1, t2     # l = (-e << 24) - f
+        li   t0, 0x80000000 # s
+    lfb_normalize:
+        # make 0x8000 <= l < 0x10000, where l = l' * 2^k, and ep = k - 9
+        li   t3, -9
+        li   t4, 0x1000000
+        bltu t1, t4, lfb_normalize_4
+        srli t1, t1, 8
+        addi t3, t3, 8
+    lfb_normalize_4:
+        li   t4, 0x100000
+        bltu t1, t4, lfb_normalize_2
+        srli t1, t1, 4
+        addi t3, t3, 4
+    lfb_normalize_2:
+        li   t4, 0x40000
+        bltu t1, t4, lfb_normalize_1
+        srli t1, t1, 2
+        addi t3, t3, 2
+    lfb_normalize_1:
+        li   t4, 0x20000
+        bltu t1, t4, lfb_normalize_0
+        srli t1, t1, 1
+        addi t3, t3, 1
+    lfb_normalize_0:
+        li   t4, 0x10000
+        bltu t1, t4, lfb_multiply
+        srli t1, t1, 1
+        addi t3, t3, 1
+    lfb_multiply:
+        # p = l * ln2, where ln2 = 0xB172 / 2^16
+        #   = l * 0b1011000101110010
+        slli t4, t1, 1
+        slli t5, t1, 4
+        add  t4, t4, t5
+        slli t5, t1, 5
+        add  t4, t4, t5
+        slli t5, t1, 6
+        add  t4, t4, t5
+        slli t5, t1, 8
+        add  t4, t4, t5
+        slli t5, t1, 12
+        add  t4, t4, t5
+        slli t5, t1, 13
+        add  t4, t4, t5
+        slli t5, t1, 15
+        add  t4, t4, t5     # p
+        # make the leading 1 of p the bit 31
+        bltz t4, lfb_round
+        slli t4, t4, 1
+        addi t3, t3, -1
+    lfb_round:
+        # round to 8 significant bits (ties away from zero)
+        srli t4, t4, 23
+        addi t4, t4, 1
+        srli t4, t4, 1      # m
+        li   t5, 0x100
+        bne  t4, t5, lfb_pack
+        li   t4, 0x80
+        addi t3, t3, 1
+    lfb_pack:
+        addi t3, t3, 127
+        slli t3, t3, 23
+        andi t4, t4, 0x7F
+        slli t4, t4, 16
+        or   a0, t0, t3
+        or   a0, a0, t4
+        ret
+
+
+# ┌-------------------------------------------------------┐
+# |                      Library Data                     |
+# └-------------------------------------------------------┘
+
+.data
+
+.align 2
+# log2(1 + 2^-k) in Q24, for k = 1, 2, ..., 8
+ln_fixed_log2_table:
+    .word 0x0095C01A, 0x005269E1, 0x002B8034, 0x001663F7
+    .word 0x000B5D6A, 0x0005B9E6, 0x0002DFCA, 0x0001709C
+
+
+# ┌-------------------------------------------------------┐
+# |                   Testing Suite Data                  |
+# └-------------------------------------------------------┘
+
+lfb_str_ln_bf16:
+    .string "ln_bf16: "
+lfb_str_ln_fixed_bf16:
+    .string "ln_fixed_bf16: "
+lfb_str_cycles:
+    .string " cycles for 256 elements\n"
+
+.align 2
+# ln_fixed_bf16(x) for x = 0.5, 0.5039, ..., 1.9922 (from the C program)
+lfb_y_ans:
+    .word 0xBF310000, 0xBF2F0000, 0xBF2D0000, 0xBF2C0000
+    .word 0xBF2A0000, 0xBF280000, 0xBF260000, 0xBF240000
+    .word 0xBF220000, 0xBF200000, 0xBF1E0000, 0xBF1C0000
+    .word 0xBF1B0000, 0xBF190000, 0xBF170000, 0xBF150000
+    .word 0xBF130000, 0xBF120000, 0xBF100000, 0xBF0E0000
+    .word 0xBF0C0000, 0xBF0B0000, 0xBF090000, 0xBF070000
+    .word 0xBF050000, 0xBF040000, 0xBF020000, 0xBF000000
+    .word 0xBEFE0000, 0xBEFA0000, 0xBEF70000, 0xBEF40000
+    .word 0xBEF10000, 0xBEED0000, 0xBEEA0000, 0xBEE70000
+    .word 0xBEE40000, 0xBEE10000, 0xBEDE0000, 0xBEDB0000
+    .word 0xBED80000, 0xBED50000, 0xBED20000, 0xBECF0000
+    .word 0xBECC0000, 0xBEC90000, 0xBEC60000, 0xBEC30000
+    .word 0xBEC00000, 0xBEBD0000, 0xBEBA0000, 0xBEB70000
+    .word 0xBEB40000, 0xBEB10000, 0xBEAF0000, 0xBEAC0000
+    .word 0xBEA90000, 0xBEA60000, 0xBEA40000, 0xBEA10000
+    .word 0xBE9E0000, 0xBE9B0000, 0xBE990000, 0xBE960000
+    .word 0xBE930000, 0xBE910000, 0xBE8E0000, 0xBE8B0000
+    .word 0xBE890000, 0xBE860000, 0xBE840000, 0xBE810000
+    .word 0xBE7D0000, 0xBE780000, 0xBE730000, 0xBE6E0000
+    .word 0xBE690000, 0xBE630000, 0xBE5F0000, 0xBE5A0000
+    .word 0xBE550000, 0xBE500000, 0xBE4B0000, 0xBE460000
+    .word 0xBE410000, 0xBE3C0000, 0xBE370000, 0xBE330000
+    .word 0xBE2E0000, 0xBE290000, 0xBE250000, 0xBE200000
+    .word 0xBE1B0000, 0xBE170000, 0xBE120000, 0xBE0D0000
+    .word 0xBE090000, 0xBE040000, 0xBDFF0000, 0xBDF60000
+    .word 0xBDED0000, 0xBDE40000, 0xBDDB0000, 0xBDD20000
+    .word 0xBDCA0000, 0xBDC10000, 0xBDB80000, 0xBDAF0000
+    .word 0xBDA70000, 0xBD9E0000, 0xBD950000, 0xBD8D0000
+    .word 0xBD840000, 0xBD770000, 0xBD660000, 0xBD550000
+    .word 0xBD450000, 0xBD340000, 0xBD230000, 0xBD130000
+    .word 0xBD020000, 0xBCE30000, 0xBCC20000, 0xBCA20000
+    .word 0xBC810000, 0xBC410000, 0xBC000000, 0xBB800000
+    .word 0x00000000, 0x3BFF0000, 0x3C7E0000, 0x3CBE0000
+    .word 0x3CFC0000, 0x3D1D0000, 0x3D3C0000, 0x3D5A0000
+    .word 0x3D780000, 0x3D8B0000, 0x3D9A0000, 0x3DA90000
+    .word 0x3DB80000, 0x3DC60000, 0x3DD50000, 0x3DE30000
+    .word 0x3DF10000, 0x3DFF0000, 0x3E070000, 0x3E0E0000
+    .word 0x3E150000, 0x3E1C0000, 0x3E220000, 0x3E290000
+    .word 0x3E300000, 0x3E370000, 0x3E3D0000, 0x3E440000
+    .word 0x3E4B0000, 0x3E510000, 0x3E580000, 0x3E5E0000
+    .word 0x3E640000, 0x3E6B0000, 0x3E710000, 0x3E780000
+    .word 0x3E7E0000, 0x3E820000, 0x3E850000, 0x3E880000
+    .word 0x3E8B0000, 0x3E8E0000, 0x3E910000, 0x3E940000
+    .word 0x3E970000, 0x3E9A0000, 0x3E9D0000, 0x3EA00000
+    .word 0x3EA30000, 0x3EA60000, 0x3EA90000, 0x3EAC0000
+    .word 0x3EAF0000, 0x3EB10000, 0x3EB40000, 0x3EB70000
+    .word 0x3EBA0000, 0x3EBD0000, 0x3EBF0000, 0x3EC20000
+    .word 0x3EC50000, 0x3EC80000, 0x3ECA0000, 0x3ECD0000
+    .word 0x3ED00000, 0x3ED20000, 0x3ED50000, 0x3ED80000
+    .word 0x3EDA0000, 0x3EDD0000, 0x3EDF0000, 0x3EE20000
+    .word 0x3EE40000, 0x3EE70000, 0x3EEA0000, 0x3EEC0000
+    .word 0x3EEF0000, 0x3EF10000, 0x3EF40000, 0x3EF60000
+    .word 0x3EF90000, 0x3EFB0000, 0x3EFD0000, 0x3F000000
+    .word 0x3F010000, 0x3F020000, 0x3F040000, 0x3F050000
+    .word 0x3F060000, 0x3F070000, 0x3F080000, 0x3F090000
+    .word 0x3F0B0000, 0x3F0C0000, 0x3F0D0000, 0x3F0E0000
+    .word 0x3F0F0000, 0x3F100000, 0x3F120000, 0x3F130000
+    .word 0x3F140000, 0x3F150000, 0x3F160000, 0x3F170000
+    .word 0x3F180000, 0x3F190000, 0x3F1A0000, 0x3F1C0000
+    .word 0x3F1D0000, 0x3F1E0000, 0x3F1F0000, 0x3F200000
+    .word 0x3F210000, 0x3F220000, 0x3F230000, 0x3F240000
+    .word 0x3F250000, 0x3F260000, 0x3F270000, 0x3F280000
+    .word 0x3F290000, 0x3F2A0000, 0x3F2B0000, 0x3F2C0000
+    .word 0x3F2D0000, 0x3F2E0000, 0x3F2F0000, 0x3F300000
@@ -0,0 +1,1321 @@
+# This program implements and tests RMS normalization and layer
+# normalization of bf16 arrays, and prints their numbers of cycles.
+#
+# For including as a library, include only codes in…
+# (1) all of the "Required Library" sections, and
+# (2) the "Library" section.
+#
+# Library dependency graph:
+#                    add_sub_bf16 ↘
+#   mul_shift_u32 -> mul_bf16 ----> rsqrt_bf16 -> **norm_bf16**
+#
+# Version: 0.0.0
+# Tested: 2026-10-18T18:20:00+08:00
+#
+# reference: ../src/norm_bf16.c
+
+.text
+
+# ┌-------------------------------------------------------┐
+# |                     Testing Suite                     |
+# └-------------------------------------------------------┘
+
+.equ NRM_N, 64      # number of elements of the random arrays
+.equ NRM_ONES, 300  # number of elements of test 4 (> 256)
+.equ NRM_EPS, 0x37270000 # 0.00000997
+
+.globl main
+main:
+    # test all functionalities
+    jal  ra, norm_bf16_test
+    # returns a0 = 0 for success, or non-zero for index of failed test
+
+    # print result
+    jal ra, print_int
+    li a0, '\n'
+    jal ra, print_char
+
+    # print the number of cycles of rmsnorm_bf16 and layernorm_bf16
+    jal ra, norm_bf16_bench
+
+    # exit program
+    li a0, 0
+    j exit
+
+
+# --- norm_bf16_test ---
+    # test the functionalities of norm_bf16
+    # input: nothing
+    # output:
+    #   a0: error_code: 0 for success
+    #                   otherwise, index of the first failed test
+    # notes:
+    #   the answers of test 6 are generated by the C program, for the
+    #   results of both should be identical
+    #   s0: i
+    #   s1: acc.m
+    #   s2: acc.e
+norm_bf16_test:
+    nrmt_prologue:
+        addi sp, sp, -16
+        sw   ra, 0(sp)
+        sw   s0, 4(sp)
+        sw   s1, 8(sp)
+        sw   s2, 12(sp)
+    nrmt_t1:
+        li   a0, 1
+        jal  ra, norm_inv_n
+        li   t0, 0x3F800000 # 1.0
+        li   t1, 1 # error code
+        bne  t0, a0, nrmt_epilogue
+        li   a0, 3
+        jal  ra, norm_inv_n
+        li   t0, 0x3EAB0000 # 0.3340
+        li   t1, 1 # error code
+        bne  t0, a0, nrmt_epilogue
+        li   a0, 4
+        jal  ra, norm_inv_n
+        li   t0, 0x3E800000 # 0.25
+        li   t1, 1 # error code
+        bne  t0, a0, nrmt_epilogue
+        li   a0, 1000
+        jal  ra, norm_inv_n
+        li   t0, 0x3A830000 # 0.001
+        li   t1, 1 # error code
+        bne  t0, a0, nrmt_epilogue
+    nrmt_t2:
+        # 1 + 2^-8 + ... + 2^-8 (256 times) = 2
+        li   a0, 0
+        li   a1, 0
+        li   a2, 0x3F800000 # 1.0
+        jal  ra, norm_acc_add_bf16
+        mv   s1, a0
+        mv   s2, a1
+        li   s0, 256
+    nrmt_t2_loop:
+        mv   a0, s1
+        mv   a1, s2
+        li   a2, 0x3B800000 # 2^-8
+        jal  ra, norm_acc_add_bf16
+        mv   s1, a0
+        mv   s2, a1
+        addi s0, s0, -1
+        bnez s0, nrmt_t2_loop
+        mv   a0, s1
+        mv   a1, s2
+        jal  ra, norm_acc_to_bf16
+        li   t0, 0x40000000 # 2.0
+        li   t1, 2 # error code
+        bne  t0, a0, nrmt_epilogue
+    nrmt_t3:
+        # rmsnorm({3, 4}) = {0.8477, 1.1328}
+        la   t0, nrm_buf_x
+        li   t1, 0x40400000 # 3.0
+        sw   t1, 0(t0)
+        li   t1, 0x40800000 # 4.0
+        sw   t1, 4(t0)
+        la   t0, nrm_buf_w
+        li   t1, 0x3F800000 # 1.0
+        sw   t1, 0(t0)
+        sw   t1, 4(t0)
+        la   a0, nrm_buf_x
+        la   a1, nrm_buf_w
+        la   a2, nrm_buf_y
+        li   a3, 2
+        li   a4, 0
+        jal  ra, rmsnorm_bf16
+        la   t2, nrm_buf_y
+        li   t1, 3 # error code
+        lw   t0, 0(t2)
+        li   t3, 0x3F590000 # 0.8477
+        bne  t0, t3, nrmt_epilogue
+        lw   t0, 4(t2)
+        li   t3, 0x3F910000 # 1.1328
+        bne  t0, t3, nrmt_epilogue
+    nrmt_t4:
+        # rmsnorm({-1, 1, ..., 1}) = {-1, 1, ..., 1}, where a bf16 sum of
+        # the squares would stop at 256
+        la   t0, nrm_buf_x
+        la   t1, nrm_buf_w
+        li   t2, 0x3F800000 # 1.0
+        li   t3, NRM_ONES
+    nrmt_t4_fill:
+        sw   t2, 0(t0)
+        sw   t2, 0(t1)
+        addi t0, t0, 4
+        addi t1, t1, 4
+        addi t3, t3, -1
+        bnez t3, nrmt_t4_fill
+        la   t0, nrm_buf_x
+        li   t2, 0xBF800000 # -1.0
+        sw   t2, 0(t0)
+        la   a0, nrm_buf_x
+        la   a1, nrm_buf_w
+        la   a2, nrm_buf_y
+        li   a3, NRM_ONES
+        li   a4, 0
+        jal  ra, rmsnorm_bf16
+        la   a0, nrm_buf_y
+        la   a1, nrm_buf_x
+        li   a2, NRM_ONES
+        jal  ra, nrm_compare
+        li   t1, 4 # error code
+        bnez a0, nrmt_epilogue
+    nrmt_t5:
+        # layernorm({1, 2, 3, 4}) = {-1.3438, -0.4492, 0.4492, 1.3438},
+        # out of place and in place
+        la   t0, nrm_buf_x
+        li   t1, 0x3F800000 # 1.0
+        sw   t1, 0(t0)
+        li   t1, 0x40000000 # 2.0
+        sw   t1, 4(t0)
+        li   t1, 0x40400000 # 3.0
+        sw   t1, 8(t0)
+        li   t1, 0x40800000 # 4.0
+        sw   t1, 12(t0)
+        la   t0, nrm_buf_b  # gamma = 1.0 (from test 4), beta = 0
+        sw   zero, 0(t0)
+        sw   zero, 4(t0)
+        sw   zero, 8(t0)
+        sw   zero, 12(t0)
+        la   a0, nrm_buf_x
+        la   a1, nrm_buf_w
+        la   a2, nrm_buf_b
+        la   a3, nrm_buf_y
+        li   a4, 4
+        li   a5, 0
+        jal  ra, layernorm_bf16
+        la   a0, nrm_buf_y
+        la   a1, nrm_y_layer4_ans
+        li   a2, 4
+        jal  ra, nrm_compare
+        li   t1, 5 # error code
+        bnez a0, nrmt_epilogue
+        # and in place (y = x)
+        la   a0, nrm_buf_x
+        la   a1, nrm_buf_w
+        la   a2, nrm_buf_b
+        la   a3, nrm_buf_x
+        li   a4, 4
+        li   a5, 0
+        jal  ra, layernorm_bf16
+        la   a0, nrm_buf_x
+        la   a1, nrm_y_layer4_ans
+        li   a2, 4
+        jal  ra, nrm_compare
+        li   t1, 5 # error code
+        bnez a0, nrmt_epilogue
+    nrmt_t6:
+        # random arrays
+        la   a0, nrm_x
+        la   a1, nrm_w
+        la   a2, nrm_buf_y
+        li   a3, NRM_N
+        li   a4, NRM_EPS
+        jal  ra, rmsnorm_bf16
+        la   a0, nrm_buf_y
+        la   a1, nrm_y_rms_ans
+        li   a2, NRM_N
+        jal  ra, nrm_compare
+        li   t1, 6 # error code
+        bnez a0, nrmt_epilogue
+        la   a0, nrm_x
+        la   a1, nrm_w
+        la   a2, nrm_b
+        la   a3, nrm_buf_y
+        li   a4, NRM_N
+        li   a5, NRM_EPS
+        jal  ra, layernorm_bf16
+        la   a0, nrm_buf_y
+        la   a1, nrm_y_layer_ans
+        li   a2, NRM_N
+        jal  ra, nrm_compare
+        li   t1, 6 # error code
+        bnez a0, nrmt_epilogue
+    nrmt_all_passed:
+        li   t1, 0
+    nrmt_epilogue:
+        mv   a0, t1 # error code
+        lw   ra, 0(sp)
+        lw   s0, 4(sp)
+        lw   s1, 8(sp)
+        lw   s2, 12(sp)
+        addi sp, sp, 16
+        ret
+
+
+# --- nrm_compare ---
+    # compare two arrays of words
+    # input:
+    #   a0: pointer to the first array
+    #   a1: pointer to the second array
+    #   a2: n (u32): number of words (n >= 1)
+    # output:
+    #   a0: 0 if they are identical; otherwise, 1
+nrm_compare:
+    nrmc_loop:
+        lw   t0, 0(a0)
+        lw   t1, 0(a1)
+        bne  t0, t1, nrmc_different
+        addi a0, a0, 4
+        addi a1, a1, 4
+        addi a2, a2, -1
+        bnez a2, nrmc_loop
+        li   a0, 0
+        ret
+    nrmc_different:
+        li   a0, 1
+        ret
+
+
+# --- norm_bf16_bench ---
+    # print the number of cycles of rmsnorm_bf16 and layernorm_bf16
+    # for the NRM_N elements of test 6
+    # input: nothing
+    # output: nothing
+    # notes:
+    #   s0: cycle counter at the beginning
+norm_bf16_bench:
+    nrmb_prologue:
+        addi sp, sp, -8
+        sw   ra, 0(sp)
+        sw   s0, 4(sp)
+    nrmb_body:
+        rdcycle s0
+        la   a0, nrm_x
+        la   a1, nrm_w
+        la   a2, nrm_buf_y
+        li   a3, NRM_N
+        li   a4, NRM_EPS
+        jal  ra, rmsnorm_bf16
+        rdcycle a0
+        sub  a0, a0, s0
+        la   a1, nrm_str_rmsnorm_bf16
+        jal  ra, nrm_print_cycles
+        rdcycle s0
+        la   a0, nrm_x
+        la   a1, nrm_w
+        la   a2, nrm_b
+        la   a3, nrm_buf_y
+        li   a4, NRM_N
+        li   a5, NRM_EPS
+        jal  ra, layernorm_bf16
+        rdcycle a0
+        sub  a0, a0, s0
+        la   a1, nrm_str_layernorm_bf16
+        jal  ra, nrm_print_cycles
+    nrmb_epilogue:
+        lw   ra, 0(sp)
+        lw   s0, 4(sp)
+        addi sp, sp, 8
+        ret
+
+
+# --- nrm_print_cycles ---
+    # print "<name>: <cycles> cycles for NRM_N elements"
+    # input:
+    #   a0: cycles
+    #   a1: name (null-terminated string)
+    # output: nothing
+nrm_print_cycles:
+    nrmpc_prologue:
+        addi sp, sp, -8
+        sw   ra, 0(sp)
+        sw   a0, 4(sp)
+    nrmpc_body:
+        mv   a0, a1
+        jal  ra, print_string
+        lw   a0, 4(sp)
+        jal  ra, print_int
+        la   a0, nrm_str_cycles
+        jal  ra, print_string
+    nrmpc_epilogue:
+        lw   ra, 0(sp)
+        addi sp, sp, 8
+        ret
+
+
+# ┌-------------------------------------------------------┐
+# |         Required Library - add_sub_bf16 v0.1.1        |
+# └-------------------------------------------------------┘
+
+# --- add_sub_bf16 ---
+    # addition or subtraction of two bf16 numbers
+    # input:
+    #   a0: a (bf16): add/sub candidate
+    #   a1: b (bf16): add/sub candidate
+    #   a2: to_add (int): 1 for addition; 0 for subtraction
+    # output:
+    #   a0: r (bf16): result of (a + b) or (a - b)
+    # notes:
+    #   t0: sa, s
+    #   t1: sb
+    #   t2: ea, e
+    #   t3: eb
+    #   t4: ma, m
+    #   t5: mb
+    #   t6: (always temp)
+add_sub_bf16:
+    asb_prologue:
+        addi sp, sp, -4
+        sw   ra, 0(sp)
+    asb_body:
+        # extract expoent and mantissa from a and b
+        li   t6, 0x7F800000
+        and  t2, a0, t6 # ea
+        srli t2, t2, 23
+        addi t2, t2, -127
+        li   t6, 0x7F800000
+        and  t3, a1, t6 # eb
+        srli t3, t3, 23
+        addi t3, t3, -127
+        li   t6, 0x007F0000
+        and  t4, a0, t6 # ma
+        srli t4, t4, 16
+        ori  t4, t4, 0x80
+        li   t6, 0x007F0000
+        and  t5, a1, t6 # mb
+        srli t5, t5, 16
+        ori  t5, t5, 0x80
+
+        # normalization: make 2 numbers have the same exponent
+        blt  t2, t3, asb_normalization_1
+        mv   t6, t2      # t6 = ea
+        sub  t2, t2, t3 # t2 = ea - eb
+        li   t0, 8
+        bge  t0, t2, asb_clamp_b
+        li   t2, 8       # mb >> 8 is already 0; srl only uses 5 bits
+    asb_clamp_b:
+        srl  t5, t5, t2 # mb >>= t2
+        mv   t2, t6      # e = t6
+        j    asb_normalization_end
+    asb_normalization_1:
+        mv   t6, t3      # t6 = eb
+        sub  t2, t3, t2 # t2 = ea - eb
+        li   t0, 8
+        bge  t0, t2, asb_clamp_a
+        li   t2, 8       # ma >> 8 is already 0; srl only uses 5 bits
+    asb_clamp_a:
+        srl  t4, t4, t2 # ma >>= t2
+        mv   t2, t6      # e = t6
+    asb_normalization_end:
+        # addition or subtraction
+        li   t6, 0x80000000
+        and  t0, a0, t6 # sa
+        beqz t0, asb_not_invert_ma
+        sub  t4, zero, t4
+    asb_not_invert_ma:
+        li   t6, 0x80000000
+        and  t1, a1, t6 # sb
+        beqz t1, asb_not_invert_mb_1
+        sub  t5, zero, t5
+    asb_not_invert_mb_1:
+        bnez a2, asb_not_invert_mb_2
+        sub  t5, zero, t5
+    asb_not_invert_mb_2:
+        add  t4, t4, t5 # m = ma + mb
+        # handle negative result
+        li   t0, 0
+        bgez t4, asb_positive_m
+        sub  t4, zero, t4
+        li   t0, 1
+    asb_positive_m:
+        # handle carry bit
+        andi t5, t4, 0x100
+        beqz t5, asb_no_carry
+        srli t4, t4, 1
+        addi t2, t2, 1
+    asb_no_carry:
+        # handle result of 0
+        li   t5, 0x80
+        bnez t4, asb_small
+        li   t2, -127     # e = -127
+        j    asb_small_end
+    asb_small:
+        bge  t4, t5, asb_small_end # while (m < 0x80)
+        addi t2, t2, -1 # e -= 1
+        slli t4, t4, 1  # m <<= 1
+        j    asb_small
+    asb_small_end:
+        # construct the result
+        slli t0, t0, 31   # s = s << 31
+        addi t2, t2, 127  # e = (e + 127) << 23
+        slli t2, t2, 23
+        andi t4, t4, 0x7F # m = (m & 0x7F) << 16
+        slli t4, t4, 16
+        or   a0, t0, t2   # r = s | e | m
+        or   a0, a0, t4
+    asb_epilogue:
+        lw   ra, 0(sp)
+        addi sp, sp, 4
+        ret
+
+
+# --- add_bf16 ---
+    # addition of two bf16 numbers.
+    # input:
+    #   a0: a (bf16): addition candidate
+    #   a1: b (bf16): addition candidate
+    # output:
+    #   a0: r (bf16): reslut of (a + b)
+add_bf16:
+        addi sp, sp, -4
+        sw   ra, 0(sp)
+        li   a2, 1
+        jal  ra, add_sub_bf16
+        lw   ra, 0(sp)
+        addi sp, sp, 4
+        ret
+
+
+# --- sub_bf16 ---
+    # subtraction of two bf16 numbers.
+    # input:
+    #   a0: a (bf16): subtraction candidate
+    #   a1: b (bf16): subtraction candidate
+    # output:
+    #   a0: r (bf16): reslut of (a - b)
+sub_bf16:
+        addi sp, sp, -4
+        sw   ra, 0(sp)
+        li   a2, 0
+        jal  ra, add_sub_bf16
+        lw   ra, 0(sp)
+        addi sp, sp, 4
+        ret
+
+
+# ┌-------------------------------------------------------┐
+# |        Required Library - mul_shift_u32 v0.0.0        |
+# └-------------------------------------------------------┘
+
+# --- mul_shift_u32 ---
+    # binary multiplication of two u32 numbers
+    # input:
+    #   a0: a (u32): multiplier
+    #   a1: b (u32): multiplicand
+    # output:
+    #   a0: r (u32): product of a and b (a * b)
+mul_shift_u32:
+    mhu_prologue:
+        addi sp, sp, -4
+        sw   ra, 0(sp)
+        bge  a0, a1, mhu_no_swap
+        # make a1 <= a0
+        addi t0, a1, 0
+        mv   a1, a0
+        mv   a0, t0
+    mhu_no_swap:
+        # binary multiplication of t0 = a0 * a1
+        addi t0, zero, 0 # t0 = result
+    mhu_loop:
+        beq  a1, zero, mhu_epilogue
+        andi t2, a1, 1 # the least significant bit of a1
+        beq  t2, zero, mhu_next
+        add  t0, t0, a0
+    mhu_next:
+        slli a0, a0, 1
+        srli a1, a1, 1
+        j mhu_loop
+    mhu_epilogue:
+        mv   a0, t0
+        lw   ra, 0(sp)
+        addi sp, sp, 4
+        ret
+
+
+# ┌-------------------------------------------------------┐
+# |           Required Library - mul_bf16 v0.1.0          |
+# └-------------------------------------------------------┘
+
+# --- mul_bf16 ---
+    # multiplication of two bf16 numbers
+    # input:
+    #   a0: a (bf16): multiplier
+    #   a1: b (bf16): multiplicand
+    # output:
+    #   a0: m, r (bf16): product of a and b (a * b)
+    # notes:
+    #   s0: s
+    #   s1: e
+    #   t0: sa
+    #   t1: sb
+    #   t2: ea
+    #   t3: eb
+    #   t4: ma
+    #   t5: mb
+mul_bf16:
+    mb_prologue:
+        addi sp, sp, -12
+        sw   ra, 0(sp)
+        sw   s0, 4(sp)
+        sw   s1, 8(sp)
+    mb_body:
+        beqz a0, mb_epilogue
+        bnez a1, mb_nonzero_input
+        mv   a0, zero
+        j    mb_epilogue
+    mb_nonzero_input:
+        # extract sign, exponent and mantissa of a and b
+        sltz t0, a0 # sa
+        sltz t1, a1 # sb
+        li   t3, 0x7F800000
+        and  t2, a0, t3
+        srli t2, t2, 23
+        addi t2, t2, -127 # ea
+        and  t3, a1, t3
+        srli t3, t3, 23
+        addi t3, t3, -127 # eb
+        li   t5, 0x007F0000
+        and  t4, a0, t5
+        srli t4, t4, 16
+        ori  t4, t4, 0x80 # ma
+        and  t5, a1, t5
+        srli t5, t5, 16
+        ori  t5, t5, 0x80 # mb
+        # calculate the initial result
+        xor  s0, t0, t1 # s = sa ^ sb
+        add  s1, t2, t3 # e = ea + eb
+        mv   a0, t4
+        mv   a1, t5
+        jal  ra, mul_shift_u32
+        srli a0, a0, 7  # m = (ma * mb) >> 7
+        # handle carry bit
+        andi t1, a0, 0x100
+        beqz t1, mb_no_carry
+        srli a0, a0, 1
+        addi s1, s1, 1
+    mb_no_carry:
+        # handle result of +-0
+        bnez a0, mb_nonzero_result
+        slli a0, s0, 31   # r = s << 31
+        j    mb_epilogue
+    mb_nonzero_result:
+        # construct the result
+        slli s0, s0, 31   # s = s << 31
+        addi s1, s1, 127
+        slli s1, s1, 23   # e = (e + 127) << 23
+        andi a0, a0, 0x7F
+        slli a0, a0, 16   # m = (m & 0x7F) << 16
+        or   a0, a0, s0
+        or   a0, a0, s1   # r = s | e | m
+    mb_epilogue:
+        lw   ra, 0(sp)
+        lw   s0, 4(sp)
+        lw   s1, 8(sp)
+        addi sp, sp, 12
+        ret
+
+
+# ┌-------------------------------------------------------┐
+# |          Required Library - rsqrt_bf16 v0.0.0         |
+# └-------------------------------------------------------┘
+
+# --- rsqrt_bf16 ---
+    # reciprocal square root of a bf16 number
+    # input:
+    #   a0: x (bf16)
+    # output:
+    #   a0: r (bf16): 1 / sqrt(x), within 2 ulp for x > 0;
+    #       +inf for +-0, 0 for +inf, and NaN for x < 0 and NaN
+    # notes:
+    #   s0: y, the initial guess
+rsqrt_bf16:
+    rsb_prologue:
+        addi sp, sp, -8
+        sw   ra, 0(sp)
+        sw   s0, 4(sp)
+    rsb_body:
+        # remove extra bits and catch the special cases
+        li   t0, 0xFFFF0000
+        and  a0, a0, t0
+        slli t1, a0, 1
+        bnez t1, rsb_nonzero
+        li   a0, 0x7F800000 # +inf
+        j    rsb_epilogue
+    rsb_nonzero:
+        li   t0, 0x7F800000
+        bne  a0, t0, rsb_finite
+        li   a0, 0          # 0
+        j    rsb_epilogue
+    rsb_finite:
+        bgeu t0, a0, rsb_positive
+        li   a0, 0x7FC00000 # NaN
+        j    rsb_epilogue
+    rsb_positive:
+        # initial guess: y = (0x5F310000 - (x >> 1)) & 0xFFFF0000
+        srli t1, a0, 1
+        li   t0, 0x5F310000
+        sub  t1, t0, t1
+        li   t0, 0xFFFF0000
+        and  s0, t1, t0
+        # one Newton step: y = y * (1.5 - 0.5 * t), where t = x * y * y
+        mv   a1, s0
+        jal  ra, mul_bf16 # x * y
+        mv   a1, s0
+        jal  ra, mul_bf16 # t = x * y * y, which is about 1
+        li   t0, 0x00800000
+        sub  a1, a0, t0   # 0.5 * t
+        li   a0, 0x3FC00000
+        jal  ra, sub_bf16 # 1.5 - 0.5 * t
+        mv   a1, s0
+        jal  ra, mul_bf16
+    rsb_epilogue:
+        lw   ra, 0(sp)
+        lw   s0, 4(sp)
+        addi sp, sp, 8
+        ret
+
+
+# ┌-------------------------------------------------------┐
+# |                        Library                        |
+# └-------------------------------------------------------┘
+
+# An extended accumulator is kept in two registers, (m, e), whose value
+# is m * 2^e, where abs(m) < 2^30.
+
+# --- norm_acc_add ---
+    # add m * 2^e, where abs(m) < 2^30, to the accumulator
+    # input:
+    #   a0: acc.m (i32)
+    #   a1: acc.e (i32)
+    #   a2: m (i32)
+    #   a3: e (i32)
+    # output:
+    #   a0: acc.m (i32)
+    #   a1: acc.e (i32)
+    # notes:
+    #   t0: d, the difference of the exponents
+    #   t1: (always temp)
+norm_acc_add:
+    naa_body:
+        bnez a0, naa_nonempty
+        mv   a0, a2
+        mv   a1, a3
+        ret
+    naa_nonempty:
+        # alignment; shift the one with the smaller exponent by at most 31
+        li   t1, 31
+        sub  t0, a1, a3
+        bltz t0, naa_shift_acc
+        bge  t1, t0, naa_shift_m
+        mv   t0, t1
+    naa_shift_m:
+        sra  a2, a2, t0
+        j    naa_add
+    naa_shift_acc:
+        sub  t0, zero, t0
+        bge  t1, t0, naa_shift_acc_1
+        mv   t0, t1
+    naa_shift_acc_1:
+        sra  a0, a0, t0
+        mv   a1, a3
+    naa_add:
+        # abs(m) < 2^31; make abs(m) < 2^30
+        add  a0, a0, a2
+        li   t1, 0x40000000
+        bge  a0, t1, naa_carry
+        li   t1, -0x40000000
+        blt  t1, a0, naa_epilogue
+    naa_carry:
+        srai a0, a0, 1
+        addi a1, a1, 1
+    naa_epilogue:
+        ret
+
+
+# --- norm_acc_add_square ---
+    # add x^2 to the accumulator; zeros (and subnormals) are skipped
+    # input:
+    #   a0: acc.m (i32)
+    #   a1: acc.e (i32)
+    #   a2: x (bf16)
+    # output:
+    #   a0: acc.m (i32)
+    #   a1: acc.e (i32)
+    # notes:
+    #   s0: acc.m
+    #   s1: acc.e
+    #   s2: ex
+norm_acc_add_square:
+    naas_prologue:
+        addi sp, sp, -16
+        sw   ra, 0(sp)
+        sw   s0, 4(sp)
+        sw   s1, 8(sp)
+        sw   s2, 12(sp)
+    naas_body:
+        srli s2, a2, 23
+        andi s2, s2, 0xFF # ex
+        beqz s2, naas_epilogue
+        mv   s0, a0
+        mv   s1, a1
+        # x^2 = mx^2 * 2^(2 * (ex - 127 - 7)), where 2^14 <= mx^2 < 2^16
+        srli a0, a2, 16
+        andi a0, a0, 0x7F
+        ori  a0, a0, 0x80 # mx
+        mv   a1, a0
+        jal  ra, mul_shift_u32
+        slli a2, a0, 14
+        slli a3, s2, 1
+        addi a3, a3, -282 # 2 * ex - 268 - 14
+        mv   a0, s0
+        mv   a1, s1
+        jal  ra, norm_acc_add
+    naas_epilogue:
+        lw   ra, 0(sp)
+        lw   s0, 4(sp)
+        lw   s1, 8(sp)
+        lw   s2, 12(sp)
+        addi sp, sp, 16
+        ret
+
+
+# --- norm_acc_add_bf16 ---
+    # add x to the accumulator; zeros (and subnormals) are skipped
+    # input:
+    #   a0: acc.m (i32)
+    #   a1: acc.e (i32)
+    #   a2: x (bf16)
+    # output:
+    #   a0: acc.m (i32)
+    #   a1: acc.e (i32)
+norm_acc_add_bf16:
+    naab_prologue:
+        addi sp, sp, -4
+        sw   ra, 0(sp)
+    naab_body:
+        srli a3, a2, 23
+        andi a3, a3, 0xFF # ex
+        beqz a3, naab_epilogue
+        # x = mx * 2^(ex - 127 - 7), where 2^7 <= abs(mx) < 2^8
+        addi a3, a3, -156 # ex - 134 - 22
+        srli t0, a2, 16
+        andi t0, t0, 0x7F
+        ori  t0, t0, 0x80 # mx
+        bgez a2, naab_positive
+        sub  t0, zero, t0
+    naab_positive:
+        slli a2, t0, 22
+        jal  ra, norm_acc_add
+    naab_epilogue:
+        lw   ra, 0(sp)
+        addi sp, sp, 4
+        ret
+
+
+# --- norm_acc_to_bf16 ---
+    # round the accumulator to the nearest bf16 (ties away from zero)
+    # input:
+    #   a0: acc.m (i32)
+    #   a1: acc.e (i32)
+    # output:
+    #   a0: r (bf16): +-inf if it overflows, and +-0 if it underflows
+    # notes:
+    #   t0: s
+    #   t1: (always temp)
+norm_acc_to_bf16:
+    natb_body:
+        beqz a0, natb_epilogue
+        li   t0, 0
+        bgez a0, natb_positive
+        li   t0, 0x80000000
+        sub  a0, zero, a0
+    natb_positive:
+        # normalization: make 2^30 <= a < 2^31
+        addi a1, a1, 30
+        li   t1, 0x40000000
+    natb_normalize:
+        bgeu a0, t1, natb_round
+        slli a0, a0, 1
+        addi a1, a1, -1
+        j    natb_normalize
+    natb_round:
+        # round to 8 significant bits
+        li   t1, 0x400000
+        add  a0, a0, t1
+        srli a0, a0, 23
+        li   t1, 0x100
+        bne  a0, t1, natb_pack
+        li   a0, 0x80
+        addi a1, a1, 1
+    natb_pack:
+        addi a1, a1, 127
+        li   t1, 0xFF
+        blt  a1, t1, natb_not_inf
+        li   t1, 0x7F800000
+        or   a0, t0, t1 # +-inf
+        ret
+    natb_not_inf:
+        bgtz a1, natb_normal
+        mv   a0, t0 # +-0
+        ret
+    natb_normal:
+        slli a1, a1, 23
+        andi a0, a0, 0x7F
+        slli a0, a0, 16
+        or   a0, a0, a1
+        or   a0, a0, t0
+    natb_epilogue:
+        ret
+
+
+# --- norm_inv_n ---
+    # reciprocal of a positive integer, rounded to the nearest bf16
+    # (ties away from zero); only the 16 most significant bits of n
+    # are used
+    # input:
+    #   a0: n (u32): n >= 1
+    # output:
+    #   a0: r (bf16): 1 / n
+    # notes:
+    #   t0: k, then e
+    #   t1: (always temp)
+    #   t2: remainder
+    #   t3: q
+    #   t4: loop counter
+norm_inv_n:
+    nin_body:
+        # normalization: make 2^15 <= n < 2^16, where 1 / n = (1 / n') * 2^k
+        li   t0, 0
+        li   t1, 0x10000
+    nin_shift_right:
+        bltu a0, t1, nin_shift_left_0
+        srli a0, a0, 1
+        addi t0, t0, -1
+        j    nin_shift_right
+    nin_shift_left_0:
+        li   t1, 0x8000
+    nin_shift_left:
+        bgeu a0, t1, nin_divide_0
+        slli a0, a0, 1
+        addi t0, t0, 1
+        j    nin_shift_left
+    nin_divide_0:
+        # q = 2^31 / n' by long division, 2^15 < q <= 2^16
+        li   t2, 1
+        li   t3, 0
+        li   t4, 31
+    nin_divide:
+        slli t2, t2, 1
+        slli t3, t3, 1
+        bltu t2, a0, nin_divide_next
+        sub  t2, t2, a0
+        ori  t3, t3, 1
+    nin_divide_next:
+        addi t4, t4, -1
+        bnez t4, nin_divide
+        addi t0, t0, -16 # e = k - 16
+        li   t1, 0x10000
+        bne  t3, t1, nin_round
+        li   t3, 0x8000
+        addi t0, t0, 1
+    nin_round:
+        # round to 8 significant bits
+        addi t3, t3, 0x80
+        srli t3, t3, 8
+        li   t1, 0x100
+        bne  t3, t1, nin_pack
+        li   t3, 0x80
+        addi t0, t0, 1
+    nin_pack:
+        addi t0, t0, 127
+        slli t0, t0, 23
+        andi t3, t3, 0x7F
+        slli t3, t3, 16
+        or   a0, t0, t3
+        ret
+
+
+# --- norm_acc_mean ---
+    # mean of the n terms in the accumulator, rounded to bf16; the
+    # exponent of 1 / n is added to the accumulator exactly, and only
+    # the mantissa of 1 / n is multiplied in bf16
+    # input:
+    #   a0: acc.m (i32)
+    #   a1: acc.e (i32)
+    #   a2: n (u32): n >= 1
+    # output:
+    #   a0: r (bf16): acc / n
+    # notes:
+    #   s0: acc.m
+    #   s1: acc.e, then the mantissa of 1 / n (in [1, 2))
+norm_acc_mean:
+    nam_prologue:
+        addi sp, sp, -12
+        sw   ra, 0(sp)
+        sw   s0, 4(sp)
+        sw   s1, 8(sp)
+    nam_body:
+        mv   s0, a0
+        mv   s1, a1
+        mv   a0, a2
+        jal  ra, norm_inv_n
+        srli t0, a0, 23
+        addi t0, t0, -127
+        add  a1, s1, t0 # acc.e += exponent of 1 / n
+        li   t0, 0x7F0000
+        and  t0, a0, t0
+        li   t1, 0x3F800000
+        or   s1, t0, t1
+        mv   a0, s0
+        jal  ra, norm_acc_to_bf16
+        mv   a1, s1
+        jal  ra, mul_bf16
+    nam_epilogue:
+        lw   ra, 0(sp)
+        lw   s0, 4(sp)
+        lw   s1, 8(sp)
+        addi sp, sp, 12
+        ret
+
+
+# --- rmsnorm_bf16 ---
+    # RMS normalization of n bf16 numbers:
+    #   y = x / sqrt(mean(x^2) + eps) * w
+    # input:
+    #   a0: x: pointer to n bf16 numbers
+    #   a1: w: pointer to n bf16 numbers, the weights
+    #   a2: y: pointer to n bf16 numbers, the output; y may be x
+    #   a3: n (u32): n >= 1
+    #   a4: eps (bf16)
+    # output: nothing
+    # notes:
+    #   s0: x
+    #   s1: w
+    #   s2: y
+    #   s3: n
+    #   s4: eps, then r = 1 / sqrt(mean(x^2) + eps)
+    #   s5: i
+    #   s6: acc.m
+    #   s7: acc.e
+rmsnorm_bf16:
+    rmsn_prologue:
+        addi sp, sp, -36
+        sw   ra, 0(sp)
+        sw   s0, 4(sp)
+        sw   s1, 8(sp)
+        sw   s2, 12(sp)
+        sw   s3, 16(sp)
+        sw   s4, 20(sp)
+        sw   s5, 24(sp)
+        sw   s6, 28(sp)
+        sw   s7, 32(sp)
+    rmsn_body:
+        mv   s0, a0
+        mv   s1, a1
+        mv   s2, a2
+        mv   s3, a3
+        mv   s4, a4
+        # pass 1: mean square
+        li   s5, 0
+        li   s6, 0
+        li   s7, 0
+    rmsn_pass_1:
+        slli t0, s5, 2
+        add  t0, s0, t0
+        lw   a2, 0(t0)
+        mv   a0, s6
+        mv   a1, s7
+        jal  ra, norm_acc_add_square
+        mv   s6, a0
+        mv   s7, a1
+        addi s5, s5, 1
+        bne  s5, s3, rmsn_pass_1
+        mv   a0, s6
+        mv   a1, s7
+        mv   a2, s3
+        jal  ra, norm_acc_mean
+        mv   a1, s4
+        jal  ra, add_bf16
+        jal  ra, rsqrt_bf16
+        mv   s4, a0
+        # pass 2: normalize and scale
+        li   s5, 0
+    rmsn_pass_2:
+        slli s6, s5, 2
+        add  t0, s0, s6
+        lw   a0, 0(t0)
+        mv   a1, s4
+        jal  ra, mul_bf16
+        add  t0, s1, s6
+        lw   a1, 0(t0)
+        jal  ra, mul_bf16
+        add  t0, s2, s6
+        sw   a0, 0(t0)
+        addi s5, s5, 1
+        bne  s5, s3, rmsn_pass_2
+    rmsn_epilogue:
+        lw   ra, 0(sp)
+        lw   s0, 4(sp)
+        lw   s1, 8(sp)
+        lw   s2, 12(sp)
+        lw   s3, 16(sp)
+        lw   s4, 20(sp)
+        lw   s5, 24(sp)
+        lw   s6, 28(sp)
+        lw   s7, 32(sp)
+        addi sp, sp, 36
+        ret
+
+
+# --- layernorm_bf16 ---
+    # layer normalization of n bf16 numbers:
+    #   y = (x - mean(x)) / sqrt(var(x) + eps) * gamma + beta,
+    # where the statistics are of d = x - x[0]
+    # input:
+    #   a0: x: pointer to n bf16 numbers
+    #   a1: gamma: pointer to n bf16 numbers, the weights
+    #   a2: beta: pointer to n bf16 numbers, the biases
+    #   a3: y: pointer to n bf16 numbers, the output; y may be x
+    #   a4: n (u32): n >= 1
+    #   a5: eps (bf16)
+    # output: nothing
+    # notes:
+    #   s0: x
+    #   s1: gamma
+    #   s2: beta
+    #   s3: y
+    #   s4: n
+    #   s5: eps, then r = 1 / sqrt(var + eps)
+    #   s6: i
+    #   s7: d, then mean(d)
+    #   s8, s9: acc of d (m, e); in pass 2, s8 is 4 * i and s9 is x[0]
+    #   s10, s11: acc of d^2 (m, e)
+layernorm_bf16:
+    lyn_prologue:
+        addi sp, sp, -52
+        sw   ra, 0(sp)
+        sw   s0, 4(sp)
+        sw   s1, 8(sp)
+        sw   s2, 12(sp)
+        sw   s3, 16(sp)
+        sw   s4, 20(sp)
+        sw   s5, 24(sp)
+        sw   s6, 28(sp)
+        sw   s7, 32(sp)
+        sw   s8, 36(sp)
+        sw   s9, 40(sp)
+        sw   s10, 44(sp)
+        sw   s11, 48(sp)
+    lyn_body:
+        mv   s0, a0
+        mv   s1, a1
+        mv   s2, a2
+        mv   s3, a3
+        mv   s4, a4
+        mv   s5, a5
+        # pass 1: mean and variance of d = x - x[0]
+        li   s6, 0
+        li   s8, 0
+        li   s9, 0
+        li   s10, 0
+        li   s11, 0
+    lyn_pass_1:
+        slli t0, s6, 2
+        add  t0, s0, t0
+        lw   a0, 0(t0)
+        lw   a1, 0(s0)
+        jal  ra, sub_bf16
+        mv   s7, a0 # d
+        mv   a2, a0
+        mv   a0, s8
+        mv   a1, s9
+        jal  ra, norm_acc_add_bf16
+        mv   s8, a0
+        mv   s9, a1
+        mv   a2, s7
+        mv   a0, s10
+        mv   a1, s11
+        jal  ra, norm_acc_add_square
+        mv   s10, a0
+        mv   s11, a1
+        addi s6, s6, 1
+        bne  s6, s4, lyn_pass_1
+        mv   a0, s8
+        mv   a1, s9
+        mv   a2, s4
+        jal  ra, norm_acc_mean
+        mv   s7, a0 # mean(d)
+        mv   a0, s10
+        mv   a1, s11
+        mv   a2, s4
+        jal  ra, norm_acc_mean
+        mv   s8, a0 # mean(d^2)
+        mv   a0, s7
+        mv   a1, s7
+        jal  ra, mul_bf16
+        mv   a1, a0
+        mv   a0, s8
+        jal  ra, sub_bf16 # var = mean(d^2) - mean(d)^2
+        bgez a0, lyn_var_positive
+        li   a0, 0 # rounding errors
+    lyn_var_positive:
+        mv   a1, s5
+        jal  ra, add_bf16
+        jal  ra, rsqrt_bf16
+        mv   s5, a0
+        # pass 2: normalize, scale and shift;
+        # (x - x[0]) - mean(d) is more precise than x - mean(x);
+        # x[0] is kept, for y may be x and y[0] is written first
+        lw   s9, 0(s0)
+        li   s6, 0
+    lyn_pass_2:
+        slli s8, s6, 2
+        add  t0, s0, s8
+        lw   a0, 0(t0)
+        mv   a1, s9
+        jal  ra, sub_bf16
+        mv   a1, s7
+        jal  ra, sub_bf16
+        mv   a1, s5
+        jal  ra, mul_bf16
+        add  t0, s1, s8
+        lw   a1, 0(t0)
+        jal  ra, mul_bf16
+        add  t0, s2, s8
+        lw   a1, 0(t0)
+        jal  ra, add_bf16
+        add  t0, s3, s8
+        sw   a0, 0(t0)
+        addi s6, s6, 1
+        bne  s6, s4, lyn_pass_2
+    lyn_epilogue:
+        lw   ra, 0(sp)
+        lw   s0, 4(sp)
+        lw   s1, 8(sp)
+        lw   s2, 12(sp)
+        lw   s3, 16(sp)
+        lw   s4, 20(sp)
+        lw   s5, 24(sp)
+        lw   s6, 28(sp)
+        lw   s7, 32(sp)
+        lw   s8, 36(sp)
+        lw   s9, 40(sp)
+        lw   s10, 44(sp)
+        lw   s11, 48(sp)
+        addi sp, sp, 52
+        ret
+
+
+# ┌-------------------------------------------------------┐
+# |                   Testing Suite Data                  |
+# └-------------------------------------------------------┘
+
+.data
+
+nrm_str_rmsnorm_bf16:
+    .string "rmsnorm_bf16: "
+nrm_str_layernorm_bf16:
+    .string "layernorm_bf16: "
+nrm_str_cycles:
+    .string " cycles for 64 elements\n"
+
+.align 2
+nrm_buf_x:
+    .space 4 * NRM_ONES
+nrm_buf_w:
+    .space 4 * NRM_ONES
+nrm_buf_b:
+    .space 4 * NRM_ONES
+nrm_buf_y:
+    .space 4 * NRM_ONES
+
+# layernorm_bf16({1, 2, 3, 4}) (from the C program)
+nrm_y_layer4_ans:
+    .word 0xBFAC0000, 0xBEE60000, 0x3EE60000, 0x3FAC0000
+
+# x = 0.5 + u, where -1 <= u < 1
+nrm_x:
+    .word 0xBD240000, 0x3F9E0000, 0x3F1C0000, 0x3F270000
+    .word 0x3FBE0000, 0x3F300000, 0x3F8C0000, 0x3F910000
+    .word 0x3F420000, 0x3F010000, 0x3F7D0000, 0x3F900000
+    .word 0x3FBE0000, 0x3F040000, 0x3F650000, 0xBCD30000
+    .word 0x3E940000, 0x3F9E0000, 0xBCE80000, 0x3DAB0000
+    .word 0x3F340000, 0x3F1C0000, 0xBEF60000, 0xBECB0000
+    .word 0x3DD90000, 0x3DA30000, 0xBDE10000, 0x3CE20000
+    .word 0x3F560000, 0x3DC50000, 0x3F9C0000, 0x3FA60000
+    .word 0xBE270000, 0x3EA80000, 0x3EE80000, 0xBE330000
+    .word 0xBEF60000, 0x3D5C0000, 0x3FBB0000, 0x3F470000
+    .word 0x3F870000, 0x3F740000, 0x3ED20000, 0x3F860000
+    .word 0xBCF60000, 0xBE440000, 0xBEF20000, 0x3F420000
+    .word 0xBEE70000, 0xBAF90000, 0x3FAB0000, 0x3F400000
+    .word 0x3F8D0000, 0x3FAE0000, 0x3F5A0000, 0xBE920000
+    .word 0xBD6F0000, 0x3F9F0000, 0x3E780000, 0x3FA30000
+    .word 0xBE230000, 0xBD1C0000, 0x3F8A0000, 0x3E340000
+
+# w (and gamma) = 1 + u / 4
+nrm_w:
+    .word 0x3F890000, 0x3F620000, 0x3F800000, 0x3F890000
+    .word 0x3F820000, 0x3F7D0000, 0x3F650000, 0x3F690000
+    .word 0x3F5A0000, 0x3F8F0000, 0x3F4C0000, 0x3F780000
+    .word 0x3F990000, 0x3F4E0000, 0x3F490000, 0x3F9B0000
+    .word 0x3F6E0000, 0x3F9F0000, 0x3F830000, 0x3F550000
+    .word 0x3F9B0000, 0x3F5D0000, 0x3F630000, 0x3F520000
+    .word 0x3F4D0000, 0x3F890000, 0x3F440000, 0x3F620000
+    .word 0x3F980000, 0x3F940000, 0x3F870000, 0x3F810000
+    .word 0x3F4B0000, 0x3F4E0000, 0x3F560000, 0x3F880000
+    .word 0x3F850000, 0x3F7C0000, 0x3F9D0000, 0x3F930000
+    .word 0x3F5C0000, 0x3F470000, 0x3F5F0000, 0x3F500000
+    .word 0x3F560000, 0x3F680000, 0x3F460000, 0x3F820000
+    .word 0x3F670000, 0x3F860000, 0x3F8C0000, 0x3F5E0000
+    .word 0x3F950000, 0x3F9E0000, 0x3F700000, 0x3F9C0000
+    .word 0x3F870000, 0x3F750000, 0x3F5B0000, 0x3F7F0000
+    .word 0x3F5E0000, 0x3F940000, 0x3F420000, 0x3F6A0000
+
+# beta = u / 4
+nrm_b:
+    .word 0x3E5E0000, 0xBE1B0000, 0x3E700000, 0x3C520000
+    .word 0x3DAB0000, 0x3E5B0000, 0xBDB20000, 0x3E470000
+    .word 0x3E790000, 0x3D0C0000, 0xBE780000, 0xBE2D0000
+    .word 0x3E440000, 0xBE5D0000, 0x3DC80000, 0xBE1C0000
+    .word 0x3DB30000, 0xBD500000, 0xBD110000, 0x3BDD0000
+    .word 0xBD800000, 0x3E1E0000, 0xBCBC0000, 0x3E7E0000
+    .word 0xBE0C0000, 0x3DAA0000, 0xBB3D0000, 0xBC860000
+    .word 0xBBA80000, 0x3BE20000, 0x3E190000, 0xBD1C0000
+    .word 0x3DD70000, 0x3E0A0000, 0x3E660000, 0xBD7A0000
+    .word 0x3DCA0000, 0xBDE60000, 0xBDEE0000, 0x3DBE0000
+    .word 0x3E2F0000, 0xBDE00000, 0x3E310000, 0x3DE90000
+    .word 0xBD9A0000, 0x3CAC0000, 0x3E570000, 0xBE730000
+    .word 0x3E610000, 0xBD980000, 0x3C9C0000, 0xBDBD0000
+    .word 0xBE2E0000, 0x3E7B0000, 0xBDC10000, 0xBD6A0000
+    .word 0x3DA20000, 0x3E1C0000, 0x3E340000, 0xBE330000
+    .word 0xBDB90000, 0x3D9D0000, 0x3D130000, 0xBE710000
+
+# rmsnorm_bf16(x, w, eps = 0.00000997) (from the C program)
+nrm_y_rms_ans:
+    .word 0xBD600000, 0x3FB20000, 0x3F470000, 0x3F630000
+    .word 0x3FF60000, 0x3F5E0000, 0x3FA00000, 0x3FA80000
+    .word 0x3F530000, 0x3F380000, 0x3F810000, 0x3FB20000
+    .word 0x40110000, 0x3F070000, 0x3F650000, 0xBD230000
+    .word 0x3EAF0000, 0x3FFA0000, 0xBD170000, 0x3DB60000
+    .word 0x3F8B0000, 0x3F2B0000, 0xBF0B0000, 0xBED50000
+    .word 0x3DDE0000, 0x3DDE0000, 0xBDDC0000, 0x3CFE0000
+    .word 0x3FA20000, 0x3E110000, 0x3FD10000, 0x3FD50000
+    .word 0xBE280000, 0x3EAD0000, 0x3EF70000, 0xBE730000
+    .word 0xBF230000, 0x3D890000, 0x40120000, 0x3F910000
+    .word 0x3F930000, 0x3F720000, 0x3EE90000, 0x3F8A0000
+    .word 0xBD030000, 0xBE630000, 0xBEEF0000, 0x3F7B0000
+    .word 0xBF040000, 0xBB260000, 0x3FEF0000, 0x3F550000
+    .word 0x3FD10000, 0x40090000, 0x3F820000, 0xBEE30000
+    .word 0xBDA10000, 0x3FC20000, 0x3E870000, 0x3FCF0000
+    .word 0xBE340000, 0xBD660000, 0x3F850000, 0x3E520000
+
+# layernorm_bf16(x, w, beta, eps = 0.00000997) (from the C program)
+nrm_y_layer_ans:
+    .word 0xBF4A0000, 0x3F6C0000, 0x3EC90000, 0x3E850000
+    .word 0x3FE00000, 0x3F000000, 0x3F4B0000, 0x3F920000
+    .word 0x3F170000, 0x3C440000, 0x3EC80000, 0x3F540000
+    .word 0x400A0000, 0xBE5D0000, 0x3F1A0000, 0xBFA10000
+    .word 0xBE8B0000, 0x3FBB0000, 0xBF7A0000, 0xBF1C0000
+    .word 0x3EA50000, 0x3E950000, 0xBFC20000, 0xBF830000
+    .word 0xBF310000, 0xBF360000, 0xBF4E0000, 0xBF3F0000
+    .word 0x3F240000, 0xBF520000, 0x3FB40000, 0x3FA70000
+    .word 0xBF4F0000, 0xBDF80000, 0x3E0B0000, 0xBFA50000
+    .word 0xBFD50000, 0xBF600000, 0x3FEE0000, 0x3F190000
+    .word 0x3F740000, 0x3EEE0000, 0x3C900000, 0x3F580000
+    .word 0xBF590000, 0xBF880000, 0xBF8C0000, 0x3E3A0000
+    .word 0xBFA10000, 0xBF7F0000, 0x3FC40000, 0x3E810000
+    .word 0x3F7E0000, 0x40000000, 0x3EE00000, 0xBFDB0000
+    .word 0xBF700000, 0x3FAA0000, 0xBE620000, 0x3F8E0000
+    .word 0xBF8A0000, 0xBF820000, 0x3F420000, 0xBF430000
@@ -0,0 +1,664 @@
+# This program implements and tests block-scaled quantization of
+# bfloat16 (bf16) arrays to 8-bit integers (q8), and vice versa.
+#
+# For including as a library, include only codes in…
+# (1) all of the "Required Library" sections, and
+# (2) the "Library" section.
+#
+# Library dependency graph:
+#   mul_shift_u32 -> **q8_bf16**
+#
+# Version: 0.0.0
+# Tested: 2026-10-18T11:05:00+08:00
+#
+# reference: ../src/q8_bf16.c
+
+.text
+
+# ┌-------------------------------------------------------┐
+# |                     Testing Suite                     |
+# └-------------------------------------------------------┘
+
+.equ Q8_N, 35 # one full block and a block of 3 elements
+
+.globl main
+main:
+    # test all functionalities
+    jal  ra, q8_bf16_test
+    # returns a0 = 0 for success, or non-zero for index of failed test
+
+    # print result
+    jal ra, print_int
+    li a0, '\n'
+    jal ra, print_char
+
+    # print the number of cycles of both directions
+    jal ra, q8_bf16_bench
+
+    # exit program
+    li a0, 0
+    j exit
+
+
+# --- q8_bf16_test ---
+    # test the functionalities of bf16_to_q8 and q8_to_bf16
+    # input: nothing
+    # output:
+    #   a0: error_code: 0 for success
+    #                   otherwise, index of the first failed test
+    # notes:
+    #   the answers are generated by the C program, for the
+    #   results of both should be identical
+q8_bf16_test:
+    qbt_prologue:
+        addi sp, sp, -4
+        sw   ra, 0(sp)
+    qbt_t1:
+        # quantize Q8_N numbers (one full block and a partial block)
+        la   a0, q8_x
+        la   a1, q8_q
+        la   a2, q8_s
+        li   a3, Q8_N
+        jal  ra, bf16_to_q8
+        la   a0, q8_s
+        la   a1, q8_s_ans
+        li   a2, 8
+        jal  ra, q8_memcmp
+        li   t1, 1 # error code
+        bnez a0, qbt_epilogue
+    qbt_t2:
+        la   a0, q8_q
+        la   a1, q8_q_ans
+        li   a2, Q8_N
+        jal  ra, q8_memcmp
+        li   t1, 2 # error code
+        bnez a0, qbt_epilogue
+    qbt_t3:
+        # dequantize them back
+        la   a0, q8_q
+        la   a1, q8_s
+        la   a2, q8_y
+        li   a3, Q8_N
+        jal  ra, q8_to_bf16
+        la   a0, q8_y
+        la   a1, q8_y_ans
+        li   a2, Q8_N * 4
+        jal  ra, q8_memcmp
+        li   t1, 3 # error code
+        bnez a0, qbt_epilogue
+    qbt_all_passed:
+        li   t1, 0
+    qbt_epilogue:
+        mv   a0, t1 # error code
+        lw   ra, 0(sp)
+        addi sp, sp, 4
+        ret
+
+
+# --- q8_bf16_bench ---
+    # print the number of cycles to quantize and dequantize
+    # the Q8_N numbers of the test
+    # input: nothing
+    # output: nothing
+    # notes:
+    #   s0: cycle counter at the beginning
+q8_bf16_bench:
+    qbb_prologue:
+        addi sp, sp, -8
+        sw   ra, 0(sp)
+        sw   s0, 4(sp)
+    qbb_quantize:
+        rdcycle s0
+        la   a0, q8_x
+        la   a1, q8_q
+        la   a2, q8_s
+        li   a3, Q8_N
+        jal  ra, bf16_to_q8
+        rdcycle a0
+        sub  a0, a0, s0
+        la   a1, q8_str_quantize
+        jal  ra, q8_print_cycles
+    qbb_dequantize:
+        rdcycle s0
+        la   a0, q8_q
+        la   a1, q8_s
+        la   a2, q8_y
+        li   a3, Q8_N
+        jal  ra, q8_to_bf16
+        rdcycle a0
+        sub  a0, a0, s0
+        la   a1, q8_str_dequantize
+        jal  ra, q8_print_cycles
+    qbb_epilogue:
+        lw   ra, 0(sp)
+        lw   s0, 4(sp)
+        addi sp, sp, 8
+        ret
+
+
+# --- q8_print_cycles ---
+    # print "<name>: <cycles> cycles for Q8_N elements"
+    # input:
+    #   a0: cycles
+    #   a1: name (null-terminated string)
+    # output: nothing
+q8_print_cycles:
+    qpc_prologue:
+        addi sp, sp, -8
+        sw   ra, 0(sp)
+        sw   a0, 4(sp)
+    qpc_body:
+        mv   a0, a1
+        jal  ra, print_string
+        lw   a0, 4(sp)
+        jal  ra, print_int
+        la   a0, q8_str_cycles
+        jal  ra, print_string
+    qpc_epilogue:
+        lw   ra, 0(sp)
+        addi sp, sp, 8
+        ret
+
+
+# --- q8_memcmp ---
+    # compare two byte arrays
+    # input:
+    #   a0: p (pointer)
+    #   a1: q (pointer)
+    #   a2: n (u32): number of bytes
+    # output:
+    #   a0: 0 if identical; otherwise, 1
+q8_memcmp:
+    qmc_loop:
+        beqz a2, qmc_equal
+        lbu  t0, 0(a0)
+        lbu  t1, 0(a1)
+        bne  t0, t1, qmc_different
+        addi a0, a0, 1
+        addi a1, a1, 1
+        addi a2, a2, -1
+        j    qmc_loop
+    qmc_equal:
+        li   a0, 0
+        ret
+    qmc_different:
+        li   a0, 1
+        ret
+
+
+# ┌-------------------------------------------------------┐
+# |        Required Library - mul_shift_u32 v0.0.0        |
+# └-------------------------------------------------------┘
+
+# --- mul_shift_u32 ---
+    # binary multiplication of two u32 numbers
+    # input:
+    #   a0: a (u32): multiplier
+    #   a1: b (u32): multiplicand
+    # output:
+    #   a0: r (u32): product of a and b (a * b)
+mul_shift_u32:
+    mhu_prologue:
+        addi sp, sp, -4
+        sw   ra, 0(sp)
+        bge  a0, a1, mhu_no_swap
+        # make a1 <= a0
+        addi t0, a1, 0
+        mv   a1, a0
+        mv   a0, t0
+    mhu_no_swap:
+        # binary multiplication of t0 = a0 * a1
+        addi t0, zero, 0 # t0 = result
+    mhu_loop:
+        beq  a1, zero, mhu_epilogue
+        andi t2, a1, 1 # the least significant bit of a1
+        beq  t2, zero, mhu_next
+        add  t0, t0, a0
+    mhu_next:
+        slli a0, a0, 1
+        srli a1, a1, 1
+        j mhu_loop
+    mhu_epilogue:
+        mv   a0, t0
+        lw   ra, 0(sp)
+        addi sp, sp, 4
+        ret
+
+
+# ┌-------------------------------------------------------┐
+# |                        Library                        |
+# └-------------------------------------------------------┘
+
+.equ Q8_BLOCK, 32 # number of elements sharing one scale
+
+# --- div_u24 ---
+    # binary long division of a 24-bit number
+    # input:
+    #   a0: a (u32): dividend, a < 2^24
+    #   a1: b (u32): divisor, b != 0
+    # output:
+    #   a0: q (u32): quotient (a / b)
+    #   a1: r (u32): remainder (a % b)
+    # notes:
+    #   t0: q
+    #   t1: r
+    #   t2: index of the current bit of a
+div_u24:
+    du_prologue:
+        addi sp, sp, -4
+        sw   ra, 0(sp)
+        li   t0, 0
+        li   t1, 0
+        li   t2, 23
+    du_loop:
+        slli t1, t1, 1
+        srl  t3, a0, t2
+        andi t3, t3, 1
+        or   t1, t1, t3 # r = (r << 1) | bit
+        slli t0, t0, 1
+        bltu t1, a1, du_next
+        sub  t1, t1, a1
+        ori  t0, t0, 1
+    du_next:
+        addi t2, t2, -1
+        bgez t2, du_loop
+    du_epilogue:
+        mv   a0, t0
+        mv   a1, t1
+        lw   ra, 0(sp)
+        addi sp, sp, 4
+        ret
+
+
+# --- q8_scale ---
+    # compute the scale (absmax / 127) of a block
+    # input:
+    #   a0: amax (u32): largest (bf16 bits >> 16) & 0x7FFF of the block
+    # output:
+    #   a0: scale (bf16), or 0 if the block is quantized to 0
+    #   a1: inv (u32): round(2^23 / mantissa of scale)
+    # notes:
+    #   s0: es
+    #   s1: ms
+q8_scale:
+    q8s_prologue:
+        addi sp, sp, -12
+        sw   ra, 0(sp)
+        sw   s0, 4(sp)
+        sw   s1, 8(sp)
+    q8s_body:
+        srli t0, a0, 7      # em
+        andi t1, a0, 0x7F
+        ori  t1, t1, 0x80   # mm
+        li   t2, 7
+        blt  t2, t0, q8s_normal
+        # absmax < 2^-119
+        li   a0, 0
+        li   a1, 0
+        j    q8s_epilogue
+    q8s_normal:
+        addi s0, t0, -7     # es = em - 7
+        slli a0, t1, 16
+        li   a1, 127
+        jal  ra, div_u24    # qt = (mm << 16) / 127
+        li   t0, 0x20000
+        bltu a0, t0, q8s_round
+        srli a0, a0, 1      # mm / 127 >= 2.0
+        addi s0, s0, 1
+    q8s_round:
+        addi a0, a0, 0x100
+        srli s1, a0, 9      # ms = (qt + 0x100) >> 9
+        srli t0, s1, 1
+        li   a0, 0x800000
+        add  a0, a0, t0
+        mv   a1, s1
+        jal  ra, div_u24    # inv = (2^23 + ms / 2) / ms
+        mv   a1, a0
+        slli a0, s0, 23
+        andi t0, s1, 0x7F
+        slli t0, t0, 16
+        or   a0, a0, t0     # scale = (es << 23) | ((ms & 0x7F) << 16)
+    q8s_epilogue:
+        lw   ra, 0(sp)
+        lw   s0, 4(sp)
+        lw   s1, 8(sp)
+        addi sp, sp, 12
+        ret
+
+
+# --- q8_from_bf16 ---
+    # quantize one element
+    # input:
+    #   a0: x (bf16)
+    #   a1: scale (bf16): scale of the block (nonzero)
+    #   a2: inv (u32): from q8_scale
+    # output:
+    #   a0: q (i32): round(x / scale), in [-127, 127]
+    # notes:
+    #   s0: d
+    #   s1: sign of x
+q8_from_bf16:
+    q8f_prologue:
+        addi sp, sp, -12
+        sw   ra, 0(sp)
+        sw   s0, 4(sp)
+        sw   s1, 8(sp)
+    q8f_body:
+        srli t0, a0, 16
+        li   t1, 0x7FFF
+        and  t0, t0, t1     # a = (x >> 16) & 0x7FFF
+        srli t1, t0, 7      # ex
+        beqz t1, q8f_zero
+        srli t2, a1, 23
+        addi t2, t2, 23
+        sub  s0, t2, t1     # d = 23 + es - ex
+        li   t2, 24
+        blt  t2, s0, q8f_zero
+        sltz s1, a0
+        andi t0, t0, 0x7F
+        ori  a0, t0, 0x80   # mx
+        mv   a1, a2
+        jal  ra, mul_shift_u32 # a0 = mx * inv
+        addi t0, s0, -1
+        li   t1, 1
+        sll  t1, t1, t0
+        add  a0, a0, t1
+        srl  a0, a0, s0     # q = (mx * inv + (1 << (d - 1))) >> d
+        li   t0, 127
+        bgeu t0, a0, q8f_sign
+        mv   a0, t0         # saturate
+    q8f_sign:
+        beqz s1, q8f_epilogue
+        sub  a0, zero, a0
+        j    q8f_epilogue
+    q8f_zero:
+        li   a0, 0
+    q8f_epilogue:
+        lw   ra, 0(sp)
+        lw   s0, 4(sp)
+        lw   s1, 8(sp)
+        addi sp, sp, 12
+        ret
+
+
+# --- bf16_to_q8 ---
+    # quantize n bf16 numbers to q8, one block at a time
+    # input:
+    #   a0: x (bf16 *): n bf16 numbers
+    #   a1: q (i8 *): n 8-bit integers (output)
+    #   a2: scale (bf16 *): one scale per block (output)
+    #   a3: n (u32)
+    # output: nothing
+    # notes:
+    #   s0: x of the current block
+    #   s1: q of the current block
+    #   s2: scale of the current block
+    #   s3: number of remaining elements
+    #   s4: len, number of elements in the current block
+    #   s5: scale (bf16)
+    #   s6: inv
+    #   s7: j, index in the current block
+bf16_to_q8:
+    btq_prologue:
+        addi sp, sp, -36
+        sw   ra, 0(sp)
+        sw   s0, 4(sp)
+        sw   s1, 8(sp)
+        sw   s2, 12(sp)
+        sw   s3, 16(sp)
+        sw   s4, 20(sp)
+        sw   s5, 24(sp)
+        sw   s6, 28(sp)
+        sw   s7, 32(sp)
+        mv   s0, a0
+        mv   s1, a1
+        mv   s2, a2
+        mv   s3, a3
+    btq_block:
+        beqz s3, btq_epilogue
+        li   s4, Q8_BLOCK
+        bgeu s3, s4, btq_absmax
+        mv   s4, s3         # len = min(n, Q8_BLOCK)
+    btq_absmax:
+        li   t0, 0          # amax
+        mv   t1, s0
+        slli t2, s4, 2
+        add  t2, t2, s0     # end of the block
+        li   t4, 0x7FFF
+    btq_absmax_loop:
+        lw   t3, 0(t1)
+        srli t3, t3, 16
+        and  t3, t3, t4
+        bgeu t0, t3, btq_absmax_next
+        mv   t0, t3
+    btq_absmax_next:
+        addi t1, t1, 4
+        bne  t1, t2, btq_absmax_loop
+        mv   a0, t0
+        jal  ra, q8_scale
+        mv   s5, a0
+        mv   s6, a1
+        sw   s5, 0(s2)
+        li   s7, 0
+    btq_element:
+        li   a0, 0
+        beqz s5, btq_store  # scale 0: q = 0
+        slli t0, s7, 2
+        add  t0, t0, s0
+        lw   a0, 0(t0)
+        mv   a1, s5
+        mv   a2, s6
+        jal  ra, q8_from_bf16
+    btq_store:
+        add  t0, s1, s7
+        sb   a0, 0(t0)
+        addi s7, s7, 1
+        bne  s7, s4, btq_element
+        # next block
+        addi s0, s0, Q8_BLOCK * 4
+        addi s1, s1, Q8_BLOCK
+        addi s2, s2, 4
+        sub  s3, s3, s4
+        j    btq_block
+    btq_epilogue:
+        lw   ra, 0(sp)
+        lw   s0, 4(sp)
+        lw   s1, 8(sp)
+        lw   s2, 12(sp)
+        lw   s3, 16(sp)
+        lw   s4, 20(sp)
+        lw   s5, 24(sp)
+        lw   s6, 28(sp)
+        lw   s7, 32(sp)
+        addi sp, sp, 36
+        ret
+
+
+# --- q8_to_bf16_1 ---
+    # dequantize one element
+    # input:
+    #   a0: q (i32): in [-127, 127]
+    #   a1: scale (bf16)
+    # output:
+    #   a0: r (bf16): q * scale, rounded to nearest (ties to even)
+    # notes:
+    #   s0: s
+    #   s1: e
+    #   t0: k
+    #   t2: m
+q8_to_bf16_1:
+    q8t_prologue:
+        addi sp, sp, -12
+        sw   ra, 0(sp)
+        sw   s0, 4(sp)
+        sw   s1, 8(sp)
+    q8t_body:
+        srli s1, a1, 23
+        andi s1, s1, 0xFF   # es
+        li   t1, 0x80000000
+        and  s0, a1, t1     # sign of scale
+        bgez a0, q8t_positive_q
+        xor  s0, s0, t1
+        sub  a0, zero, a0   # mq = -q
+    q8t_positive_q:
+        beqz a0, q8t_epilogue_zero
+        beqz s1, q8t_epilogue_zero
+        srli t0, a1, 16
+        andi t0, t0, 0x7F
+        ori  a1, t0, 0x80   # ms
+        jal  ra, mul_shift_u32 # p = mq * ms
+        # normalization: make 0x80 <= m < 0x100
+        li   t0, 0
+        li   t1, 0x100
+    q8t_normalize:
+        srl  t2, a0, t0
+        bltu t2, t1, q8t_round
+        addi t0, t0, 1
+        j    q8t_normalize
+    q8t_round:
+        add  s1, s1, t0     # e = es + k
+        beqz t0, q8t_pack
+        li   t3, 1
+        sll  t3, t3, t0
+        addi t3, t3, -1
+        and  t3, a0, t3     # rem = p & ((1 << k) - 1)
+        addi t4, t0, -1
+        li   t5, 1
+        sll  t4, t5, t4     # half = 1 << (k - 1)
+        bltu t4, t3, q8t_round_up
+        bne  t3, t4, q8t_pack
+        andi t5, t2, 1      # tie: round to even
+        beqz t5, q8t_pack
+    q8t_round_up:
+        addi t2, t2, 1
+        li   t5, 0x100
+        bne  t2, t5, q8t_pack
+        li   t2, 0x80
+        addi s1, s1, 1
+    q8t_pack:
+        li   t5, 0xFF
+        bltu s1, t5, q8t_finite
+        li   t0, 0x7F800000 # overflow: inf
+        or   a0, s0, t0
+        j    q8t_epilogue
+    q8t_finite:
+        slli s1, s1, 23
+        andi t2, t2, 0x7F
+        slli t2, t2, 16
+        or   a0, s0, s1
+        or   a0, a0, t2     # r = s | e | m
+        j    q8t_epilogue
+    q8t_epilogue_zero:
+        mv   a0, s0         # +-0
+    q8t_epilogue:
+        lw   ra, 0(sp)
+        lw   s0, 4(sp)
+        lw   s1, 8(sp)
+        addi sp, sp, 12
+        ret
+
+
+# --- q8_to_bf16 ---
+    # dequantize n q8 numbers to bf16
+    # input:
+    #   a0: q (i8 *): n 8-bit integers
+    #   a1: scale (bf16 *): one scale per block
+    #   a2: x (bf16 *): n bf16 numbers (output)
+    #   a3: n (u32)
+    # output: nothing
+    # notes:
+    #   s0: q
+    #   s1: scale
+    #   s2: x
+    #   s3: number of remaining elements
+    #   s4: index in the current block
+q8_to_bf16:
+    qtb_prologue:
+        addi sp, sp, -24
+        sw   ra, 0(sp)
+        sw   s0, 4(sp)
+        sw   s1, 8(sp)
+        sw   s2, 12(sp)
+        sw   s3, 16(sp)
+        sw   s4, 20(sp)
+        mv   s0, a0
+        mv   s1, a1
+        mv   s2, a2
+        mv   s3, a3
+        li   s4, 0
+    qtb_loop:
+        beqz s3, qtb_epilogue
+        lb   a0, 0(s0)
+        lw   a1, 0(s1)
+        jal  ra, q8_to_bf16_1
+        sw   a0, 0(s2)
+        addi s0, s0, 1
+        addi s2, s2, 4
+        addi s3, s3, -1
+        addi s4, s4, 1
+        li   t0, Q8_BLOCK
+        bne  s4, t0, qtb_loop
+        li   s4, 0          # next block
+        addi s1, s1, 4
+        j    qtb_loop
+    qtb_epilogue:
+        lw   ra, 0(sp)
+        lw   s0, 4(sp)
+        lw   s1, 8(sp)
+        lw   s2, 12(sp)
+        lw   s3, 16(sp)
+        lw   s4, 20(sp)
+        addi sp, sp, 24
+        ret
+
+
+# ┌-------------------------------------------------------┐
+# |                   Testing Suite Data                  |
+# └-------------------------------------------------------┘
+
+.data
+
+q8_str_quantize:
+    .string "bf16_to_q8: "
+q8_str_dequantize:
+    .string "q8_to_bf16: "
+q8_str_cycles:
+    .string " cycles for 35 elements\n"
+
+.align 2
+q8_x:
+    .word 0x40000000, 0x3F800000, 0xBF000000, 0x3C000000
+    .word 0xBC810000, 0xBFDF0000, 0xC0620000, 0xC0070000
+    .word 0xBE1C0000, 0x00000000, 0xBE930000, 0x3FBB0000
+    .word 0xBFDB0000, 0x3E170000, 0xBE8A0000, 0xBF060000
+    .word 0xBE1B0000, 0xBE0F0000, 0x3F890000, 0xBF590000
+    .word 0x3E210000, 0x40250000, 0x3FC90000, 0x3E0C0000
+    .word 0x3FD90000, 0x3F170000, 0xBEA90000, 0x40280000
+    .word 0x3F650000, 0xC0180000, 0x3F120000, 0xBE1E0000
+    .word 0x3EC90000, 0xC2FE0000, 0x3E230000
+q8_s_ans:
+    .word 0x3CE40000, 0x3F800000
+q8_y_ans:
+    .word 0x40000000, 0x3F800000, 0xBF000000, 0x00000000
+    .word 0xBCE40000, 0xBFE00000, 0xC0620000, 0xC0070000
+    .word 0xBE0E0000, 0x00000000, 0xBE8E0000, 0x3FB90000
+    .word 0xBFD90000, 0x3E0E0000, 0xBE8E0000, 0xBF070000
+    .word 0xBE0E0000, 0xBE0E0000, 0x3F870000, 0xBF560000
+    .word 0x3E2B0000, 0x40260000, 0x3FC80000, 0x3E0E0000
+    .word 0x3FD90000, 0x3F160000, 0xBEAB0000, 0x40270000
+    .word 0x3F640000, 0xC0170000, 0x3F0E0000, 0xBE2B0000
+    .word 0x00000000, 0xC2FE0000, 0x00000000
+q8_q_ans:
+    .byte 72, 36, -18, 0, -1, -63, -127, -76
+    .byte -5, 0, -10, 52, -61, 5, -10, -19
+    .byte -5, -5, 38, -30, 6, 93, 56, 5
+    .byte 61, 21, -12, 94, 32, -85, 20, -6
+    .byte 0, -127, 0
+
+.align 2
+q8_s:
+    .space 8
+q8_y:
+    .space Q8_N * 4
+q8_q:
+    .space Q8_N
@@ -0,0 +1,572 @@
+# This program implements and tests reciprocal square root of bf16
+# numbers, with an initial guess from the bits of x and one Newton step.
+#
+# For including as a library, include only codes in…
+# (1) all of the "Required Library" sections, and
+# (2) the "Library" section.
+#
+# Library dependency graph:
+#                    add_sub_bf16 ↘
+#   mul_shift_u32 -> mul_bf16 ----> **rsqrt_bf16**
+#
+# Version: 0.0.0
+# Tested: 2026-10-18T17:50:00+08:00
+#
+# reference: ../src/rsqrt_bf16.c
+
+.text
+
+# ┌-------------------------------------------------------┐
+# |                     Testing Suite                     |
+# └-------------------------------------------------------┘
+
+.equ RSB_N, 256 # all the bf16 numbers in [1, 4)
+
+.globl main
+main:
+    # test all functionalities
+    jal  ra, rsqrt_bf16_test
+    # returns a0 = 0 for success, or non-zero for index of failed test
+
+    # print result
+    jal ra, print_int
+    li a0, '\n'
+    jal ra, print_char
+
+    # print the number of cycles of rsqrt_bf16
+    jal ra, rsqrt_bf16_bench
+
+    # exit program
+    li a0, 0
+    j exit
+
+
+# --- rsqrt_bf16_test ---
+    # test the functionalities of rsqrt_bf16
+    # input: nothing
+    # output:
+    #   a0: error_code: 0 for success
+    #                   otherwise, index of the first failed test
+    # notes:
+    #   the answers are generated by the C program, for the
+    #   results of both should be identical
+    #   s0: x
+    #   s1: pointer to the answer of x
+rsqrt_bf16_test:
+    rsbt_prologue:
+        addi sp, sp, -12
+        sw   ra, 0(sp)
+        sw   s0, 4(sp)
+        sw   s1, 8(sp)
+    rsbt_t1:
+        li   a0, 0x3F800000 # 1.0
+        jal  ra, rsqrt_bf16
+        li   t0, 0x3F800000 # 1.0
+        li   t1, 1 # error code
+        bne  t0, a0, rsbt_epilogue
+    rsbt_t2:
+        li   a0, 0x40800000 # 4.0
+        jal  ra, rsqrt_bf16
+        li   t0, 0x3F000000 # 0.5
+        li   t1, 2 # error code
+        bne  t0, a0, rsbt_epilogue
+    rsbt_t3:
+        li   a0, 0x40000000 # 2.0
+        jal  ra, rsqrt_bf16
+        li   t0, 0x3F350000 # 0.707
+        li   t1, 3 # error code
+        bne  t0, a0, rsbt_epilogue
+    rsbt_t4:
+        li   a0, 0x42C80000 # 100.0
+        jal  ra, rsqrt_bf16
+        li   t0, 0x3DCD0000 # 0.1001
+        li   t1, 4 # error code
+        bne  t0, a0, rsbt_epilogue
+    rsbt_t5:
+        li   a0, 0x80000000 # -0.0
+        jal  ra, rsqrt_bf16
+        li   t0, 0x7F800000 # +inf
+        li   t1, 5 # error code
+        bne  t0, a0, rsbt_epilogue
+        li   a0, 0xBF800000 # -1.0
+        jal  ra, rsqrt_bf16
+        li   t0, 0x7FC00000 # NaN
+        bne  t0, a0, rsbt_epilogue
+    rsbt_t6:
+        # all the RSB_N numbers in [1, 4), which cover all the mantissas
+        # and both parities of the exponent; rsqrt_bf16(4 * x) is exactly
+        # rsqrt_bf16(x) / 2 for the other normal numbers
+        li   s0, 0x3F800000
+        la   s1, rsb_y_ans
+    rsbt_t6_loop:
+        mv   a0, s0
+        jal  ra, rsqrt_bf16
+        lw   t0, 0(s1)
+        li   t1, 6 # error code
+        bne  t0, a0, rsbt_epilogue
+        li   t0, 0x10000
+        add  s0, s0, t0
+        addi s1, s1, 4
+        li   t0, 0x40800000
+        bne  s0, t0, rsbt_t6_loop
+    rsbt_all_passed:
+        li   t1, 0
+    rsbt_epilogue:
+        mv   a0, t1 # error code
+        lw   ra, 0(sp)
+        lw   s0, 4(sp)
+        lw   s1, 8(sp)
+        addi sp, sp, 12
+        ret
+
+
+# --- rsqrt_bf16_bench ---
+    # print the number of cycles of rsqrt_bf16 for the RSB_N numbers
+    # of test 6
+    # input: nothing
+    # output: nothing
+    # notes:
+    #   s0: x
+    #   s1: cycle counter at the beginning
+rsqrt_bf16_bench:
+    rsbb_prologue:
+        addi sp, sp, -12
+        sw   ra, 0(sp)
+        sw   s0, 4(sp)
+        sw   s1, 8(sp)
+    rsbb_body:
+        li   s0, 0x3F800000
+        rdcycle s1
+    rsbb_loop:
+        mv   a0, s0
+        jal  ra, rsqrt_bf16
+        li   t0, 0x10000
+        add  s0, s0, t0
+        li   t0, 0x40800000
+        bne  s0, t0, rsbb_loop
+        rdcycle s0
+        sub  s0, s0, s1
+        la   a0, rsb_str_rsqrt_bf16
+        jal  ra, print_string
+        mv   a0, s0
+        jal  ra, print_int
+        la   a0, rsb_str_cycles
+        jal  ra, print_string
+    rsbb_epilogue:
+        lw   ra, 0(sp)
+        lw   s0, 4(sp)
+        lw   s1, 8(sp)
+        addi sp, sp, 12
+        ret
+
+
+# ┌-------------------------------------------------------┐
+# |         Required Library - add_sub_bf16 v0.1.1        |
+# └-------------------------------------------------------┘
+
+# --- add_sub_bf16 ---
+    # addition or subtraction of two bf16 numbers
+    # input:
+    #   a0: a (bf16): add/sub candidate
+    #   a1: b (bf16): add/sub candidate
+    #   a2: to_add (int): 1 for addition; 0 for subtraction
+    # output:
+    #   a0: r (bf16): result of (a + b) or (a - b)
+    # notes:
+    #   t0: sa, s
+    #   t1: sb
+    #   t2: ea, e
+    #   t3: eb
+    #   t4: ma, m
+    #   t5: mb
+    #   t6: (always temp)
+add_sub_bf16:
+    asb_prologue:
+        addi sp, sp, -4
+        sw   ra, 0(sp)
+    asb_body:
+        # extract expoent and mantissa from a and b
+        li   t6, 0x7F800000
+        and  t2, a0, t6 # ea
+        srli t2, t2, 23
+        addi t2, t2, -127
+        li   t6, 0x7F800000
+        and  t3, a1, t6 # eb
+        srli t3, t3, 23
+        addi t3, t3, -127
+        li   t6, 0x007F0000
+        and  t4, a0, t6 # ma
+        srli t4, t4, 16
+        ori  t4, t4, 0x80
+        li   t6, 0x007F0000
+        and  t5, a1, t6 # mb
+        srli t5, t5, 16
+        ori  t5, t5, 0x80
+
+        # normalization: make 2 numbers have the same exponent
+        blt  t2, t3, asb_normalization_1
+        mv   t6, t2      # t6 = ea
+        sub  t2, t2, t3 # t2 = ea - eb
+        li   t0, 8
+        bge  t0, t2, asb_clamp_b
+        li   t2, 8       # mb >> 8 is already 0; srl only uses 5 bits
+    asb_clamp_b:
+        srl  t5, t5, t2 # mb >>= t2
+        mv   t2, t6      # e = t6
+        j    asb_normalization_end
+    asb_normalization_1:
+        mv   t6, t3      # t6 = eb
+        sub  t2, t3, t2 # t2 = ea - eb
+        li   t0, 8
+        bge  t0, t2, asb_clamp_a
+        li   t2, 8       # ma >> 8 is already 0; srl only uses 5 bits
+    asb_clamp_a:
+        srl  t4, t4, t2 # ma >>= t2
+        mv   t2, t6      # e = t6
+    asb_normalization_end:
+        # addition or subtraction
+        li   t6, 0x80000000
+        and  t0, a0, t6 # sa
+        beqz t0, asb_not_invert_ma
+        sub  t4, zero, t4
+    asb_not_invert_ma:
+        li   t6, 0x80000000
+        and  t1, a1, t6 # sb
+        beqz t1, asb_not_invert_mb_1
+        sub  t5, zero, t5
+    asb_not_invert_mb_1:
+        bnez a2, asb_not_invert_mb_2
+        sub  t5, zero, t5
+    asb_not_invert_mb_2:
+        add  t4, t4, t5 # m = ma + mb
+        # handle negative result
+        li   t0, 0
+        bgez t4, asb_positive_m
+        sub  t4, zero, t4
+        li   t0, 1
+    asb_positive_m:
+        # handle carry bit
+        andi t5, t4, 0x100
+        beqz t5, asb_no_carry
+        srli t4, t4, 1
+        addi t2, t2, 1
+    asb_no_carry:
+        # handle result of 0
+        li   t5, 0x80
+        bnez t4, asb_small
+        li   t2, -127     # e = -127
+        j    asb_small_end
+    asb_small:
+        bge  t4, t5, asb_small_end # while (m < 0x80)
+        addi t2, t2, -1 # e -= 1
+        slli t4, t4, 1  # m <<= 1
+        j    asb_small
+    asb_small_end:
+        # construct the result
+        slli t0, t0, 31   # s = s << 31
+        addi t2, t2, 127  # e = (e + 127) << 23
+        slli t2, t2, 23
+        andi t4, t4, 0x7F # m = (m & 0x7F) << 16
+        slli t4, t4, 16
+        or   a0, t0, t2   # r = s | e | m
+        or   a0, a0, t4
+    asb_epilogue:
+        lw   ra, 0(sp)
+        addi sp, sp, 4
+        ret
+
+
+# --- add_bf16 ---
+    # addition of two bf16 numbers.
+    # input:
+    #   a0: a (bf16): addition candidate
+    #   a1: b (bf16): addition candidate
+    # output:
+    #   a0: r (bf16): reslut of (a + b)
+add_bf16:
+        addi sp, sp, -4
+        sw   ra, 0(sp)
+        li   a2, 1
+        jal  ra, add_sub_bf16
+        lw   ra, 0(sp)
+        addi sp, sp, 4
+        ret
+
+
+# --- sub_bf16 ---
+    # subtraction of two bf16 numbers.
+    # input:
+    #   a0: a (bf16): subtraction candidate
+    #   a1: b (bf16): subtraction candidate
+    # output:
+    #   a0: r (bf16): reslut of (a - b)
+sub_bf16:
+        addi sp, sp, -4
+        sw   ra, 0(sp)
+        li   a2, 0
+        jal  ra, add_sub_bf16
+        lw   ra, 0(sp)
+        addi sp, sp, 4
+        ret
+
+
+# ┌-------------------------------------------------------┐
+# |        Required Library - mul_shift_u32 v0.0.0        |
+# └-------------------------------------------------------┘
+
+# --- mul_shift_u32 ---
+    # binary multiplication of two u32 numbers
+    # input:
+    #   a0: a (u32): multiplier
+    #   a1: b (u32): multiplicand
+    # output:
+    #   a0: r (u32): product of a and b (a * b)
+mul_shift_u32:
+    mhu_prologue:
+        addi sp, sp, -4
+        sw   ra, 0(sp)
+        bge  a0, a1, mhu_no_swap
+        # make a1 <= a0
+        addi t0, a1, 0
+        mv   a1, a0
+        mv   a0, t0
+    mhu_no_swap:
+        # binary multiplication of t0 = a0 * a1
+        addi t0, zero, 0 # t0 = result
+    mhu_loop:
+        beq  a1, zero, mhu_epilogue
+        andi t2, a1, 1 # the least significant bit of a1
+        beq  t2, zero, mhu_next
+        add  t0, t0, a0
+    mhu_next:
+        slli a0, a0, 1
+        srli a1, a1, 1
+        j mhu_loop
+    mhu_epilogue:
+        mv   a0, t0
+        lw   ra, 0(sp)
+        addi sp, sp, 4
+        ret
+
+
+# ┌-------------------------------------------------------┐
+# |           Required Library - mul_bf16 v0.1.0          |
+# └-------------------------------------------------------┘
+
+# --- mul_bf16 ---
+    # multiplication of two bf16 numbers
+    # input:
+    #   a0: a (bf16): multiplier
+    #   a1: b (bf16): multiplicand
+    # output:
+    #   a0: m, r (bf16): product of a and b (a * b)
+    # notes:
+    #   s0: s
+    #   s1: e
+    #   t0: sa
+    #   t1: sb
+    #   t2: ea
+    #   t3: eb
+    #   t4: ma
+    #   t5: mb
+mul_bf16:
+    mb_prologue:
+        addi sp, sp, -12
+        sw   ra, 0(sp)
+        sw   s0, 4(sp)
+        sw   s1, 8(sp)
+    mb_body:
+        beqz a0, mb_epilogue
+        bnez a1, mb_nonzero_input
+        mv   a0, zero
+        j    mb_epilogue
+    mb_nonzero_input:
+        # extract sign, exponent and mantissa of a and b
+        sltz t0, a0 # sa
+        sltz t1, a1 # sb
+        li   t3, 0x7F800000
+        and  t2, a0, t3
+        srli t2, t2, 23
+        addi t2, t2, -127 # ea
+        and  t3, a1, t3
+        srli t3, t3, 23
+        addi t3, t3, -127 # eb
+        li   t5, 0x007F0000
+        and  t4, a0, t5
+        srli t4, t4, 16
+        ori  t4, t4, 0x80 # ma
+        and  t5, a1, t5
+        srli t5, t5, 16
+        ori  t5, t5, 0x80 # mb
+        # calculate the initial result
+        xor  s0, t0, t1 # s = sa ^ sb
+        add  s1, t2, t3 # e = ea + eb
+        mv   a0, t4
+        mv   a1, t5
+        jal  ra, mul_shift_u32
+        srli a0, a0, 7  # m = (ma * mb) >> 7
+        # handle carry bit
+        andi t1, a0, 0x100
+        beqz t1, mb_no_carry
+        srli a0, a0, 1
+        addi s1, s1, 1
+    mb_no_carry:
+        # handle result of +-0
+        bnez a0, mb_nonzero_result
+        slli a0, s0, 31   # r = s << 31
+        j    mb_epilogue
+    mb_nonzero_result:
+        # construct the result
+        slli s0, s0, 31   # s = s << 31
+        addi s1, s1, 127
+        slli s1, s1, 23   # e = (e + 127) << 23
+        andi a0, a0, 0x7F
+        slli a0, a0, 16   # m = (m & 0x7F) << 16
+        or   a0, a0, s0
+        or   a0, a0, s1   # r = s | e | m
+    mb_epilogue:
+        lw   ra, 0(sp)
+        lw   s0, 4(sp)
+        lw   s1, 8(sp)
+        addi sp, sp, 12
+        ret
+
+
+# ┌-------------------------------------------------------┐
+# |                        Library                        |
+# └-------------------------------------------------------┘
+
+# --- rsqrt_bf16 ---
+    # reciprocal square root of a bf16 number
+    # input:
+    #   a0: x (bf16)
+    # output:
+    #   a0: r (bf16): 1 / sqrt(x), within 2 ulp for x > 0;
+    #       +inf for +-0, 0 for +inf, and NaN for x < 0 and NaN
+    # notes:
+    #   s0: y, the initial guess
+rsqrt_bf16:
+    rsb_prologue:
+        addi sp, sp, -8
+        sw   ra, 0(sp)
+        sw   s0, 4(sp)
+    rsb_body:
+        # remove extra bits and catch the special cases
+        li   t0, 0xFFFF0000
+        and  a0, a0, t0
+        slli t1, a0, 1
+        bnez t1, rsb_nonzero
+        li   a0, 0x7F800000 # +inf
+        j    rsb_epilogue
+    rsb_nonzero:
+        li   t0, 0x7F800000
+        bne  a0, t0, rsb_finite
+        li   a0, 0          # 0
+        j    rsb_epilogue
+    rsb_finite:
+        bgeu t0, a0, rsb_positive
+        li   a0, 0x7FC00000 # NaN
+        j    rsb_epilogue
+    rsb_positive:
+        # initial guess: y = (0x5F310000 - (x >> 1)) & 0xFFFF0000
+        srli t1, a0, 1
+        li   t0, 0x5F310000
+        sub  t1, t0, t1
+        li   t0, 0xFFFF0000
+        and  s0, t1, t0
+        # one Newton step: y = y * (1.5 - 0.5 * t), where t = x * y * y
+        mv   a1, s0
+        jal  ra, mul_bf16 # x * y
+        mv   a1, s0
+        jal  ra, mul_bf16 # t = x * y * y, which is about 1
+        li   t0, 0x00800000
+        sub  a1, a0, t0   # 0.5 * t
+        li   a0, 0x3FC00000
+        jal  ra, sub_bf16 # 1.5 - 0.5 * t
+        mv   a1, s0
+        jal  ra, mul_bf16
+    rsb_epilogue:
+        lw   ra, 0(sp)
+        lw   s0, 4(sp)
+        addi sp, sp, 8
+        ret
+
+
+# ┌-------------------------------------------------------┐
+# |                   Testing Suite Data                  |
+# └-------------------------------------------------------┘
+
+.data
+
+rsb_str_rsqrt_bf16:
+    .string "rsqrt_bf16: "
+rsb_str_cycles:
+    .string " cycles for 256 elements\n"
+
+.align 2
+# rsqrt_bf16(x) for x = 1.0, 1.0078, ..., 3.9844 (from the C program)
+rsb_y_ans:
+    .word 0x3F800000, 0x3F7F0000, 0x3F7F0000, 0x3F7D0000
+    .word 0x3F7C0000, 0x3F7B0000, 0x3F7B0000, 0x3F790000
+    .word 0x3F780000, 0x3F770000, 0x3F770000, 0x3F760000
+    .word 0x3F760000, 0x3F740000, 0x3F740000, 0x3F720000
+    .word 0x3F720000, 0x3F710000, 0x3F710000, 0x3F700000
+    .word 0x3F6E0000, 0x3F6E0000, 0x3F6D0000, 0x3F6C0000
+    .word 0x3F6C0000, 0x3F6B0000, 0x3F690000, 0x3F6A0000
+    .word 0x3F680000, 0x3F690000, 0x3F670000, 0x3F660000
+    .word 0x3F660000, 0x3F650000, 0x3F650000, 0x3F640000
+    .word 0x3F640000, 0x3F610000, 0x3F610000, 0x3F600000
+    .word 0x3F600000, 0x3F5F0000, 0x3F5F0000, 0x3F5E0000
+    .word 0x3F5E0000, 0x3F5D0000, 0x3F5B0000, 0x3F5C0000
+    .word 0x3F5A0000, 0x3F5B0000, 0x3F590000, 0x3F5A0000
+    .word 0x3F580000, 0x3F570000, 0x3F570000, 0x3F560000
+    .word 0x3F560000, 0x3F550000, 0x3F550000, 0x3F540000
+    .word 0x3F540000, 0x3F530000, 0x3F530000, 0x3F520000
+    .word 0x3F520000, 0x3F510000, 0x3F510000, 0x3F500000
+    .word 0x3F500000, 0x3F4F0000, 0x3F4F0000, 0x3F4E0000
+    .word 0x3F4D0000, 0x3F4D0000, 0x3F4D0000, 0x3F4C0000
+    .word 0x3F4C0000, 0x3F4B0000, 0x3F4B0000, 0x3F4A0000
+    .word 0x3F4A0000, 0x3F490000, 0x3F480000, 0x3F480000
+    .word 0x3F480000, 0x3F470000, 0x3F470000, 0x3F460000
+    .word 0x3F460000, 0x3F450000, 0x3F450000, 0x3F440000
+    .word 0x3F440000, 0x3F430000, 0x3F430000, 0x3F420000
+    .word 0x3F420000, 0x3F410000, 0x3F410000, 0x3F400000
+    .word 0x3F400000, 0x3F400000, 0x3F3F0000, 0x3F3F0000
+    .word 0x3F3E0000, 0x3F3E0000, 0x3F3E0000, 0x3F3D0000
+    .word 0x3F3D0000, 0x3F3C0000, 0x3F3C0000, 0x3F3B0000
+    .word 0x3F3B0000, 0x3F3A0000, 0x3F3A0000, 0x3F3B0000
+    .word 0x3F390000, 0x3F3A0000, 0x3F3A0000, 0x3F390000
+    .word 0x3F390000, 0x3F380000, 0x3F380000, 0x3F370000
+    .word 0x3F370000, 0x3F370000, 0x3F360000, 0x3F360000
+    .word 0x3F350000, 0x3F350000, 0x3F340000, 0x3F330000
+    .word 0x3F330000, 0x3F320000, 0x3F320000, 0x3F310000
+    .word 0x3F310000, 0x3F300000, 0x3F2E0000, 0x3F2F0000
+    .word 0x3F2D0000, 0x3F2C0000, 0x3F2C0000, 0x3F2B0000
+    .word 0x3F2B0000, 0x3F2A0000, 0x3F2A0000, 0x3F290000
+    .word 0x3F290000, 0x3F280000, 0x3F280000, 0x3F270000
+    .word 0x3F270000, 0x3F260000, 0x3F250000, 0x3F250000
+    .word 0x3F240000, 0x3F240000, 0x3F240000, 0x3F230000
+    .word 0x3F220000, 0x3F220000, 0x3F210000, 0x3F210000
+    .word 0x3F200000, 0x3F200000, 0x3F200000, 0x3F1F0000
+    .word 0x3F1E0000, 0x3F1E0000, 0x3F1D0000, 0x3F1D0000
+    .word 0x3F1D0000, 0x3F1C0000, 0x3F1C0000, 0x3F1B0000
+    .word 0x3F1B0000, 0x3F1A0000, 0x3F1A0000, 0x3F190000
+    .word 0x3F190000, 0x3F180000, 0x3F180000, 0x3F180000
+    .word 0x3F170000, 0x3F170000, 0x3F160000, 0x3F160000
+    .word 0x3F160000, 0x3F150000, 0x3F150000, 0x3F140000
+    .word 0x3F140000, 0x3F130000, 0x3F130000, 0x3F130000
+    .word 0x3F130000, 0x3F120000, 0x3F120000, 0x3F110000
+    .word 0x3F110000, 0x3F110000, 0x3F100000, 0x3F100000
+    .word 0x3F100000, 0x3F0F0000, 0x3F0F0000, 0x3F0E0000
+    .word 0x3F0E0000, 0x3F0E0000, 0x3F0D0000, 0x3F0D0000
+    .word 0x3F0D0000, 0x3F0C0000, 0x3F0C0000, 0x3F0C0000
+    .word 0x3F0B0000, 0x3F0B0000, 0x3F0B0000, 0x3F0A0000
+    .word 0x3F0A0000, 0x3F0A0000, 0x3F090000, 0x3F090000
+    .word 0x3F090000, 0x3F080000, 0x3F080000, 0x3F070000
+    .word 0x3F070000, 0x3F060000, 0x3F060000, 0x3F060000
+    .word 0x3F060000, 0x3F050000, 0x3F050000, 0x3F050000
+    .word 0x3F050000, 0x3F040000, 0x3F040000, 0x3F040000
+    .word 0x3F040000, 0x3F030000, 0x3F030000, 0x3F030000
+    .word 0x3F030000, 0x3F020000, 0x3F020000, 0x3F020000
+    .word 0x3F020000, 0x3F010000, 0x3F010000, 0x3F010000
+    .word 0x3F010000, 0x3F000000, 0x3F000000, 0x3F000000
@@ -0,0 +1,119 @@
+# This program implements the system calls and printing functions of
+# syscall.c in RV32I, for hosts without a RISC-V C compiler: the
+# programs in this directory are assembled together with this file by
+# llvm-mc and run by sim/rv32sim (see `make LLVM=1`).
+#
+# Version: 0.0.0
+# Tested: 2026-10-18T20:10:00+08:00
+
+.text
+
+# ┌-------------------------------------------------------┐
+# |                        Library                        |
+# └-------------------------------------------------------┘
+
+# --- write ---
+    # input:
+    #   a0: file descriptor
+    #   a1: address of the buffer
+    #   a2: number of bytes
+    # output:
+    #   a0: 0, like write of syscall.c (the callers exit with it)
+write:
+    li   a7, 64                 # SYS_WRITE
+    ecall
+    li   a0, 0
+    ret
+
+# --- exit ---
+    # input:
+    #   a0: exit status
+exit:
+    li   a7, 93                 # SYS_EXIT
+    ecall
+    ret
+
+# --- print_char ---
+    # input:
+    #   a0: a character
+print_char:
+    addi sp, sp, -16
+    sw   ra, 12(sp)
+    sb   a0, 0(sp)
+    mv   a1, sp
+    li   a0, 1                  # STDOUT_FILENO
+    li   a2, 1
+    jal  ra, write
+    lw   ra, 12(sp)
+    addi sp, sp, 16
+    ret
+
+# --- print_string ---
+    # input:
+    #   a0: address of a null-terminated string
+print_string:
+    mv   a1, a0
+    li   a2, 0
+    ps_length:
+        add  t0, a1, a2
+        lbu  t0, 0(t0)
+        beqz t0, ps_write
+        addi a2, a2, 1
+        j    ps_length
+    ps_write:
+        li   a0, 1              # STDOUT_FILENO
+        j    write
+
+# --- print_int ---
+    # print a signed integer in decimal
+    # input:
+    #   a0: an integer
+    # note:
+    #   the digits are pushed to a 12-byte stack from its end;
+    #   division by 10 is done bit by bit (restoring division).
+print_int:
+    addi sp, sp, -32
+    sw   ra, 28(sp)
+    sw   s0, 24(sp)
+    sw   s1, 20(sp)
+    addi s0, sp, 12             # s0 = end of the digits
+    mv   s1, a0                 # s1 = the integer, for its sign
+    bgez a0, pi_digit
+    neg  a0, a0
+    pi_digit:
+        li   t0, 0              # t0 = a0 / 10
+        li   t1, 0              # t1 = a0 % 10
+        li   t2, 31             # t2 = bit index
+        li   t4, 10
+    pi_divide:
+        slli t1, t1, 1
+        srl  t3, a0, t2
+        andi t3, t3, 1
+        or   t1, t1, t3
+        slli t0, t0, 1
+        bltu t1, t4, pi_next_bit
+        sub  t1, t1, t4
+        ori  t0, t0, 1
+    pi_next_bit:
+        addi t2, t2, -1
+        bgez t2, pi_divide
+        addi s0, s0, -1
+        addi t1, t1, '0'
+        sb   t1, 0(s0)
+        mv   a0, t0
+        bnez a0, pi_digit
+        bgez s1, pi_write
+        addi s0, s0, -1
+        li   t1, '-'
+        sb   t1, 0(s0)
+    pi_write:
+        li   a0, 1              # STDOUT_FILENO
+        mv   a1, s0
+        addi a2, sp, 12
+        sub  a2, a2, s0
+        jal  ra, write
+        lw   ra, 28(sp)
+        lw   s0, 24(sp)
+        lw   s1, 20(sp)
+        addi sp, sp, 32
+        ret
@@ -0,0 +1,380 @@
+/*
+ * This program implements the following functionality:
+ *   Microbenchmarks of the bf16 functions in src/ on the host.
+ *
+ * Every function is measured in two modes:
+ * (1) latency: each call depends on the result of the previous call,
+ *     so the calls cannot overlap;
+ * (2) throughput: the calls work on independent elements of an array.
+ *
+ * The process is pinned to one core. Cycles, instructions and branch
+ * misses are read through perf_event_open(2) when the kernel allows it;
+ * otherwise only the wall-clock time from clock_gettime(2) is reported.
+ * Every measurement is repeated, and the run with the lowest time is
+ * kept. The results are written as JSON, one result per line, so that
+ * the results of two commits can be compared with diff.
+ *
+ * Usage: bench_bf16 [-o FILE] [-c CPU] [-n ELEMENTS] [-r REPEATS] [NAME...]
+ *   -o FILE      write the JSON to FILE instead of stdout
+ *   -c CPU       pin to CPU (default: the CPU it starts on)
+ *   -n ELEMENTS  number of calls per measurement (default: 65536)
+ *   -r REPEATS   number of measurements per result (default: 11)
+ *   NAME...      only run the benchmarks whose names start with NAME
+ *
+ * Build: make -C bench        (-O2, scalar)
+ *        make -C bench vec    (-O3 -march=native, auto-vectorized; the
+ *                              vectorized loops are reported at build time)
+ */
+
+#define _GNU_SOURCE
+
+#include <linux/perf_event.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../src/act_bf16.c"
+#include "../src/div_bf16.c"
+#include "../src/fp32_bf16.c"
+#include "../src/ln_bf16.c"  // add_sub_bf16, mul_bf16, i32_bf16
+#include "../src/ln_fixed_bf16.c"
+#include "../src/rsqrt_bf16.c"
+
+#ifndef BENCH_COMMIT
+#define BENCH_COMMIT "unknown"
+#endif  // BENCH_COMMIT
+
+#ifndef BENCH_CFLAGS
+#define BENCH_CFLAGS "unknown"
+#endif  // BENCH_CFLAGS
+
+// ┌-------------------------------------------------------┐
+// |                       Counters                        |
+// └-------------------------------------------------------┘
+
+enum { CNT_CYCLES, CNT_INSTRUCTIONS, CNT_BRANCH_MISSES, N_COUNTERS };
+
+static const char *counter_names[N_COUNTERS] = {"cycles", "instructions",
+                                                "branch_misses"};
+
+static int perf_fd[N_COUNTERS] = {-1, -1, -1};
+
+/* a measurement: wall-clock time and, if available, hardware counters */
+typedef struct {
+  double ns;
+  double count[N_COUNTERS];
+} sample;
+
+/* Open cycles, instructions and branch misses as one perf event group.
+ * Returns 1 if all of them are available; otherwise, 0.
+ */
+int perf_open() {
+  static const u32 config[N_COUNTERS] = {PERF_COUNT_HW_CPU_CYCLES,
+                                         PERF_COUNT_HW_INSTRUCTIONS,
+                                         PERF_COUNT_HW_BRANCH_MISSES};
+  for (int i = 0; i < N_COUNTERS; i++) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config[i];
+    attr.disabled = (i == 0);  // the group leader starts disabled
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    perf_fd[i] = syscall(SYS_perf_event_open, &attr, 0, -1,
+                         (i == 0) ? -1 : perf_fd[0], 0);
+    if (perf_fd[i] < 0) {
+      for (int j = 0; j < i; j++) close(perf_fd[j]);
+      for (int j = 0; j < N_COUNTERS; j++) perf_fd[j] = -1;
+      return 0;
+    }
+  }
+  return 1;
+}
+
+void perf_start() {
+  if (perf_fd[0] < 0) return;
+  ioctl(perf_fd[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(perf_fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+void perf_stop(sample *s) {
+  if (perf_fd[0] < 0) return;
+  ioctl(perf_fd[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+  unsigned long long buf[1 + N_COUNTERS];  // nr, values...
+  if (read(perf_fd[0], buf, sizeof(buf)) != sizeof(buf)) return;
+  for (int i = 0; i < N_COUNTERS; i++) s->count[i] = (double)buf[1 + i];
+}
+
+double now_ns() {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+/* Pin the calling thread to cpu; a negative cpu means the current one.
+ * Returns the cpu, or -1 if pinning failed.
+ */
+int pin_to_cpu(int cpu) {
+  if (cpu < 0) cpu = sched_getcpu();
+  if (cpu < 0) return -1;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return sched_setaffinity(0, sizeof(set), &set) == 0 ? cpu : -1;
+}
+
+// ┌-------------------------------------------------------┐
+// |                        Kernels                        |
+// └-------------------------------------------------------┘
+
+/* Every kernel calls one function n times on the inputs a (and b) and
+ * stores the results to r. In the latency kernels the next input is
+ * made to depend on the previous result with `& zero`, where zero is
+ * always 0 but unknown to the compiler; the inputs themselves stay the
+ * same as in the throughput kernels.
+ */
+typedef void (*kernel)(const u32 *a, const u32 *b, u32 *r, u32 n);
+
+volatile u32 bench_zero = 0;
+
+#define BENCH_KERNELS(name, call)                                   \
+  void lat_##name(const u32 *a, const u32 *b, u32 *r, u32 n) {      \
+    const u32 zero = bench_zero;                                    \
+    u32 dep = 0;                                                    \
+    for (u32 i = 0; i < n; i++) {                                   \
+      u32 x = a[i] | (dep & zero);                                  \
+      u32 y = b[i];                                                 \
+      dep = (call);                                                 \
+    }                                                               \
+    r[0] = dep;                                                     \
+  }                                                                 \
+  void thr_##name(const u32 *a, const u32 *b, u32 *r, u32 n) {      \
+    for (u32 i = 0; i < n; i++) {                                   \
+      u32 x = a[i];                                                 \
+      u32 y = b[i];                                                 \
+      r[i] = (call);                                                \
+    }                                                               \
+  }
+
+// the lowest mantissa bit of b selects addition or subtraction
+BENCH_KERNELS(add_sub_bf16,
+              as_u32(add_sub_bf16(as_bf16(x), as_bf16(y), y & 0x10000)))
+BENCH_KERNELS(mul_bf16, as_u32(mul_bf16(as_bf16(x), as_bf16(y))))
+BENCH_KERNELS(ln_bf16, ((void)y, as_u32(ln_bf16(as_bf16(x)))))
+BENCH_KERNELS(ln_fixed_bf16, ((void)y, as_u32(ln_fixed_bf16(as_bf16(x)))))
+BENCH_KERNELS(rsqrt_bf16, ((void)y, as_u32(rsqrt_bf16(as_bf16(x)))))
+BENCH_KERNELS(recip_bf16, ((void)y, as_u32(recip_bf16(as_bf16(x)))))
+BENCH_KERNELS(div_bf16, as_u32(div_bf16(as_bf16(x), as_bf16(y))))
+BENCH_KERNELS(sigmoid_bf16, ((void)y, as_u32(sigmoid_bf16(as_bf16(x)))))
+BENCH_KERNELS(tanh_bf16, ((void)y, as_u32(tanh_bf16(as_bf16(x)))))
+BENCH_KERNELS(gelu_erf_bf16, ((void)y, as_u32(gelu_erf_bf16(as_bf16(x)))))
+BENCH_KERNELS(fp32_to_bf16, ((void)y, as_u32(fp32_to_bf16(as_bf16(x)))))
+BENCH_KERNELS(i32_to_bf16, ((void)y, as_u32(i32_to_bf16((i32)x))))
+
+// ┌-------------------------------------------------------┐
+// |                      Input data                       |
+// └-------------------------------------------------------┘
+
+/* a small, fixed pseudo-random generator, so that every run (and every
+ * commit) measures the same inputs
+ */
+static u32 rng_state = 2023;
+u32 rng() {
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+/* random bf16 with exponent in [e_min, e_max] and random sign if signed_ */
+u32 random_bf16(int e_min, int e_max, int signed_) {
+  u32 r = rng();
+  u32 e = 127 + e_min + (r >> 8) % (e_max - e_min + 1);
+  u32 s = signed_ ? (r & 1) << 31 : 0;
+  return s | (e << 23) | (((r >> 1) & 0x7F) << 16);
+}
+
+void fill_bf16(u32 *x, u32 n, int e_min, int e_max, int signed_) {
+  for (u32 i = 0; i < n; i++) x[i] = random_bf16(e_min, e_max, signed_);
+}
+
+/* random fp32 with exponent in [-17, 18] */
+void fill_fp32(u32 *x, u32 n) {
+  for (u32 i = 0; i < n; i++)
+    x[i] = (rng() & 0x807FFFFF) | ((u32)(110 + rng() % 36) << 23);
+}
+
+/* random i32 in [-2^20, 2^20) */
+void fill_i32(u32 *x, u32 n) {
+  for (u32 i = 0; i < n; i++)
+    x[i] = (u32)((i32)(rng() % (1 << 21)) - (1 << 20));
+}
+
+// ┌-------------------------------------------------------┐
+// |                        Harness                        |
+// └-------------------------------------------------------┘
+
+typedef struct {
+  const char *name;
+  kernel lat, thr;
+  void (*fill)(u32 *a, u32 *b, u32 n);
+} benchmark;
+
+void fill_add_sub(u32 *a, u32 *b, u32 n) {
+  fill_bf16(a, n, -4, 4, 1);
+  fill_bf16(b, n, -4, 4, 1);
+}
+
+void fill_mul(u32 *a, u32 *b, u32 n) { fill_add_sub(a, b, n); }
+
+void fill_ln(u32 *a, u32 *b, u32 n) {
+  fill_bf16(a, n, -8, 8, 0);
+  memset(b, 0, n * sizeof(u32));
+}
+
+void fill_act(u32 *a, u32 *b, u32 n) {
+  fill_bf16(a, n, -4, 3, 1);
+  memset(b, 0, n * sizeof(u32));
+}
+
+void fill_fp32_to_bf16(u32 *a, u32 *b, u32 n) {
+  fill_fp32(a, n);
+  memset(b, 0, n * sizeof(u32));
+}
+
+void fill_i32_to_bf16(u32 *a, u32 *b, u32 n) {
+  fill_i32(a, n);
+  memset(b, 0, n * sizeof(u32));
+}
+
+static const benchmark benchmarks[] = {
+    {"add_sub_bf16", lat_add_sub_bf16, thr_add_sub_bf16, fill_add_sub},
+    {"mul_bf16", lat_mul_bf16, thr_mul_bf16, fill_mul},
+    {"ln_bf16", lat_ln_bf16, thr_ln_bf16, fill_ln},
+    {"ln_fixed_bf16", lat_ln_fixed_bf16, thr_ln_fixed_bf16, fill_ln},
+    {"rsqrt_bf16", lat_rsqrt_bf16, thr_rsqrt_bf16, fill_ln},
+    {"recip_bf16", lat_recip_bf16, thr_recip_bf16, fill_mul},
+    {"div_bf16", lat_div_bf16, thr_div_bf16, fill_mul},
+    {"sigmoid_bf16", lat_sigmoid_bf16, thr_sigmoid_bf16, fill_act},
+    {"tanh_bf16", lat_tanh_bf16, thr_tanh_bf16, fill_act},
+    {"gelu_erf_bf16", lat_gelu_erf_bf16, thr_gelu_erf_bf16, fill_act},
+    {"fp32_to_bf16", lat_fp32_to_bf16, thr_fp32_to_bf16, fill_fp32_to_bf16},
+    {"i32_to_bf16", lat_i32_to_bf16, thr_i32_to_bf16, fill_i32_to_bf16},
+};
+
+/* Run k on n elements `repeats` times after one warm-up run.
+ * Returns the run with the lowest time.
+ */
+sample measure(kernel k, const u32 *a, const u32 *b, u32 *r, u32 n,
+               int repeats) {
+  sample best = {0, {0}};
+  k(a, b, r, n);  // warm up caches and branch predictors
+  for (int i = 0; i < repeats; i++) {
+    sample s = {0, {0}};
+    perf_start();
+    double t0 = now_ns();
+    k(a, b, r, n);
+    s.ns = now_ns() - t0;
+    perf_stop(&s);
+    if (i == 0 || s.ns < best.ns) best = s;
+  }
+  return best;
+}
+
+void print_result(FILE *out, const char *name, const char *mode, sample s,
+                  u32 n, int has_counters, int last) {
+  fprintf(out, "    {\"name\": \"%s\", \"mode\": \"%s\", \"ns_per_op\": %.3f",
+          name, mode, s.ns / n);
+  if (has_counters) {
+    for (int i = 0; i < N_COUNTERS; i++)
+      fprintf(out, ", \"%s_per_op\": %.3f", counter_names[i], s.count[i] / n);
+    fprintf(out, ", \"ipc\": %.3f",
+            s.count[CNT_CYCLES]
+                ? s.count[CNT_INSTRUCTIONS] / s.count[CNT_CYCLES]
+                : 0.0);
+  }
+  fprintf(out, "}%s\n", last ? "" : ",");
+}
+
+int selected(const char *name, int argc, char *argv[], int first) {
+  if (first >= argc) return 1;
+  for (int i = first; i < argc; i++)
+    if (strncmp(name, argv[i], strlen(argv[i])) == 0) return 1;
+  return 0;
+}
+
+void usage() {
+  fputs(
+      "usage: bench_bf16 [-o FILE] [-c CPU] [-n ELEMENTS] [-r REPEATS] "
+      "[NAME...]\n",
+      stderr);
+  exit(2);
+}
+
+int main(int argc, char *argv[]) {
+  const char *path = NULL;
+  int cpu = -1, repeats = 11;
+  u32 n = 1 << 16;
+
+  int i = 1;
+  for (; i < argc && argv[i][0] == '-'; i++) {
+    if (i + 1 >= argc) usage();
+    if (strcmp(argv[i], "-o") == 0) path = argv[++i];
+    else if (strcmp(argv[i], "-c") == 0) cpu = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-n") == 0) n = (u32)atoi(argv[++i]);
+    else if (strcmp(argv[i], "-r") == 0) repeats = atoi(argv[++i]);
+    else usage();
+  }
+  if (n == 0 || repeats <= 0) usage();
+
+  cpu = pin_to_cpu(cpu);
+  if (cpu < 0) fputs("bench_bf16: cannot pin to a cpu\n", stderr);
+  int has_counters = perf_open();
+  if (!has_counters)
+    fputs("bench_bf16: perf_event_open unavailable; timing only\n", stderr);
+
+  u32 *a = malloc(n * sizeof(u32));
+  u32 *b = malloc(n * sizeof(u32));
+  u32 *r = malloc(n * sizeof(u32));
+  if (!a || !b || !r) return 1;
+
+  FILE *out = path ? fopen(path, "w") : stdout;
+  if (!out) return 1;
+  fprintf(out, "{\n");
+  fprintf(out, "  \"commit\": \"%s\",\n", BENCH_COMMIT);
+  fprintf(out, "  \"cflags\": \"%s\",\n", BENCH_CFLAGS);
+  fprintf(out, "  \"cpu\": %d,\n", cpu);
+  fprintf(out, "  \"counters\": \"%s\",\n", has_counters ? "perf" : "clock");
+  fprintf(out, "  \"elements\": %u,\n", n);
+  fprintf(out, "  \"repeats\": %d,\n", repeats);
+  fprintf(out, "  \"results\": [\n");
+
+  const int n_benchmarks = sizeof(benchmarks) / sizeof(benchmarks[0]);
+  int last = -1;
+  for (int k = 0; k < n_benchmarks; k++)
+    if (selected(benchmarks[k].name, argc, argv, i)) last = k;
+  for (int k = 0; k < n_benchmarks; k++) {
+    const benchmark *bm = &benchmarks[k];
+    if (!selected(bm->name, argc, argv, i)) continue;
+    rng_state = 2023;
+    bm->fill(a, b, n);
+    sample lat = measure(bm->lat, a, b, r, n, repeats);
+    sample thr = measure(bm->thr, a, b, r, n, repeats);
+    print_result(out, bm->name, "latency", lat, n, has_counters, 0);
+    print_result(out, bm->name, "throughput", thr, n, has_counters, k == last);
+  }
+
+  fprintf(out, "  ]\n}\n");
+  if (path) fclose(out);
+  free(a);
+  free(b);
+  free(r);
+  return 0;
+}
@@ -0,0 +1,817 @@
+/*
+ * This program implements and tests the following functionality:
+ *   An instruction-counting interpreter for RV32I ELF executables,
+ *   so that the programs in asm/ can be run and profiled without
+ *   rv32emu.
+ *
+ * Supported:
+ * (1) the RV32I base instruction set, plus read-only access to the
+ *     cycle, time and instret counters (rdcycle, rdtime, rdinstret);
+ * (2) the SYS_WRITE (64) and SYS_EXIT (93) system calls used by
+ *     asm/syscall.c, and just enough of close, lseek, read, fstat and
+ *     brk for the start-up code and stdio of newlib;
+ * (3) statically linked ELF32 executables (ET_EXEC), and relocatable
+ *     objects (ET_REL) of a self-contained source file, such as the
+ *     output of `llvm-mc -filetype=obj`, whose relocations of types
+ *     R_RISCV_32, BRANCH, JAL, CALL, CALL_PLT, PCREL_HI20,
+ *     PCREL_LO12_I/S, HI20 and LO12_I/S are applied at load time
+ *     (RELAX is ignored, and any other type is an error).
+ *
+ * Every instruction is decoded once when the program is loaded and is
+ * then dispatched through a table of labels (threaded code), which keeps
+ * the interpreter fast enough to sweep all 65,536 bf16 inputs of a
+ * function in a few seconds. Each decoded instruction carries its own
+ * execution counter; with -p the counters are summed per symbol of the
+ * ELF symbol table, including local labels such as `mhu_loop`, and the
+ * hottest symbols are reported on stderr.
+ *
+ * Usage: rv32sim [-p [N]] [-s] [-m MiB] program.elf
+ *   -p N   report the N hottest symbols (default: 16)
+ *   -s     report the total number of executed instructions
+ *   -m     size of the flat memory in MiB (default: 16)
+ *
+ * Build: make -C sim
+ *
+ * Version: 0.0
+ * Tested: 2026-10-18T20:10:00+08:00
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef int32_t i32;
+typedef uint64_t u64;
+
+#define SYS_CLOSE 57
+#define SYS_LSEEK 62
+#define SYS_READ 63
+#define SYS_WRITE 64
+#define SYS_FSTAT 80
+#define SYS_EXIT 93
+#define SYS_BRK 214
+
+// returning from the entry point jumps here, which stops the program
+#define EXIT_ADDRESS 0xFFFFFFF0u
+
+/* ELF32 structures (only the fields used by this program) */
+typedef struct {
+  u8 ident[16];
+  u16 type, machine;
+  u32 version, entry, phoff, shoff, flags;
+  u16 ehsize, phentsize, phnum, shentsize, shnum, shstrndx;
+} elf32_ehdr;
+
+typedef struct {
+  u32 type, offset, vaddr, paddr, filesz, memsz, flags, align;
+} elf32_phdr;
+
+typedef struct {
+  u32 name, type, flags, addr, offset, size, link, info, addralign, entsize;
+} elf32_shdr;
+
+typedef struct {
+  u32 name, value, size;
+  u8 info, other;
+  u16 shndx;
+} elf32_sym;
+
+#define ET_REL 1
+#define ET_EXEC 2
+#define EM_RISCV 243
+#define PT_LOAD 1
+#define PF_X 1
+#define SHT_PROGBITS 1
+#define SHT_SYMTAB 2
+#define SHT_NOBITS 8
+#define SHT_RELA 4
+#define SHF_ALLOC 2
+#define SHF_EXECINSTR 4
+#define STT_SECTION 3
+#define STT_FILE 4
+
+/* a decoded instruction */
+typedef struct {
+  const void *op;  // label of the handler
+  u8 rd, rs1, rs2;
+  i32 imm;
+  u64 count;  // number of times this instruction was executed
+} insn;
+
+/* a symbol of the program, for the profile */
+typedef struct {
+  u32 addr;
+  const char *name;
+  u64 count;
+} symbol;
+
+static u8 *mem;
+static u32 mem_size;
+static u32 text_base, text_end;  // executable range [text_base, text_end)
+static u32 entry;
+static u32 brk;  // end of the data, moved by SYS_BRK
+
+static symbol *symbols;
+static u32 n_symbols;
+
+static void die(const char *msg) {
+  fprintf(stderr, "rv32sim: %s\n", msg);
+  exit(2);
+}
+
+static void *xread(FILE *f, u32 offset, u32 size) {
+  void *p = malloc(size ? size : 1);
+  if (!p) die("out of memory");
+  if (fseek(f, offset, SEEK_SET) != 0 || fread(p, 1, size, f) != size)
+    die("truncated ELF file");
+  return p;
+}
+
+static void load_bytes(FILE *f, u32 offset, u32 size, u32 addr) {
+  if (addr > mem_size || size > mem_size - addr)
+    die("program does not fit in memory (try -m)");
+  void *p = xread(f, offset, size);
+  memcpy(mem + addr, p, size);
+  free(p);
+}
+
+static void mark_text(u32 addr, u32 size) {
+  if (text_end == 0) {
+    text_base = addr;
+    text_end = addr + size;
+    return;
+  }
+  if (addr < text_base) text_base = addr;
+  if (addr + size > text_end) text_end = addr + size;
+}
+
+static int compare_symbol(const void *a, const void *b) {
+  const symbol *sa = a, *sb = b;
+  return (sa->addr > sb->addr) - (sa->addr < sb->addr);
+}
+
+typedef struct {
+  u32 offset, info;
+  i32 addend;
+} elf32_rela;
+
+// relocation types used by assemblers for RV32I code
+#define R_RISCV_32 1
+#define R_RISCV_BRANCH 16
+#define R_RISCV_JAL 17
+#define R_RISCV_CALL 18
+#define R_RISCV_CALL_PLT 19
+#define R_RISCV_PCREL_HI20 23
+#define R_RISCV_PCREL_LO12_I 24
+#define R_RISCV_PCREL_LO12_S 25
+#define R_RISCV_HI20 26
+#define R_RISCV_LO12_I 27
+#define R_RISCV_LO12_S 28
+#define R_RISCV_RELAX 51
+
+static u32 read32(u32 addr) {
+  u32 w;
+  memcpy(&w, mem + addr, 4);
+  return w;
+}
+
+static void write32(u32 addr, u32 w) { memcpy(mem + addr, &w, 4); }
+
+static void patch_i(u32 addr, u32 imm) {
+  write32(addr, (read32(addr) & 0x000FFFFF) | (imm << 20));
+}
+
+static void patch_s(u32 addr, u32 imm) {
+  write32(addr, (read32(addr) & 0x01FFF07F) | ((imm >> 5) << 25) |
+                    ((imm & 0x1F) << 7));
+}
+
+static void patch_u(u32 addr, u32 imm) {
+  write32(addr, (read32(addr) & 0xFFF) | (imm & 0xFFFFF000));
+}
+
+/* the upper 20 bits of x, adjusted for the sign of the lower 12 bits */
+static u32 hi20(u32 x) { return (x + 0x800) & 0xFFFFF000; }
+
+/* Apply the relocations of a relocatable object, whose allocatable
+ * sections have been placed at sh_addr[]. This is enough to run an
+ * object assembled from a self-contained source file (for example,
+ * the programs in asm/ with the system calls appended) without a
+ * RISC-V linker.
+ */
+static void relocate(FILE *f, elf32_ehdr *eh, elf32_shdr *sh, u32 *sh_addr) {
+  for (int pass = 0; pass < 2; pass++) {
+    // pass 0: %pcrel_hi, whose offsets the %pcrel_lo in pass 1 refer to
+    for (u32 i = 0; i < eh->shnum; i++) {
+      if (sh[i].type != SHT_RELA || sh[i].size == 0) continue;
+      if (!(sh[sh[i].info].flags & SHF_ALLOC)) continue;
+      elf32_rela *rel = xread(f, sh[i].offset, sh[i].size);
+      elf32_sym *st = xread(f, sh[sh[i].link].offset, sh[sh[i].link].size);
+      u32 base = sh_addr[sh[i].info];
+
+      for (u32 j = 0; j < sh[i].size / sizeof(elf32_rela); j++) {
+        u32 type = rel[j].info & 0xFF;
+        elf32_sym *sym = &st[rel[j].info >> 8];
+        if (sym->shndx == 0 || sym->shndx >= eh->shnum)
+          die("undefined symbol in relocatable object; link it first");
+        u32 p = base + rel[j].offset;
+        u32 v = sym->value + sh_addr[sym->shndx] + rel[j].addend;
+        u32 off = v - p;
+        if (p > mem_size - 8) die("relocation out of range");
+        if ((pass == 0) != (type == R_RISCV_PCREL_HI20)) continue;
+
+        switch (type) {
+          case R_RISCV_32: write32(p, v); break;
+          case R_RISCV_BRANCH:
+            write32(p, (read32(p) & 0x01FFF07F) | ((off >> 12 & 1) << 31) |
+                           ((off >> 5 & 0x3F) << 25) | ((off >> 1 & 0xF) << 8) |
+                           ((off >> 11 & 1) << 7));
+            break;
+          case R_RISCV_JAL:
+            write32(p, (read32(p) & 0xFFF) | ((off >> 20 & 1) << 31) |
+                           ((off >> 1 & 0x3FF) << 21) |
+                           ((off >> 11 & 1) << 20) | (off & 0xFF000));
+            break;
+          case R_RISCV_CALL:
+          case R_RISCV_CALL_PLT:
+            patch_u(p, hi20(off));
+            patch_i(p + 4, off - hi20(off));
+            break;
+          case R_RISCV_PCREL_HI20: patch_u(p, hi20(off)); break;
+          case R_RISCV_PCREL_LO12_I:
+          case R_RISCV_PCREL_LO12_S: {
+            // the symbol is the auipc; recover its offset from the auipc
+            u32 hi = read32(v) & 0xFFFFF000;
+            u32 lo = 0;
+            int found = 0;
+            for (u32 k = 0; k < sh[i].size / sizeof(elf32_rela); k++) {
+              elf32_sym *hs = &st[rel[k].info >> 8];
+              if ((rel[k].info & 0xFF) != R_RISCV_PCREL_HI20 ||
+                  base + rel[k].offset != v)
+                continue;
+              lo = hs->value + sh_addr[hs->shndx] + rel[k].addend - v - hi;
+              found = 1;
+              break;
+            }
+            if (!found) die("%pcrel_lo without %pcrel_hi");
+            if (type == R_RISCV_PCREL_LO12_I) patch_i(p, lo);
+            else patch_s(p, lo);
+            break;
+          }
+          case R_RISCV_HI20: patch_u(p, hi20(v)); break;
+          case R_RISCV_LO12_I: patch_i(p, v - hi20(v)); break;
+          case R_RISCV_LO12_S: patch_s(p, v - hi20(v)); break;
+          case R_RISCV_RELAX: break;
+          default: die("unsupported relocation type");
+        }
+      }
+      free(st);
+      free(rel);
+    }
+  }
+}
+
+/* Load an ELF32 RISC-V program into mem. */
+void load_elf(const char *path) {
+  FILE *f = fopen(path, "rb");
+  if (!f) die("cannot open the program");
+
+  elf32_ehdr *eh = xread(f, 0, sizeof(elf32_ehdr));
+  if (memcmp(eh->ident, "\x7F" "ELF", 4) != 0 || eh->ident[4] != 1 ||
+      eh->ident[5] != 1)
+    die("not a little-endian ELF32 file");
+  if (eh->machine != EM_RISCV) die("not a RISC-V program");
+
+  elf32_shdr *sh = eh->shnum
+                       ? xread(f, eh->shoff, eh->shnum * sizeof(elf32_shdr))
+                       : NULL;
+  u32 *sh_addr = calloc(eh->shnum + 1, sizeof(u32));
+
+  if (eh->type == ET_EXEC) {
+    elf32_phdr *ph = xread(f, eh->phoff, eh->phnum * sizeof(elf32_phdr));
+    for (u32 i = 0; i < eh->phnum; i++) {
+      if (ph[i].type != PT_LOAD) continue;
+      load_bytes(f, ph[i].offset, ph[i].filesz, ph[i].vaddr);
+      if (ph[i].flags & PF_X) mark_text(ph[i].vaddr, ph[i].memsz);
+      if (ph[i].vaddr + ph[i].memsz > brk) brk = ph[i].vaddr + ph[i].memsz;
+    }
+    free(ph);
+    for (u32 i = 0; i < eh->shnum; i++) sh_addr[i] = 0;  // values are absolute
+    entry = eh->entry;
+  } else if (eh->type == ET_REL) {
+    // place the allocatable sections one after another from address 0
+    u32 addr = 0;
+    for (u32 i = 0; i < eh->shnum; i++) {
+      if (!(sh[i].flags & SHF_ALLOC)) continue;
+      u32 align = sh[i].addralign ? sh[i].addralign : 1;
+      addr = (addr + align - 1) & ~(align - 1);
+      sh_addr[i] = addr;
+      if (sh[i].type == SHT_PROGBITS)
+        load_bytes(f, sh[i].offset, sh[i].size, addr);
+      if (sh[i].flags & SHF_EXECINSTR) mark_text(addr, sh[i].size);
+      addr += sh[i].size;
+    }
+    if (addr > mem_size) die("program does not fit in memory (try -m)");
+    entry = text_base;
+    brk = addr;
+    relocate(f, eh, sh, sh_addr);
+  } else {
+    die("neither an executable nor a relocatable object");
+  }
+
+  // collect the symbols, including local labels, for the profile
+  for (u32 i = 0; i < eh->shnum; i++) {
+    if (sh[i].type != SHT_SYMTAB) continue;
+    elf32_sym *st = xread(f, sh[i].offset, sh[i].size);
+    elf32_shdr *strtab = &sh[sh[i].link];
+    char *str = xread(f, strtab->offset, strtab->size);
+    u32 n = sh[i].size / sizeof(elf32_sym);
+    symbols = realloc(symbols, (n_symbols + n) * sizeof(symbol));
+    for (u32 j = 0; j < n; j++) {
+      u8 type = st[j].info & 0xF;
+      if (st[j].name == 0 || type == STT_SECTION || type == STT_FILE)
+        continue;
+      if (strncmp(str + st[j].name, ".L", 2) == 0) continue;  // temporary
+      if (st[j].shndx == 0 || st[j].shndx >= eh->shnum) continue;
+      u32 addr = st[j].value + sh_addr[st[j].shndx];
+      if (eh->type == ET_REL && strcmp(str + st[j].name, "main") == 0)
+        entry = addr;
+      if (addr < text_base || addr >= text_end) continue;
+      symbols[n_symbols].addr = addr;
+      symbols[n_symbols].name = strdup(str + st[j].name);
+      symbols[n_symbols].count = 0;
+      n_symbols++;
+    }
+    free(st);
+    free(str);
+  }
+  qsort(symbols, n_symbols, sizeof(symbol), compare_symbol);
+
+  free(sh_addr);
+  free(sh);
+  free(eh);
+  fclose(f);
+}
+
+/* Sign-extend the lowest `bits` bits of x. */
+static i32 sext(u32 x, int bits) {
+  return (i32)(x << (32 - bits)) >> (32 - bits);
+}
+
+/* Decode the instructions in [text_base, text_end) and run from entry.
+ * Returns the exit status of the program.
+ */
+static int run(u64 *instret_out, insn **code_out, u32 *n_code_out) {
+  enum {
+    LUI, AUIPC, JAL, JALR, BEQ, BNE, BLT, BGE, BLTU, BGEU,
+    LB, LH, LW, LBU, LHU, SB, SH, SW,
+    ADDI, SLTI, SLTIU, XORI, ORI, ANDI, SLLI, SRLI, SRAI,
+    ADD, SUB, SLL, SLT, SLTU, XOR, SRL, SRA, OR, AND,
+    FENCE, ECALL, EBREAK, CSRR, ILLEGAL, N_OPS
+  };
+  static const void *labels[N_OPS] = {
+      &&op_lui,  &&op_auipc, &&op_jal,   &&op_jalr,  &&op_beq,
+      &&op_bne,  &&op_blt,   &&op_bge,   &&op_bltu,  &&op_bgeu,
+      &&op_lb,   &&op_lh,    &&op_lw,    &&op_lbu,   &&op_lhu,
+      &&op_sb,   &&op_sh,    &&op_sw,    &&op_addi,  &&op_slti,
+      &&op_sltiu, &&op_xori, &&op_ori,   &&op_andi,  &&op_slli,
+      &&op_srli, &&op_srai,  &&op_add,   &&op_sub,   &&op_sll,
+      &&op_slt,  &&op_sltu,  &&op_xor,   &&op_srl,   &&op_sra,
+      &&op_or,   &&op_and,   &&op_fence, &&op_ecall, &&op_ebreak,
+      &&op_csrr, &&op_illegal};
+
+  u32 n_code = (text_end - text_base) / 4 + 1;  // +1: sentinel
+  insn *code = calloc(n_code, sizeof(insn));
+  if (!code) die("out of memory");
+
+  // decode
+  for (u32 i = 0; i + 1 < n_code; i++) {
+    u32 w;
+    memcpy(&w, mem + text_base + 4 * i, 4);
+    u32 opcode = w & 0x7F, f3 = (w >> 12) & 7, f7 = w >> 25;
+    u32 rd = (w >> 7) & 0x1F;
+    insn *d = &code[i];
+    d->rd = rd ? rd : 32;  // writes to x0 go to a scratch register
+    d->rs1 = (w >> 15) & 0x1F;
+    d->rs2 = (w >> 20) & 0x1F;
+    int op = ILLEGAL;
+    switch (opcode) {
+      case 0x37: op = LUI; d->imm = w & 0xFFFFF000; break;
+      case 0x17: op = AUIPC; d->imm = w & 0xFFFFF000; break;
+      case 0x6F:
+        op = JAL;
+        d->imm = sext(((w >> 31) << 20) | (((w >> 12) & 0xFF) << 12) |
+                          (((w >> 20) & 1) << 11) | (((w >> 21) & 0x3FF) << 1),
+                      21);
+        break;
+      case 0x67:
+        if (f3 == 0) op = JALR;
+        d->imm = sext(w >> 20, 12);
+        break;
+      case 0x63: {
+        static const int ops[8] = {BEQ, BNE, ILLEGAL, ILLEGAL,
+                                   BLT, BGE, BLTU,    BGEU};
+        op = ops[f3];
+        d->imm = sext(((w >> 31) << 12) | (((w >> 7) & 1) << 11) |
+                          (((w >> 25) & 0x3F) << 5) | (((w >> 8) & 0xF) << 1),
+                      13);
+        break;
+      }
+      case 0x03: {
+        static const int ops[8] = {LB,  LH,  LW,      ILLEGAL,
+                                   LBU, LHU, ILLEGAL, ILLEGAL};
+        op = ops[f3];
+        d->imm = sext(w >> 20, 12);
+        break;
+      }
+      case 0x23: {
+        static const int ops[8] = {SB,      SH,      SW,      ILLEGAL,
+                                   ILLEGAL, ILLEGAL, ILLEGAL, ILLEGAL};
+        op = ops[f3];
+        d->imm = sext(((w >> 25) << 5) | ((w >> 7) & 0x1F), 12);
+        break;
+      }
+      case 0x13: {
+        static const int ops[8] = {ADDI, SLLI, SLTI, SLTIU,
+                                   XORI, SRLI, ORI,  ANDI};
+        op = ops[f3];
+        d->imm = sext(w >> 20, 12);
+        if (f3 == 1 && f7 != 0) op = ILLEGAL;
+        if (f3 == 5) {
+          d->imm &= 0x1F;
+          if (f7 == 0x20) op = SRAI;
+          else if (f7 != 0) op = ILLEGAL;
+        }
+        break;
+      }
+      case 0x33: {
+        static const int ops[8] = {ADD, SLL, SLT, SLTU, XOR, SRL, OR, AND};
+        if (f7 == 0) op = ops[f3];
+        else if (f7 == 0x20 && f3 == 0) op = SUB;
+        else if (f7 == 0x20 && f3 == 5) op = SRA;
+        break;
+      }
+      case 0x0F: op = FENCE; break;
+      case 0x73:
+        if (w == 0x00000073) op = ECALL;
+        else if (w == 0x00100073) op = EBREAK;
+        else if (f3 == 2 && d->rs1 == 0) {  // csrrs rd, csr, x0
+          op = CSRR;
+          d->imm = w >> 20;
+        }
+        break;
+    }
+    d->op = labels[op];
+  }
+  code[n_code - 1].op = labels[ILLEGAL];
+
+  u32 x[33] = {0};  // x[32] absorbs writes to x0
+  x[1] = EXIT_ADDRESS;
+  x[2] = (mem_size & ~15u) - 16;  // sp at the top; argc = 0, argv = {NULL}
+  int status = 0;
+  u64 instret = 0;
+  insn *ip;
+  u32 addr;
+
+#define PC(p) (text_base + 4 * (u32)((p) - code))
+#define JUMP(target)                                            \
+  do {                                                          \
+    u32 t_ = (target);                                          \
+    if (t_ == EXIT_ADDRESS) goto finish;                        \
+    if (t_ < text_base || t_ >= text_end || (t_ & 3)) {         \
+      fprintf(stderr, "rv32sim: jump to 0x%08x at 0x%08x\n", t_, \
+              PC(ip));                                          \
+      status = 2;                                               \
+      goto finish;                                              \
+    }                                                           \
+    ip = code + ((t_ - text_base) >> 2);                        \
+    DISPATCH();                                                 \
+  } while (0)
+#define DISPATCH()   \
+  do {               \
+    ip->count++;     \
+    x[0] = 0;        \
+    goto *ip->op;    \
+  } while (0)
+#define NEXT() \
+  do {         \
+    ip++;      \
+    DISPATCH(); \
+  } while (0)
+#define RS1 x[ip->rs1]
+#define RS2 x[ip->rs2]
+#define RD x[ip->rd]
+#define CHECK(a, n)                                                  \
+  do {                                                               \
+    if ((a) > mem_size - (n)) {                                      \
+      fprintf(stderr, "rv32sim: access to 0x%08x at 0x%08x\n", (a), \
+              PC(ip));                                               \
+      status = 2;                                                    \
+      goto finish;                                                   \
+    }                                                                \
+  } while (0)
+#define LOAD(T, cast)          \
+  do {                         \
+    T v_;                      \
+    addr = RS1 + ip->imm;      \
+    CHECK(addr, sizeof(T));    \
+    memcpy(&v_, mem + addr, sizeof(T)); \
+    RD = (u32)(cast)v_;        \
+    NEXT();                    \
+  } while (0)
+#define STORE(T)               \
+  do {                         \
+    T v_ = (T)RS2;             \
+    addr = RS1 + ip->imm;      \
+    CHECK(addr, sizeof(T));    \
+    memcpy(mem + addr, &v_, sizeof(T)); \
+    NEXT();                    \
+  } while (0)
+#define BRANCH(cond)                  \
+  do {                                \
+    if (cond) JUMP(PC(ip) + ip->imm); \
+    NEXT();                           \
+  } while (0)
+
+  ip = code;
+  JUMP(entry);
+
+op_lui: RD = ip->imm; NEXT();
+op_auipc: RD = PC(ip) + ip->imm; NEXT();
+op_jal: RD = PC(ip) + 4; JUMP(PC(ip) + ip->imm);
+op_jalr: {
+  u32 t = (RS1 + ip->imm) & ~1u;
+  RD = PC(ip) + 4;
+  JUMP(t);
+}
+op_beq: BRANCH(RS1 == RS2);
+op_bne: BRANCH(RS1 != RS2);
+op_blt: BRANCH((i32)RS1 < (i32)RS2);
+op_bge: BRANCH((i32)RS1 >= (i32)RS2);
+op_bltu: BRANCH(RS1 < RS2);
+op_bgeu: BRANCH(RS1 >= RS2);
+op_lb: LOAD(int8_t, i32);
+op_lh: LOAD(int16_t, i32);
+op_lw: LOAD(u32, u32);
+op_lbu: LOAD(u8, u32);
+op_lhu: LOAD(u16, u32);
+op_sb: STORE(u8);
+op_sh: STORE(u16);
+op_sw: STORE(u32);
+op_addi: RD = RS1 + ip->imm; NEXT();
+op_slti: RD = (i32)RS1 < ip->imm; NEXT();
+op_sltiu: RD = RS1 < (u32)ip->imm; NEXT();
+op_xori: RD = RS1 ^ ip->imm; NEXT();
+op_ori: RD = RS1 | ip->imm; NEXT();
+op_andi: RD = RS1 & ip->imm; NEXT();
+op_slli: RD = RS1 << ip->imm; NEXT();
+op_srli: RD = RS1 >> ip->imm; NEXT();
+op_srai: RD = (i32)RS1 >> ip->imm; NEXT();
+op_add: RD = RS1 + RS2; NEXT();
+op_sub: RD = RS1 - RS2; NEXT();
+op_sll: RD = RS1 << (RS2 & 31); NEXT();
+op_slt: RD = (i32)RS1 < (i32)RS2; NEXT();
+op_sltu: RD = RS1 < RS2; NEXT();
+op_xor: RD = RS1 ^ RS2; NEXT();
+op_srl: RD = RS1 >> (RS2 & 31); NEXT();
+op_sra: RD = (i32)RS1 >> (RS2 & 31); NEXT();
+op_or: RD = RS1 | RS2; NEXT();
+op_and: RD = RS1 & RS2; NEXT();
+op_fence: NEXT();
+op_csrr: {
+  // cycle and time are reported as instret, as rv32emu does
+  u64 n = instret;
+  for (insn *p = code; p < code + n_code; p++) n += p->count;
+  switch (ip->imm) {
+    case 0xC00: case 0xC01: case 0xC02: RD = (u32)n; break;
+    case 0xC80: case 0xC81: case 0xC82: RD = (u32)(n >> 32); break;
+    default: goto op_illegal;
+  }
+  NEXT();
+}
+op_ecall:
+  switch (x[17]) {
+    case SYS_WRITE: {
+      u32 buf = x[11], len = x[12];
+      if (buf > mem_size || len > mem_size - buf) {
+        x[10] = (u32)-1;
+        NEXT();
+      }
+      FILE *out = (x[10] == 2) ? stderr : stdout;
+      x[10] = (u32)fwrite(mem + buf, 1, len, out);
+      NEXT();
+    }
+    case SYS_EXIT:
+      goto finish;
+    case SYS_CLOSE:
+      x[10] = 0;
+      NEXT();
+    case SYS_LSEEK:
+    case SYS_READ:
+    case SYS_FSTAT:
+      x[10] = (u32)-1;  // no files; stdout is then buffered as a file
+      NEXT();
+    case SYS_BRK:
+      // keep 1 MiB below the top of memory for the stack
+      if (x[10] >= brk && x[10] <= mem_size - (1u << 20)) brk = x[10];
+      x[10] = brk;
+      NEXT();
+    default:
+      fprintf(stderr, "rv32sim: unknown system call %u at 0x%08x\n", x[17],
+              PC(ip));
+      status = 2;
+      goto finish;
+  }
+op_ebreak:
+  fprintf(stderr, "rv32sim: ebreak at 0x%08x\n", PC(ip));
+  status = 2;
+  goto finish;
+op_illegal:
+  if (ip == code + n_code - 1)
+    fprintf(stderr, "rv32sim: fell off the end of the program\n");
+  else
+    fprintf(stderr, "rv32sim: illegal instruction 0x%08x at 0x%08x\n",
+            *(u32 *)(mem + PC(ip)), PC(ip));
+  status = 2;
+  goto finish;
+
+finish:
+  if (status == 0) status = (int)x[10];
+  for (insn *p = code; p < code + n_code; p++) instret += p->count;
+  *instret_out = instret;
+  *code_out = code;
+  *n_code_out = n_code;
+  return status;
+
+#undef PC
+#undef JUMP
+#undef DISPATCH
+#undef NEXT
+#undef RS1
+#undef RS2
+#undef RD
+#undef CHECK
+#undef LOAD
+#undef STORE
+#undef BRANCH
+}
+
+static int compare_count(const void *a, const void *b) {
+  const symbol *sa = a, *sb = b;
+  return (sa->count < sb->count) - (sa->count > sb->count);
+}
+
+/* Attribute the execution counters to the symbols and print the n
+ * hottest ones. An instruction belongs to the closest symbol at or
+ * before its address.
+ */
+static void print_profile(const insn *code, u32 n_code, u64 instret, u32 n) {
+  u32 s = 0;
+  u64 unknown = 0;
+  for (u32 i = 0; i + 1 < n_code; i++) {
+    u32 pc = text_base + 4 * i;
+    while (s + 1 < n_symbols && symbols[s + 1].addr <= pc) s++;
+    if (n_symbols && symbols[s].addr <= pc)
+      symbols[s].count += code[i].count;
+    else
+      unknown += code[i].count;
+  }
+  qsort(symbols, n_symbols, sizeof(symbol), compare_count);
+
+  fprintf(stderr, "%14s %7s  %s\n", "instructions", "%", "symbol");
+  for (u32 i = 0; i < n_symbols && i < n; i++) {
+    if (symbols[i].count == 0) break;
+    fprintf(stderr, "%14llu %6.2f%%  %s\n",
+            (unsigned long long)symbols[i].count,
+            100.0 * symbols[i].count / (instret ? instret : 1),
+            symbols[i].name);
+  }
+  if (unknown)
+    fprintf(stderr, "%14llu %6.2f%%  %s\n", (unsigned long long)unknown,
+            100.0 * unknown / (instret ? instret : 1), "(no symbol)");
+}
+
+#ifdef RV32SIM_TEST
+/* the program of test_rv32sim, assembled by llvm-mc */
+static const u32 rv32sim_test_program[] = {
+    0x00000513,  // 0x00 main:   li   a0, 0
+    0x00A00293,  // 0x04         li   t0, 10
+    0x00550533,  // 0x08 loop:   add  a0, a0, t0
+    0xFFF28293,  // 0x0C         addi t0, t0, -1
+    0xFE029CE3,  // 0x10         bnez t0, loop        # a0 = 55
+    0x80000313,  // 0x14         li   t1, -2048
+    0x10602023,  // 0x18         sw   t1, 256(zero)
+    0x10001383,  // 0x1C         lh   t2, 256(zero)   # t2 = -2048
+    0x10004E03,  // 0x20         lbu  t3, 256(zero)   # t3 = 0
+    0x4043D393,  // 0x24         srai t2, t2, 4       # t2 = -128
+    0x00750533,  // 0x28         add  a0, a0, t2
+    0x01C50533,  // 0x2C         add  a0, a0, t3      # a0 = -73
+    0x00A33EB3,  // 0x30         sltu t4, t1, a0      # t4 = 1
+    0x01D50533,  // 0x34         add  a0, a0, t4      # a0 = -72
+    0x00C000EF,  // 0x38         jal  ra, double
+    0x05D00893,  // 0x3C         li   a7, 93
+    0x00000073,  // 0x40         ecall                # exit(-144)
+    0x00151513,  // 0x44 double: slli a0, a0, 1
+    0x00008067,  // 0x48         ret
+};
+
+/* Test the functionalities in this unit.
+ * Return 0 if successes. Otherwise, return a non-zero number,
+ * which indicates the first failed test.
+ */
+int test_rv32sim() {
+  mem_size = 1 << 20;
+  mem = calloc(mem_size, 1);
+  if (!mem) die("out of memory");
+  memcpy(mem, rv32sim_test_program, sizeof(rv32sim_test_program));
+  text_base = entry = 0;
+  text_end = sizeof(rv32sim_test_program);
+
+  static symbol test_symbols[] = {{0x00, "main", 0}, {0x08, "loop", 0},
+                                  {0x44, "double", 0}};
+  symbols = test_symbols;
+  n_symbols = 3;
+
+  u64 instret;
+  insn *code;
+  u32 n_code;
+  int status = run(&instret, &code, &n_code);
+
+  // 1: the result of the program
+  if (status != -144) return 1;
+
+  // 2: the number of executed instructions
+  if (instret != 2 + 3 * 10 + 10 + 2 + 2) return 2;
+
+  // 3: the profile; the instructions after the loop belong to `loop`
+  print_profile(code, n_code, instret, 3);
+  if (strcmp(symbols[0].name, "loop") != 0 || symbols[0].count != 42) return 3;
+  if (symbols[1].count != 2 || symbols[2].count != 2) return 3;
+
+  free(code);
+  free(mem);
+  return 0;
+}
+
+int main() {
+  int error_code = test_rv32sim();
+  if (error_code == 0) {
+    puts("Test for rv32sim.c passed.");
+    return 0;
+  } else {
+    printf("Test %d for rv32sim.c failed.\n", error_code);
+    return 1;
+  }
+}
+#else
+static void usage(void) {
+  fputs("usage: rv32sim [-p [N]] [-s] [-m MiB] program.elf\n", stderr);
+  exit(2);
+}
+
+int main(int argc, char *argv[]) {
+  u32 n_profile = 0, mem_mib = 16;
+  int print_stats = 0;
+  const char *path = NULL;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-p") == 0) {
+      n_profile = 16;
+      if (i + 1 < argc && argv[i + 1][0] >= '0' && argv[i + 1][0] <= '9')
+        n_profile = (u32)atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-s") == 0) {
+      print_stats = 1;
+    } else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+      mem_mib = (u32)atoi(argv[++i]);
+      if (mem_mib == 0 || mem_mib > 2048) usage();
+    } else if (argv[i][0] == '-' || path) {
+      usage();
+    } else {
+      path = argv[i];
+    }
+  }
+  if (!path) usage();
+
+  mem_size = mem_mib << 20;
+  mem = calloc(mem_size, 1);
+  if (!mem) die("out of memory");
+  load_elf(path);
+  if (text_end <= text_base) die("the program has no code");
+
+  u64 instret;
+  insn *code;
+  u32 n_code;
+  int status = run(&instret, &code, &n_code);
+  fflush(stdout);
+
+  if (print_stats)
+    fprintf(stderr, "rv32sim: %llu instructions executed\n",
+            (unsigned long long)instret);
+  if (n_profile) print_profile(code, n_code, instret, n_profile);
+  return status;
+}
+#endif  // RV32SIM_TEST
@@ -0,0 +1,514 @@
+/*
+ * This program implements and tests the following functionality:
+ *   Activation functions of bf16 numbers: sigmoid, tanh, and GELU (with
+ *   erf, and with the tanh approximation).
+ *
+ * All of them are built on one core, e^-a for a >= 0 in 32-bit fixed
+ * point: a * log2(e) = k + f, where k is an integer and 0 <= f < 1, and
+ *   2^-f = 2^(-j / 64) * e^(-r * ln2),  j = floor(64 f),  r = f - j / 64,
+ * where the first factor is taken from a table and the second one is a
+ * cubic polynomial. The divisions of sigmoid, tanh and erfc are done in
+ * fixed point as well, and the results are rounded to the nearest bf16
+ * (ties away from zero) once, as in ln_fixed_bf16.c: chaining the
+ * truncating add_bf16 and mul_bf16 would cost tens of ulp near 1, and
+ * even a correctly rounded bf16 u in gelu_tanh below would cost up to
+ * 290 ulp for x < -4, where e^u magnifies the error of u.
+ *   sigmoid(x) = 1 / (1 + e^-x) = e^x / (1 + e^x)
+ *   tanh(x) = (1 - e^-2x) / (1 + e^-2x)
+ *   gelu_erf(x) = x * Phi(x), where Phi(x) = erfc(-x / sqrt(2)) / 2,
+ *     erfc(z) = t * e^(-z^2 + P(t)), t = 1 / (1 + z / 2) (Numerical
+ *     Recipes' erfcc, with a relative error below 1.2e-7 for all z > 0)
+ *   gelu_tanh(x) = x * sigmoid(u), u = 1.5958 x + 0.07135 x^3
+ *     (= x * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 x^3))) / 2)
+ *
+ * The array versions look the results up from a table of all the 65536
+ * results of each function, which are built once at start-up (by a
+ * constructor, so the array versions are thread-safe; it takes a few
+ * milliseconds), and gather 8 results at a time with AVX2 when the
+ * CPU supports it, as chosen at run time through dispatch_bf16.c.
+ *
+ * Notice: Subnormal inputs are taken as zeros, and results below 2^-126
+ *   are flushed to zero.
+ * Notice: Like dispatch_bf16.c, this unit must not be compiled with
+ *   -march=native.
+ *
+ * Benchmark (x86-64 with AVX2, gcc -O2, best of 3 runs, Melem/s):
+ *   sigmoid: expf 177, sigmoid_bf16 62, sigmoid_bf16_array 4144
+ *   tanh: tanhf 57, tanh_bf16 54, tanh_bf16_array 4002
+ *   gelu (erf): erfcf 112, gelu_erf_bf16 29, gelu_erf_bf16_array 3920
+ * The scalar lookup (BF16_TIER=scalar) runs the array versions at about
+ * 2500 Melem/s; the runs vary by up to 2x on the shared machine.
+ *
+ * Reference: W. H. Press et al., Numerical Recipes in C, 2nd ed., 6.2
+ *
+ * Version: 0.0
+ * Tested: 2026-10-18T21:30:00+08:00
+ */
+
+#ifndef ACT_BF16_C
+#define ACT_BF16_C
+
+#include "bit_cast.h"
+#include "dispatch_bf16.c"
+#include "type_def.h"
+
+// uncomment the following line to test this program
+// #define ACT_BF16_TEST
+#ifdef ACT_BF16_TEST
+#include <math.h>   // exp, tanh, erfc, ldexp, ilogb, fabs
+#include <stdio.h>  // puts, printf
+
+// uncomment the following line to measure the throughput
+// #define ACT_BF16_BENCH
+#ifdef ACT_BF16_BENCH
+#include "bench_time.h"  // seconds, BENCH_MEASURE
+#endif  // ACT_BF16_BENCH
+#endif             // ACT_BF16_TEST
+
+#define ACT_LOG2E_Q32 0x171547653ull  // log2(e) in Q32
+#define ACT_LN2_Q32 0xB17217F8ull     // ln(2) in Q32
+#define ACT_SQRT1_2_Q32 0xB504F334ull  // 1 / sqrt(2) in Q32
+#define ACT_GELU_C1_Q32 0x19884533Dull  // 2 sqrt(2 / pi) in Q32
+#define ACT_GELU_C3_Q32 0x12444F2Aull   // 2 sqrt(2 / pi) * 0.044715 in Q32
+
+/* 2^(-j / 64) in Q31, for j = 0, 1, ..., 63 */
+static const u32 act_exp2_table[64] = {
+    0x80000000, 0x7E9F0606, 0x7D41D96E, 0x7BE86FBA, 0x7A92BE8B, 0x7940BB9E,
+    0x77F25CCE, 0x76A7980F, 0x75606374, 0x741CB528, 0x72DC8374, 0x719FC4B9,
+    0x70666F76, 0x6F307A41, 0x6DFDDBCC, 0x6CCE8AE1, 0x6BA27E65, 0x6A79AD56,
+    0x69540EC9, 0x683199ED, 0x6712460B, 0x65F60A7F, 0x64DCDEC3, 0x63C6BA64,
+    0x62B39509, 0x61A3666D, 0x60962665, 0x5F8BCCDB, 0x5E8451D0, 0x5D7FAD59,
+    0x5C7DD7A4, 0x5B7EC8F2, 0x5A82799A, 0x5988E209, 0x5891FAC1, 0x579DBC57,
+    0x56AC1F75, 0x55BD1CDB, 0x54D0AD5A, 0x53E6C9DA, 0x52FF6B55, 0x521A8AD7,
+    0x51382182, 0x50582888, 0x4F7A9930, 0x4E9F6CD4, 0x4DC69CDD, 0x4CF022CA,
+    0x4C1BF829, 0x4B4A169C, 0x4A7A77D4, 0x49AD1598, 0x48E1E9BA, 0x4818EE22,
+    0x47521CC6, 0x468D6FAE, 0x45CAE0F2, 0x450A6ABB, 0x444C0740, 0x438FB0CB,
+    0x42D561B4, 0x421D1462, 0x4166C34C, 0x40B268FA,
+};
+
+/* the coefficients c0, c1, ..., c9 of P(t) = c0 + c1 t + ... + c9 t^9
+ * in erfc, in Q30
+ */
+static const i32 act_erfc_table[10] = {
+    -0x50FE2702, 0x40006352, 0x17F11F67, 0x0631B646,  -0x0BEC24C1,
+    0x11D8F976,  -0x48A72E98, 0x5F43D811, -0x349E2463, 0x0AEF9458,
+};
+
+/* e^-a, for 0 <= a < 2^8 in Q32.
+ * Returns p, 2^31 < p <= 2^32, and stores k to *k, where
+ * e^-a = p * 2^(-32 - k).
+ */
+u64 act_exp_neg(u64 a, i32 *k) {
+  // z = a * log2(e) in Q32 = k + f
+  u64 z = ((a >> 9) * ACT_LOG2E_Q32) >> 23;
+  u32 f = (u32)z;
+  *k = (i32)(z >> 32);
+
+  // 2^-f = 2^(-j / 64) * e^-s, where s = r * ln2 < 2^-6 in Q32
+  u32 j = f >> 26;
+  u64 s = ((u64)(f & 0x3FFFFFF) * ACT_LN2_Q32) >> 32;
+  u64 s2 = (s * s) >> 32;
+  u64 s3 = (s2 * s) >> 32;
+  u64 e = (1ull << 32) - s + (s2 >> 1) - s3 / 6;  // e^-s in Q32
+  return ((u64)act_exp2_table[j] * e) >> 31;
+}
+
+/* Round m * 2^e (m > 0) to the nearest bf16 (ties away from zero), with
+ * the sign s (0 or 1). Results below 2^-126 are flushed to zero.
+ */
+bf16 act_round(u32 s, u64 m, i32 e) {
+  i32 shift = 63 - __builtin_clzll(m) - 7;  // m >> shift has 8 bits
+  if (shift > 0) {
+    m = (m + (1ull << (shift - 1))) >> shift;
+    if (m == 0x100) {
+      m = 0x80;
+      shift += 1;
+    }
+  } else {
+    m <<= -shift;
+  }
+  i32 be = e + shift + 7 + 127;  // biased exponent
+  if (be <= 0) return as_bf16(s << 31);
+  if (be >= 0xFF) return as_bf16((s << 31) | 0x7F800000);
+  return as_bf16((s << 31) | ((u32)be << 23) | ((u32)(m & 0x7F) << 16));
+}
+
+/* abs(x) in Q32, for abs(x) < 2^8 */
+static inline u64 act_abs_q32(u32 bx) {
+  i32 shift = (i32)((bx >> 23) & 0xFF) - 127 - 7 + 32;
+  u64 m = ((bx >> 16) & 0x7F) | 0x80;
+  return (shift >= 0) ? m << shift : (shift > -64) ? m >> -shift : 0;
+}
+
+/* x * 2^-n in Q62, for x = p * 2^-32 as returned by act_exp_neg */
+static inline u64 act_q62(u64 p, i32 n) {
+  return (n < 64) ? (p << 30) >> n : 0;
+}
+
+/* sigmoid(x), for x = -a if s, or a otherwise, where 0 <= a < 2^8 in Q32.
+ * Returns m, and stores e to *e, where sigmoid(x) = m * 2^e and
+ * m < 2^62.
+ */
+u64 act_sigmoid(u32 s, u64 a, i32 *e) {
+  // d = 1 + e^-a, q = 1 / d in Q32
+  i32 k;
+  u64 p = act_exp_neg(a, &k);
+  u64 d = (1ull << 62) + act_q62(p, k);
+  u64 q = (1ull << 63) / (d >> 31);
+  *e = s ? -62 - k : -32;
+  return s ? (p >> 1) * (q >> 1) : q;  // e^-a / d, or 1 / d
+}
+
+/* Sigmoid function.
+ * Returns 1 / (1 + e^-x), within 1 ulp.
+ *
+ * Input format: bf16
+ * Output format: bf16
+ */
+bf16 sigmoid_bf16(bf16 x) {
+  u32 bx = as_u32(x) & 0xFFFF0000;
+  u32 s = bx >> 31;
+  u32 ex = (bx >> 23) & 0xFF;
+  if ((bx & 0x7FFFFFFF) > 0x7F800000) return as_bf16(0x7FC00000);  // NaN
+  if (ex == 0) return as_bf16(0x3F000000);                        // 0.5
+  if (ex >= 127 + 7) return as_bf16(s ? 0 : 0x3F800000);           // 0, 1
+
+  i32 e;
+  u64 m = act_sigmoid(s, act_abs_q32(bx), &e);
+  return act_round(0, m, e);
+}
+
+/* Hyperbolic tangent.
+ * Returns tanh(x), within 1 ulp.
+ *
+ * Input format: bf16
+ * Output format: bf16
+ */
+bf16 tanh_bf16(bf16 x) {
+  u32 bx = as_u32(x) & 0xFFFF0000;
+  u32 s = bx >> 31;
+  u32 ex = (bx >> 23) & 0xFF;
+  if ((bx & 0x7FFFFFFF) > 0x7F800000) return as_bf16(0x7FC00000);  // NaN
+  if (ex == 0) return as_bf16(s << 31);                           // +-0
+  if (ex < 127 - 10) return as_bf16(bx);  // tanh(x) = x - x^3 / 3 ~= x
+  if (ex >= 127 + 4) return as_bf16((s << 31) | 0x3F800000);  // +-1
+
+  // tanh(abs(x)) = (1 - e) / (1 + e), where e = e^-2abs(x)
+  i32 k;
+  u64 p = act_exp_neg(act_abs_q32(bx) << 1, &k);
+  u64 e = act_q62(p, k);
+  u64 q = (1ull << 63) / (((1ull << 62) + e) >> 31);  // 1 / (1 + e)
+  return act_round(s, (((1ull << 62) - e) >> 31) * q, -63);
+}
+
+/* Gaussian error linear unit, x * Phi(x), where Phi is the cumulative
+ * distribution function of the standard normal distribution.
+ * Returns x * (1 + erf(x / sqrt(2))) / 2, within 1 ulp.
+ *
+ * Input format: bf16
+ * Output format: bf16
+ */
+bf16 gelu_erf_bf16(bf16 x) {
+  u32 bx = as_u32(x) & 0xFFFF0000;
+  u32 s = bx >> 31;
+  u32 ex = (bx >> 23) & 0xFF;
+  if ((bx & 0x7FFFFFFF) > 0x7F800000) return as_bf16(0x7FC00000);  // NaN
+  if (ex <= 1) return as_bf16(s << 31);  // +-0
+  if (ex < 127 - 10) return as_bf16(bx - 0x00800000);  // x / 2
+  if (ex >= 127 + 3 && !s) return as_bf16(bx);     // x
+  if (ex >= 127 + 4) return as_bf16(0x80000000);  // -0
+
+  // z = abs(x) / sqrt(2) in Q24 (z < 12), t = 1 / (1 + z / 2) in Q30
+  u64 z = ((act_abs_q32(bx) >> 8) * ACT_SQRT1_2_Q32) >> 32;
+  u64 t = (1ull << 54) / ((1ull << 24) + (z >> 1));
+
+  // erfc(z) = t * e^-a, where a = z^2 - P(t) in Q32
+  i64 c = act_erfc_table[9];
+  for (int i = 8; i >= 0; i--) c = act_erfc_table[i] + ((c * (i64)t) >> 30);
+  i64 a = (i64)((z * z) >> 16) - c * 4;
+  i32 k;
+  u64 p = act_exp_neg((a > 0) ? (u64)a : 0, &k);
+  u64 erfc = t * p;  // erfc(z) * 2^(62 + k)
+
+  // Phi(x) = erfc(z) / 2 for x < 0, and 1 - erfc(z) / 2 for x >= 0
+  u64 mx = ((bx >> 16) & 0x7F) | 0x80;
+  i32 e = (i32)ex - 127 - 7;  // abs(x) = mx * 2^e
+  if (s) return act_round(1, (erfc >> 8) * mx, e - 62 - k - 1 + 8);
+  u64 phi = (1ull << 62) - ((k < 63) ? erfc >> (k + 1) : 0);  // in Q62
+  return act_round(0, (phi >> 8) * mx, e - 62 + 8);
+}
+
+/* Gaussian error linear unit with the tanh approximation.
+ * Returns x * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 x^3))) / 2, within
+ * 1 ulp.
+ *
+ * Input format: bf16
+ * Output format: bf16
+ */
+bf16 gelu_tanh_bf16(bf16 x) {
+  u32 bx = as_u32(x) & 0xFFFF0000;
+  u32 s = bx >> 31;
+  u32 ex = (bx >> 23) & 0xFF;
+  if ((bx & 0x7FFFFFFF) > 0x7F800000) return as_bf16(0x7FC00000);  // NaN
+  if (ex <= 1) return as_bf16(s << 31);  // +-0
+  if (ex < 127 - 10) return as_bf16(bx - 0x00800000);  // x / 2
+  if (ex >= 127 + 3 && !s) return as_bf16(bx);     // x
+  if (ex >= 127 + 4) return as_bf16(0x80000000);  // -0
+
+  // abs(u) = abs(x) * (c1 + c3 * x^2) in Q32, where abs(x) < 16
+  u64 ax = act_abs_q32(bx) >> 8;  // in Q24
+  u64 w = ACT_GELU_C1_Q32 + ((ACT_GELU_C3_Q32 * ((ax * ax) >> 24)) >> 24);
+  u64 a = (ax * (w >> 8)) >> 16;
+  if (a >= (1ull << 39)) return as_bf16(0x80000000);  // e^-128 * x -> -0
+
+  // x * sigmoid(u)
+  i32 e;
+  u64 m = act_sigmoid(s, a, &e);
+  u64 mx = ((bx >> 16) & 0x7F) | 0x80;
+  return act_round(s, (m >> 8) * mx, e + 8 + (i32)ex - 127 - 7);
+}
+
+// ┌-------------------------------------------------------┐
+// |                     Array versions                    |
+// └-------------------------------------------------------┘
+
+enum { ACT_SIGMOID, ACT_TANH, ACT_GELU_ERF, ACT_GELU_TANH, ACT_N };
+
+/* the upper 16 bits of the results of all the 2^16 bf16 inputs, plus one
+ * entry, so that the last one can be gathered as 32 bits
+ */
+static unsigned short act_table[ACT_N][0x10001];
+
+/* y[i] = table[x[i]] for i < n, where x[i] is taken as its upper 16 bits */
+typedef void (*act_lookup)(const unsigned short *table, const bf16 *x,
+                           bf16 *y, u32 n);
+
+static void act_lookup_scalar(const unsigned short *table, const bf16 *x,
+                              bf16 *y, u32 n) {
+  for (u32 i = 0; i < n; i++)
+    y[i] = as_bf16((u32)table[as_u32(x[i]) >> 16] << 16);
+}
+
+#ifdef DISPATCH_BF16_X86
+/* gathers 8 results at a time */
+DISPATCH_AVX2 static void act_lookup_avx2(const unsigned short *table,
+                                          const bf16 *x, bf16 *y, u32 n) {
+  u32 i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256i b = _mm256_srli_epi32(_mm256_loadu_si256((const __m256i *)(x + i)),
+                                  16);
+    __m256i r = _mm256_i32gather_epi32((const int *)table, b, 2);
+    _mm256_storeu_si256((__m256i *)(y + i), _mm256_slli_epi32(r, 16));
+  }
+  for (; i < n; i++) y[i] = as_bf16((u32)table[as_u32(x[i]) >> 16] << 16);
+}
+#endif  // DISPATCH_BF16_X86
+
+static act_lookup act_lookup_bound = act_lookup_scalar;
+
+/* Build the tables before main, so that they are only read afterwards,
+ * and threads can call the array versions without locking. The AVX2
+ * lookup is bound as well if bf16_dispatch_avx2() of dispatch_bf16.c
+ * says so.
+ */
+__attribute__((constructor)) static void act_table_init() {
+  static bf16 (*const functions[ACT_N])(bf16) = {
+      sigmoid_bf16, tanh_bf16, gelu_erf_bf16, gelu_tanh_bf16};
+  for (int f = 0; f < ACT_N; f++)
+    for (u32 b = 0; b < 0x10000; b++)
+      act_table[f][b] = as_u32(functions[f](as_bf16(b << 16))) >> 16;
+#ifdef DISPATCH_BF16_X86
+  if (bf16_dispatch_avx2()) act_lookup_bound = act_lookup_avx2;
+#endif  // DISPATCH_BF16_X86
+}
+
+/* y[i] = f(x[i]) for i < n, from the table of f. */
+static void act_array(int f, const bf16 *x, bf16 *y, u32 n) {
+  act_lookup_bound(act_table[f], x, y, n);
+}
+
+void sigmoid_bf16_array(const bf16 *x, bf16 *y, u32 n) {
+  act_array(ACT_SIGMOID, x, y, n);
+}
+
+void tanh_bf16_array(const bf16 *x, bf16 *y, u32 n) {
+  act_array(ACT_TANH, x, y, n);
+}
+
+void gelu_erf_bf16_array(const bf16 *x, bf16 *y, u32 n) {
+  act_array(ACT_GELU_ERF, x, y, n);
+}
+
+void gelu_tanh_bf16_array(const bf16 *x, bf16 *y, u32 n) {
+  act_array(ACT_GELU_TANH, x, y, n);
+}
+
+#ifdef ACT_BF16_TEST
+
+/* the exact functions, in double precision */
+double act_sigmoid_exact(double x) { return 1 / (1 + exp(-x)); }
+double act_tanh_exact(double x) { return tanh(x); }
+double act_gelu_erf_exact(double x) { return x * erfc(-x / sqrt(2)) / 2; }
+double act_gelu_tanh_exact(double x) {
+  // x * (1 + tanh(v)) / 2 = x / (1 + e^-2v), without cancellation
+  return x / (1 + exp(-2 * sqrt(2 / M_PI) * (x + 0.044715 * x * x * x)));
+}
+
+/* Returns the largest error, in ulp of the exact results, of f over all
+ * the finite bf16 numbers with normal (or zero) results.
+ */
+double act_max_ulp(bf16 (*f)(bf16), double (*exact)(double)) {
+  double max_ulp = 0;
+  for (u32 b = 0; b < 0x10000; b++) {
+    u32 bx = b << 16;
+    if ((bx & 0x7F800000) == 0x7F800000 || (bx & 0x7F800000) == 0) continue;
+    double t = exact(as_bf16(bx));
+    if (fabs(t) < 0x1p-126) continue;
+    double ulp = ldexp(1, ilogb(t) - 7);
+    double error = fabs(f(as_bf16(bx)) - t) / ulp;
+    if (error > max_ulp) max_ulp = error;
+  }
+  return max_ulp;
+}
+
+/* Test the functionalities in this unit.
+ * Return 0 if successes. Otherwise, return a non-zero number,
+ * which indicates the first failed test.
+ */
+int test_act_bf16() {
+  bf16 r;
+  u32 s;
+
+  // 1: sigmoid(0) = 0.5, sigmoid(1) = 0.7305 (0.7311),
+  //    sigmoid(-20) = 2.063e-9 (2.061e-9)
+  if (as_u32(sigmoid_bf16(as_bf16(0x80000000))) != 0x3F000000) return 1;
+  r = sigmoid_bf16(as_bf16(0x3F800000));  // 0 01111111 0000000
+  s = 0x3F3B0000;                         // 0 01111110 0111011
+  if (as_u32(r) != s) return 1;
+  r = sigmoid_bf16(as_bf16(0xC1A00000));  // 1 10000011 0100000
+  s = 0x310E0000;                         // 0 01100010 0001110
+  if (as_u32(r) != s) return 1;
+
+  // 2: tanh(1) = 0.7617 (0.7616), tanh(-0.01) = -0.01,
+  //    tanh(-100) = -1
+  r = tanh_bf16(as_bf16(0x3F800000));  // 0 01111111 0000000
+  s = 0x3F430000;                      // 0 01111110 1000011
+  if (as_u32(r) != s) return 2;
+  if (as_u32(tanh_bf16(as_bf16(0xBC240000))) != 0xBC240000) return 2;
+  if (as_u32(tanh_bf16(as_bf16(0xC2C80000))) != 0xBF800000) return 2;
+
+  // 3: gelu_erf(1) = 0.8398 (0.8413), gelu_erf(-3) = -0.004059 (-0.004050)
+  r = gelu_erf_bf16(as_bf16(0x3F800000));  // 0 01111111 0000000
+  s = 0x3F570000;                          // 0 01111110 1010111
+  if (as_u32(r) != s) return 3;
+  r = gelu_erf_bf16(as_bf16(0xC0400000));  // 1 10000000 1000000
+  s = 0xBB850000;                          // 1 01110111 0000101
+  if (as_u32(r) != s) return 3;
+
+  // 4: infinity and NaN
+  if (as_u32(sigmoid_bf16(as_bf16(0xFF800000))) != 0) return 4;
+  if (as_u32(tanh_bf16(as_bf16(0x7F800000))) != 0x3F800000) return 4;
+  if (as_u32(gelu_erf_bf16(as_bf16(0x7F800000))) != 0x7F800000) return 4;
+  if (as_u32(gelu_tanh_bf16(as_bf16(0xFF800000))) != 0x80000000) return 4;
+  if (as_u32(tanh_bf16(as_bf16(0xFFC10000))) != 0x7FC00000) return 4;
+
+  // 5: within 1 ulp for all the inputs
+  if (act_max_ulp(sigmoid_bf16, act_sigmoid_exact) > 1) return 5;
+  if (act_max_ulp(tanh_bf16, act_tanh_exact) > 1) return 5;
+  if (act_max_ulp(gelu_erf_bf16, act_gelu_erf_exact) > 1) return 5;
+  if (act_max_ulp(gelu_tanh_bf16, act_gelu_tanh_exact) > 1) return 5;
+
+  // 6: the array versions are identical to the scalar ones
+  static bf16 x[0x10000 + 3], y[0x10000 + 3];
+  for (u32 b = 0; b < 0x10000 + 3; b++) x[b] = as_bf16((b * 0x9E37) << 16);
+  void (*arrays[ACT_N])(const bf16 *, bf16 *, u32) = {
+      sigmoid_bf16_array, tanh_bf16_array, gelu_erf_bf16_array,
+      gelu_tanh_bf16_array};
+  bf16 (*functions[ACT_N])(bf16) = {sigmoid_bf16, tanh_bf16, gelu_erf_bf16,
+                                    gelu_tanh_bf16};
+  for (int f = 0; f < ACT_N; f++) {
+    arrays[f](x, y, 0x10000 + 3);
+    for (u32 i = 0; i < 0x10000 + 3; i++)
+      if (as_u32(y[i]) != as_u32(functions[f](x[i]))) return 6;
+    // and so is the scalar lookup, whichever one is bound
+    act_lookup_scalar(act_table[f], x, y, 0x10000 + 3);
+    for (u32 i = 0; i < 0x10000 + 3; i++)
+      if (as_u32(y[i]) != as_u32(functions[f](x[i]))) return 6;
+  }
+
+  return 0;
+}
+
+#ifdef ACT_BF16_BENCH
+#define ACT_BF16_BENCH_N (1 << 16)
+
+static float bench_x[ACT_BF16_BENCH_N], bench_y[ACT_BF16_BENCH_N];
+
+void tanh_fp32_array(const float *x, float *y, u32 n) {
+  for (u32 i = 0; i < n; i++) y[i] = tanhf(x[i]);
+}
+void sigmoid_fp32_array(const float *x, float *y, u32 n) {
+  for (u32 i = 0; i < n; i++) y[i] = 1 / (1 + expf(-x[i]));
+}
+void gelu_erf_fp32_array(const float *x, float *y, u32 n) {
+  for (u32 i = 0; i < n; i++) y[i] = x[i] * erfcf(-x[i] * 0.70710678f) / 2;
+}
+void sigmoid_bf16_loop(const bf16 *x, bf16 *y, u32 n) {
+  for (u32 i = 0; i < n; i++) y[i] = sigmoid_bf16(x[i]);
+}
+void tanh_bf16_loop(const bf16 *x, bf16 *y, u32 n) {
+  for (u32 i = 0; i < n; i++) y[i] = tanh_bf16(x[i]);
+}
+void gelu_erf_bf16_loop(const bf16 *x, bf16 *y, u32 n) {
+  for (u32 i = 0; i < n; i++) y[i] = gelu_erf_bf16(x[i]);
+}
+
+/* Print the throughput of f in millions of elements per second. */
+void act_measure(const char *name, void (*f)(const float *, float *, u32)) {
+  const int repeat = 100;
+  f(bench_x, bench_y, ACT_BF16_BENCH_N);  // warm up the caches
+  BENCH_MEASURE(ACT_BF16_BENCH_N, repeat,
+                f(bench_x, bench_y, ACT_BF16_BENCH_N), "%-22s", name);
+}
+
+void bench_act_bf16() {
+  for (u32 i = 0; i < ACT_BF16_BENCH_N; i++)
+    bench_x[i] = as_bf16(((i * 0x9E37) % 0x100 + 0x3E00) << 16 |
+                         (i & 1) << 31);  // 0.125 <= abs(x) < 8
+  act_measure("sigmoid_fp32 (expf)", sigmoid_fp32_array);
+  act_measure("sigmoid_bf16", sigmoid_bf16_loop);
+  act_measure("sigmoid_bf16_array", sigmoid_bf16_array);
+  act_measure("tanh_fp32 (tanhf)", tanh_fp32_array);
+  act_measure("tanh_bf16", tanh_bf16_loop);
+  act_measure("tanh_bf16_array", tanh_bf16_array);
+  act_measure("gelu_erf_fp32 (erfcf)", gelu_erf_fp32_array);
+  act_measure("gelu_erf_bf16", gelu_erf_bf16_loop);
+  act_measure("gelu_erf_bf16_array", gelu_erf_bf16_array);
+}
+#endif  // ACT_BF16_BENCH
+
+int main() {
+  int error_code = test_act_bf16();
+  if (error_code != 0) {
+    printf("Test %d for act_bf16.c failed.\n", error_code);
+    return 1;
+  }
+  puts("Test for act_bf16.c passed.");
+
+  printf("%-14s %12s\n", "", "maximal ulp");
+  printf("%-14s %12.2f\n", "sigmoid_bf16",
+         act_max_ulp(sigmoid_bf16, act_sigmoid_exact));
+  printf("%-14s %12.2f\n", "tanh_bf16", act_max_ulp(tanh_bf16, act_tanh_exact));
+  printf("%-14s %12.2f\n", "gelu_erf_bf16",
+         act_max_ulp(gelu_erf_bf16, act_gelu_erf_exact));
+  printf("%-14s %12.2f\n", "gelu_tanh_bf16",
+         act_max_ulp(gelu_tanh_bf16, act_gelu_tanh_exact));
+
+#ifdef ACT_BF16_BENCH
+  bench_act_bf16();
+#endif  // ACT_BF16_BENCH
+  return 0;
+}
+#endif  // ACT_BF16_TEST
+
+#endif  // ACT_BF16_C
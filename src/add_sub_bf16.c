@@ -10,7 +10,7 @@
  * Reference: https://en.wikipedia.org/wiki/Bfloat16_floating-point_format
  *
  * Version: 0.1
- * Tested: 2023-10-07T15:05:00+08:00
+ * Tested: 2026-10-18T14:20:00+08:00
  */
 
 #ifndef ADD_SUB_BF16_C
@@ -22,6 +22,7 @@
 #include <stdio.h>  // puts, printf
 #endif              // ADD_SUB_BF16_TEST
 
+#include "bit_cast.h"
 #include "type_def.h"
 
 // uncomment the following line to see debugging info
@@ -40,8 +41,8 @@
  * Output format: bf16
  */
 bf16 add_sub_bf16(bf16 a, bf16 b, int to_add) {
-  u32 ba = *(u32 *)&a; // must be unsigned
-  u32 bb = *(u32 *)&b; // must be unsigned
+  u32 ba = as_u32(a);  // must be unsigned
+  u32 bb = as_u32(b);  // must be unsigned
   u32 sa = ba & 0x80000000;
   u32 sb = bb & 0x80000000;
   i32 ea = ((ba & 0x7F800000) >> 23) - 127;
@@ -62,13 +63,13 @@ bf16 add_sub_bf16(bf16 a, bf16 b, int to_add) {
   i32 m = 0;  // result mantissa
 
   // normalization: make 2 numbers have the same exponent
-  if (ea >= eb) {
-    e = ea;
-    mb >>= (ea - eb);  // arithmetic right shift
-  } else {
-    e = eb;
-    ma >>= (eb - ea);  // arithmetic right shift
-  }
+  // note: m >> 8 is already 0, and shifting by 32 or more is undefined
+  i32 d = ea - eb;
+  e = (d >= 0) ? ea : eb;
+  d = (d >= 0) ? d : -d;
+  d = (d < 8) ? d : 8;
+  ma >>= (ea >= eb) ? 0 : d;  // arithmetic right shift
+  mb >>= (ea >= eb) ? d : 0;  // arithmetic right shift
 
   // addition or subtraction;
   // make abs(m) <= 0x1FE by implementation.
@@ -80,28 +81,34 @@ bf16 add_sub_bf16(bf16 a, bf16 b, int to_add) {
   m = ma + mb;
 
   // handle negative result
-  if (m < 0) {
-    m = -m;
-    s = 1;
-  } else
-    s = 0;
+  s = (m < 0) ? 1 : 0;
+  m = (m < 0) ? -m : m;
+
+  // note: the steps below shift by 0 or k instead of branching,
+  //       so that loops over this function can be vectorized.
+  i32 k;
 
   // handle carry bit; make m <= 0xFF
-  if (m & 0x100) {
-    m >>= 1;
-    e += 1;
-  }
+  k = (m >> 8) & 1;
+  m >>= k;
+  e += k;
+
+  // handle result < 1; make m >= 0x80 by a binary search for the leading one
+  k = (m < 0x08) ? 4 : 0;
+  m <<= k;
+  e -= k;
+  k = (m < 0x20) ? 2 : 0;
+  m <<= k;
+  e -= k;
+  k = (m < 0x40) ? 1 : 0;
+  m <<= k;
+  e -= k;
+  k = (m < 0x80) ? 1 : 0;
+  m <<= k;
+  e -= k;
 
   // handle result of 0
-  if (m == 0) {
-    e = -127;
-  } else {
-    // handle result < 1
-    while (m < 0x80) {
-      e -= 1;
-      m <<= 1;
-    }
-  }
+  if (m == 0) e = -127;
 
   // construct the result
   s = s << 31;
@@ -112,11 +119,11 @@ bf16 add_sub_bf16(bf16 a, bf16 b, int to_add) {
 #ifdef ADD_SUB_BF16_DEBUG
   printf("(addition result)\n");
   printf("%1s %8s %7s\n", "s", "exp", "mantissa");
-  print_bf16_binary(*(bf16 *)&r);
+  print_bf16_binary(as_bf16(r));
   puts("");
 #endif  // ADD_SUB_BF16_DEBUG
 
-  return *(bf16 *)&r;
+  return as_bf16(r);
 }
 
 /* Addition of two bf16 numbers.
@@ -146,58 +153,62 @@ bf16 sub_bf16(bf16 a, bf16 b) { return add_sub_bf16(a, b, 0); }
 int test_add_sub_bf16() {
   bf16 a, b, r;
   u32 s;
-  u32 *pa = (u32 *)&a;
-  u32 *pb = (u32 *)&b;
-  u32 *pr = (u32 *)&r;
 
   // 1: add, a > 0, b > 0, exp_a == exp_b, exp carry
-  *pa = 0x3F9A0000;  // 0 01111111 0011010
-  *pb = 0x3FB30000;  // 0 01111111 0110011
-  s = 0x40260000;    // 0 10000000 0100110
+  a = as_bf16(0x3F9A0000);  // 0 01111111 0011010
+  b = as_bf16(0x3FB30000);  // 0 01111111 0110011
+  s = 0x40260000;           // 0 10000000 0100110
   r = add_sub_bf16(a, b, 1);
-  if (*pr != s) return 1;
+  if (as_u32(r) != s) return 1;
 
   // 2: add, a > 0, b > 0, exp_a < exp_b , no exp carry
-  *pa = 0x3F9A0000;  // 0 01111111 0011010
-  *pb = 0x40140000;  // 0 10000000 0010100
-  s = 0x40610000;    // 0 10000000 1100001
+  a = as_bf16(0x3F9A0000);  // 0 01111111 0011010
+  b = as_bf16(0x40140000);  // 0 10000000 0010100
+  s = 0x40610000;           // 0 10000000 1100001
   r = add_bf16(a, b);
-  if (*pr != s) return 2;
+  if (as_u32(r) != s) return 2;
 
   // 3: add, a > 0, b > 0, exp_a > exp_n, exp carry
-  *pa = 0x40410000;  // 0 10000000 1000001
-  *pb = 0x3FFF0000;  // 0 01111111 1111111
-  s = 0x40A00000;    // 0 10000001 0100000
+  a = as_bf16(0x40410000);  // 0 10000000 1000001
+  b = as_bf16(0x3FFF0000);  // 0 01111111 1111111
+  s = 0x40A00000;           // 0 10000001 0100000
   r = add_bf16(a, b);
-  if (*pr != s) return 3;
+  if (as_u32(r) != s) return 3;
 
   // 4: add, a < 0, b > 0, (a + b) < 0, exp decreases
-  *pa = 0xC0410000;  // 1 10000000 1000001
-  *pb = 0x3FFF0000;  // 0 01111111 1111111
-  s = 0xBF840000;    // 1 01111111 0000100
+  a = as_bf16(0xC0410000);  // 1 10000000 1000001
+  b = as_bf16(0x3FFF0000);  // 0 01111111 1111111
+  s = 0xBF840000;           // 1 01111111 0000100
   r = add_bf16(a, b);
-  if (*pr != s) return 4;
+  if (as_u32(r) != s) return 4;
 
   // 5: sub, a = b
-  *pa = 0x40000000;  // 0 10000000 0000000
-  *pb = 0x40000000;  // 0 10000000 0000000
-  s = 0;             // 0 00000000 0000000
+  a = as_bf16(0x40000000);  // 0 10000000 0000000
+  b = as_bf16(0x40000000);  // 0 10000000 0000000
+  s = 0;                    // 0 00000000 0000000
   r = add_sub_bf16(a, b, 0);
-  if (*pr != s) return 5;
+  if (as_u32(r) != s) return 5;
 
   // 6: sub, a > 0, b > 0, (a - b) > 0, no exp carry
-  *pa = 0x40450000;  // 0 10000000 1000101
-  *pb = 0x3F7F0000;  // 0 01111110 1111111
-  s = 0x40060000;    // 0 10000000 0000110
+  a = as_bf16(0x40450000);  // 0 10000000 1000101
+  b = as_bf16(0x3F7F0000);  // 0 01111110 1111111
+  s = 0x40060000;           // 0 10000000 0000110
   r = sub_bf16(a, b);
-  if (*pr != s) return 6;
+  if (as_u32(r) != s) return 6;
 
   // 7: sub, a < 0, b > 0, exp_a < exp_b, exp carry
-  *pa = 0xBFC00000;  // 1 01111111 1000000
-  *pb = 0x40400000;  // 0 10000000 1000000
-  s = 0xC0900000;    // 1 10000001 0010000
+  a = as_bf16(0xBFC00000);  // 1 01111111 1000000
+  b = as_bf16(0x40400000);  // 0 10000000 1000000
+  s = 0xC0900000;           // 1 10000001 0010000
   r = sub_bf16(a, b);
-  if (*pr != s) return 7;
+  if (as_u32(r) != s) return 7;
+
+  // 8: add, a > 0, b > 0, exp_a - exp_b >= 32, b is negligible
+  a = as_bf16(0x3F800000);  // 0 01111111 0000000
+  b = as_bf16(0x2F800000);  // 0 01011111 0000000
+  s = 0x3F800000;           // 0 01111111 0000000
+  r = add_bf16(a, b);
+  if (as_u32(r) != s) return 8;
 
   return 0;
 }
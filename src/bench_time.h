@@ -0,0 +1,37 @@
+/*
+ * Wall-clock timing of the throughput benchmarks (the X_BENCH modes) of
+ * the units in this directory.
+ *
+ * The units include each other, so the helpers live here, behind an
+ * include guard, instead of in every unit: two units built with their
+ * benchmarks (e.g. expr_bf16.c, which includes dispatch_bf16.c) would
+ * otherwise define them twice.
+ */
+
+#ifndef BENCH_TIME_H
+#define BENCH_TIME_H
+
+#include <stdio.h>  // printf
+#include <time.h>   // clock_gettime
+
+/* Returns the time of a monotonic clock, in seconds. */
+static inline double seconds() {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/* Print the throughput of `call` in millions of elements per second,
+ * measured over `repeat` calls of n elements, after a label printed
+ * with the printf format and arguments that follow.
+ */
+#define BENCH_MEASURE(n, repeat, call, ...)                       \
+  do {                                                            \
+    double t0 = seconds();                                        \
+    for (int r = 0; r < (repeat); r++) call;                      \
+    double t = seconds() - t0;                                    \
+    printf(__VA_ARGS__);                                          \
+    printf(" %9.1f Melem/s\n", (double)(n) * (repeat) / t / 1e6); \
+  } while (0)
+
+#endif  // BENCH_TIME_H
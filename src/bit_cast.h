@@ -0,0 +1,41 @@
+/*
+ * Reinterpretation of the bits of bf16 (fp32) values as integers,
+ * and vice versa.
+ *
+ * Reading a float through a `u32 *` (e.g. `*(u32 *)&x`) breaks the
+ * strict aliasing rule of C, so an optimizing compiler may reorder or
+ * drop such accesses. memcpy is the well-defined way to do it; for a
+ * fixed size of 4 bytes compilers turn it into a plain register move,
+ * and it does not stop loops over these functions from being inlined
+ * and vectorized.
+ */
+
+#ifndef BIT_CAST_H
+#define BIT_CAST_H
+
+#include <string.h>  // memcpy
+
+#include "type_def.h"
+
+/* Returns the bits of a bf16 (or fp32) number. */
+static inline u32 as_u32(bf16 x) {
+  u32 r;
+  memcpy(&r, &x, sizeof(r));
+  return r;
+}
+
+/* Returns the bits of a bf16 (or fp32) number as a signed integer. */
+static inline i32 as_i32(bf16 x) {
+  i32 r;
+  memcpy(&r, &x, sizeof(r));
+  return r;
+}
+
+/* Returns the bf16 (or fp32) number with the given bits. */
+static inline bf16 as_bf16(u32 x) {
+  bf16 r;
+  memcpy(&r, &x, sizeof(r));
+  return r;
+}
+
+#endif  // BIT_CAST_H
@@ -0,0 +1,975 @@
+/*
+ * This program implements and tests the following functionality:
+ *   Run-time dispatch of bf16 array kernels to the best instruction set
+ *   extension of the running CPU.
+ *
+ * The kernels are
+ *   fp32_to_bf16_array: y[i] = fp32_to_bf16(x[i])
+ *   bf16_to_fp32_array: y[i] = bf16_to_fp32(x[i])
+ *   dot_bf16:           sum of a[i] * b[i], in fp32 (see dot_bf16_scalar)
+ *   ln_bf16_array:      y[i] = ln_bf16(x[i])
+ * and each of them has one version per tier:
+ *   scalar:     the portable C code, for any CPU
+ *   avx2:       AVX2 and FMA
+ *   avx512:     AVX-512 F
+ *   avx512bf16: AVX-512 F and BF16 (vcvtne2ps2bf16, vdpbf16ps)
+ * All the tiers give bit-identical results. The native BF16 instructions
+ * are only used where that holds: vdpbf16ps for the dot product, whose
+ * order of operations and flushing of subnormals are the definition of
+ * dot_bf16. vcvtneps2bf16 rounds ties to even and flushes subnormals,
+ * while fp32_to_bf16 rounds ties away from zero and keeps them, so the
+ * avx512bf16 tier converts with the avx512 code.
+ *
+ * Benchmark (x86-64 with AVX-512 BF16, gcc -O2, 2^16 elements, Melem/s):
+ *   tier        fp32_to_bf16  bf16_to_fp32  dot_bf16  ln_bf16
+ *   scalar               494          1537       4.8     10.5
+ *   avx2                4935          8136      1700     84.5
+ *   avx512              8381          8671      3690      126
+ *   avx512bf16          8497          9166      8091      153
+ *
+ * The CPU features are read once with cpuid (and xgetbv, for whether the
+ * OS saves the vector registers), and the function pointers of the best
+ * supported tier are bound at start-up, by a constructor, so that no
+ * thread ever races to bind them. The environment variable BF16_TIER
+ * (e.g. BF16_TIER=scalar) forces a tier, for testing and benchmarking;
+ * it is read at start-up too, and an unknown or unsupported tier falls
+ * back to the best one.
+ *
+ * Notice: This unit must not be compiled with -march=native (or any
+ *   other -m flag beyond the baseline), otherwise the scalar tier may
+ *   use instructions that the running CPU does not support.
+ *
+ * Version: 0.0
+ * Tested: 2026-10-18T19:30:00+08:00
+ */
+
+#ifndef DISPATCH_BF16_C
+#define DISPATCH_BF16_C
+
+#include <math.h>    // fmaf
+#include <stdlib.h>  // getenv
+#include <string.h>  // strcmp
+
+#include "bit_cast.h"
+#include "fp32_bf16.c"
+#include "ln_bf16.c"
+#include "type_def.h"
+
+// uncomment the following line to test this program
+// #define DISPATCH_BF16_TEST
+#ifdef DISPATCH_BF16_TEST
+#include <stdio.h>  // puts, printf
+
+// uncomment the following line to measure the throughput
+// #define DISPATCH_BF16_BENCH
+#ifdef DISPATCH_BF16_BENCH
+#include "bench_time.h"  // seconds, BENCH_MEASURE
+#endif  // DISPATCH_BF16_BENCH
+#endif             // DISPATCH_BF16_TEST
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define DISPATCH_BF16_X86
+#include <cpuid.h>  // __get_cpuid_count
+#include <immintrin.h>
+#endif  // __x86_64__ && __GNUC__
+
+/* The kernels of one tier. */
+typedef struct {
+  const char *name;
+  void (*fp32_to_bf16)(const float *x, bf16 *y, u32 n);
+  void (*bf16_to_fp32)(const bf16 *x, float *y, u32 n);
+  float (*dot)(const bf16 *a, const bf16 *b, u32 n);
+  void (*ln)(const bf16 *x, bf16 *y, u32 n);
+} bf16_kernels;
+
+// number of fp32 partial sums (lanes) of dot_bf16
+#define DOT_BF16_LANES 16
+
+// ┌-------------------------------------------------------┐
+// |                      Scalar tier                      |
+// └-------------------------------------------------------┘
+
+void fp32_to_bf16_array_scalar(const float *x, bf16 *y, u32 n) {
+  for (u32 i = 0; i < n; i++) y[i] = fp32_to_bf16(x[i]);
+}
+
+void bf16_to_fp32_array_scalar(const bf16 *x, float *y, u32 n) {
+  for (u32 i = 0; i < n; i++) y[i] = bf16_to_fp32(x[i]);
+}
+
+/* A bf16 input of dot_bf16: extra bits removed, and subnormals (which
+ * vdpbf16ps treats as zeros) as zeros.
+ */
+static inline float dot_bf16_input(bf16 x) {
+  u32 bx = as_u32(x) & 0xFFFF0000;
+  if ((bx & 0x7F800000) == 0) bx &= 0x80000000;
+  return as_bf16(bx);
+}
+
+/* Flush a subnormal result to zero, as vdpbf16ps does. */
+static inline float dot_bf16_ftz(float x) {
+  u32 bx = as_u32(x);
+  if ((bx & 0x7F800000) == 0) bx &= 0x80000000;
+  return as_bf16(bx);
+}
+
+/* Reduce the DOT_BF16_LANES partial sums of dot_bf16 pairwise:
+ * lane[j] += lane[j + w], for w = 8, 4, 2, 1.
+ */
+float dot_bf16_reduce(float *lane) {
+  for (u32 w = DOT_BF16_LANES / 2; w >= 1; w /= 2)
+    for (u32 j = 0; j < w; j++) lane[j] += lane[j + w];
+  return lane[0];
+}
+
+/* Dot product of two arrays of n bf16 numbers.
+ * Returns the sum of a[i] * b[i] in fp32, which is defined by the
+ * following order of operations, so that all the tiers agree:
+ * (1) The arrays are split into blocks of 2 * DOT_BF16_LANES elements,
+ *     and the last block is padded with zeros.
+ * (2) In each block, lane j adds a[2j + 1] * b[2j + 1] and then
+ *     a[2j] * b[2j] to its partial sum, each with one rounding (FMA);
+ *     subnormal inputs and subnormal partial sums are taken as zeros.
+ * (3) The partial sums are reduced by dot_bf16_reduce.
+ * The inputs are expected to be finite.
+ */
+float dot_bf16_scalar(const bf16 *a, const bf16 *b, u32 n) {
+  float lane[DOT_BF16_LANES] = {0};
+  for (u32 i = 0; i < n; i += 2 * DOT_BF16_LANES) {
+    for (u32 j = 0; j < DOT_BF16_LANES; j++) {
+      for (u32 k = 2 * j + 2; k-- > 2 * j;) {  // odd, then even
+        float x = (i + k < n) ? dot_bf16_input(a[i + k]) : 0;
+        float y = (i + k < n) ? dot_bf16_input(b[i + k]) : 0;
+        lane[j] = dot_bf16_ftz(fmaf(x, y, lane[j]));
+      }
+    }
+  }
+  return dot_bf16_reduce(lane);
+}
+
+void ln_bf16_array_scalar(const bf16 *x, bf16 *y, u32 n) {
+  for (u32 i = 0; i < n; i++) y[i] = ln_bf16(x[i]);
+}
+
+#ifdef DISPATCH_BF16_X86
+
+// ┌-------------------------------------------------------┐
+// |                       AVX2 tier                       |
+// └-------------------------------------------------------┘
+
+#define DISPATCH_AVX2 __attribute__((target("avx2,fma")))
+
+DISPATCH_AVX2 void fp32_to_bf16_array_avx2(const float *x, bf16 *y, u32 n) {
+  const __m256i mask_exp = _mm256_set1_epi32(0x7F800000);
+  const __m256i mask_se = _mm256_set1_epi32(0xFF800000);
+  const __m256i mask_bf16 = _mm256_set1_epi32(0xFFFF0000);
+  const __m256 inv_256 = _mm256_set1_ps(1.0f / 0x100);
+
+  u32 i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256i bx = _mm256_loadu_si256((const __m256i *)(x + i));
+    // y = x + r, where r = (x with the mantissa cleared) / 256
+    __m256 r = _mm256_castsi256_ps(_mm256_and_si256(bx, mask_se));
+    __m256 s =
+        _mm256_add_ps(_mm256_castsi256_ps(bx), _mm256_mul_ps(r, inv_256));
+    __m256i by = _mm256_and_si256(_mm256_castps_si256(s), mask_bf16);
+    // infinity and NaN are kept as they are
+    __m256i special =
+        _mm256_cmpeq_epi32(_mm256_and_si256(bx, mask_exp), mask_exp);
+    by = _mm256_blendv_epi8(by, bx, special);
+    _mm256_storeu_si256((__m256i *)(y + i), by);
+  }
+  fp32_to_bf16_array_scalar(x + i, y + i, n - i);
+}
+
+DISPATCH_AVX2 void bf16_to_fp32_array_avx2(const bf16 *x, float *y, u32 n) {
+  const __m256 mask_bf16 = _mm256_castsi256_ps(_mm256_set1_epi32(0xFFFF0000));
+  u32 i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm256_storeu_ps(y + i, _mm256_and_ps(_mm256_loadu_ps(x + i), mask_bf16));
+  bf16_to_fp32_array_scalar(x + i, y + i, n - i);
+}
+
+/* dot_bf16_input and dot_bf16_ftz of 8 lanes */
+DISPATCH_AVX2 static inline __m256 dot_bf16_flush_avx2(__m256 x, __m256i mask) {
+  const __m256i mask_exp = _mm256_set1_epi32(0x7F800000);
+  const __m256i mask_sign = _mm256_set1_epi32(0x80000000);
+  __m256i bx = _mm256_and_si256(_mm256_castps_si256(x), mask);
+  __m256i tiny = _mm256_cmpeq_epi32(_mm256_and_si256(bx, mask_exp),
+                                    _mm256_setzero_si256());
+  bx = _mm256_blendv_epi8(bx, _mm256_and_si256(bx, mask_sign), tiny);
+  return _mm256_castsi256_ps(bx);
+}
+
+/* One block of dot_bf16_scalar; lane[j] is in acc[j >> 3], at position
+ * (j & 1) | ((j >> 2 & 1) << 1) | ((j >> 1 & 1) << 2), since
+ * _mm256_shuffle_ps works within each 128-bit half.
+ */
+DISPATCH_AVX2 static inline void dot_bf16_block_avx2(const bf16 *a,
+                                                     const bf16 *b,
+                                                     __m256 acc[2]) {
+  const __m256i mask_bf16 = _mm256_set1_epi32(0xFFFF0000);
+  const __m256i mask_all = _mm256_set1_epi32(0xFFFFFFFF);
+  for (int h = 0; h < 2; h++) {
+    __m256 va[2], vb[2];
+    for (int k = 0; k < 2; k++) {
+      va[k] = dot_bf16_flush_avx2(_mm256_loadu_ps(a + 16 * h + 8 * k),
+                                  mask_bf16);
+      vb[k] = dot_bf16_flush_avx2(_mm256_loadu_ps(b + 16 * h + 8 * k),
+                                  mask_bf16);
+    }
+    __m256 a_odd = _mm256_shuffle_ps(va[0], va[1], 0xDD);
+    __m256 b_odd = _mm256_shuffle_ps(vb[0], vb[1], 0xDD);
+    __m256 a_even = _mm256_shuffle_ps(va[0], va[1], 0x88);
+    __m256 b_even = _mm256_shuffle_ps(vb[0], vb[1], 0x88);
+    acc[h] = dot_bf16_flush_avx2(_mm256_fmadd_ps(a_odd, b_odd, acc[h]),
+                                 mask_all);
+    acc[h] = dot_bf16_flush_avx2(_mm256_fmadd_ps(a_even, b_even, acc[h]),
+                                 mask_all);
+  }
+}
+
+DISPATCH_AVX2 float dot_bf16_avx2(const bf16 *a, const bf16 *b, u32 n) {
+  __m256 acc[2] = {_mm256_setzero_ps(), _mm256_setzero_ps()};
+  u32 i = 0;
+  for (; i + 2 * DOT_BF16_LANES <= n; i += 2 * DOT_BF16_LANES)
+    dot_bf16_block_avx2(a + i, b + i, acc);
+  if (i < n) {  // the last block, padded with zeros
+    bf16 pa[2 * DOT_BF16_LANES] = {0}, pb[2 * DOT_BF16_LANES] = {0};
+    memcpy(pa, a + i, (n - i) * sizeof(bf16));
+    memcpy(pb, b + i, (n - i) * sizeof(bf16));
+    dot_bf16_block_avx2(pa, pb, acc);
+  }
+
+  float t[2][8], lane[DOT_BF16_LANES];
+  _mm256_storeu_ps(t[0], acc[0]);
+  _mm256_storeu_ps(t[1], acc[1]);
+  for (u32 j = 0; j < DOT_BF16_LANES; j++)
+    lane[j] = t[j >> 3][(j & 1) | (j >> 2 & 1) << 1 | (j >> 1 & 1) << 2];
+  return dot_bf16_reduce(lane);
+}
+
+/* mul_bf16 of 8 lanes */
+DISPATCH_AVX2 static inline __m256i mul_bf16_avx2(__m256i ba, __m256i bb) {
+  const __m256i c_exp = _mm256_set1_epi32(0x7F800000);
+  const __m256i c_man = _mm256_set1_epi32(0x007F0000);
+  const __m256i c_127 = _mm256_set1_epi32(127);
+  const __m256i c_80 = _mm256_set1_epi32(0x80);
+  const __m256i c_1 = _mm256_set1_epi32(1);
+  const __m256i c_7f = _mm256_set1_epi32(0x7F);
+  const __m256i zero = _mm256_setzero_si256();
+
+  __m256i s = _mm256_srli_epi32(_mm256_xor_si256(ba, bb), 31);
+  __m256i ea = _mm256_sub_epi32(
+      _mm256_srli_epi32(_mm256_and_si256(ba, c_exp), 23), c_127);
+  __m256i eb = _mm256_sub_epi32(
+      _mm256_srli_epi32(_mm256_and_si256(bb, c_exp), 23), c_127);
+  __m256i ma =
+      _mm256_or_si256(_mm256_srli_epi32(_mm256_and_si256(ba, c_man), 16), c_80);
+  __m256i mb =
+      _mm256_or_si256(_mm256_srli_epi32(_mm256_and_si256(bb, c_man), 16), c_80);
+
+  __m256i e = _mm256_add_epi32(ea, eb);
+  __m256i m = _mm256_srli_epi32(_mm256_mullo_epi32(ma, mb), 7);
+  __m256i k = _mm256_and_si256(_mm256_srli_epi32(m, 8), c_1);
+  m = _mm256_srlv_epi32(m, k);
+  e = _mm256_add_epi32(e, k);
+
+  s = _mm256_slli_epi32(s, 31);
+  e = _mm256_slli_epi32(_mm256_add_epi32(e, c_127), 23);
+  __m256i r = _mm256_or_si256(
+      _mm256_or_si256(s, e), _mm256_slli_epi32(_mm256_and_si256(m, c_7f), 16));
+  r = _mm256_blendv_epi8(r, s, _mm256_cmpeq_epi32(m, zero));
+  __m256i a_or_b_zero = _mm256_or_si256(_mm256_cmpeq_epi32(ba, zero),
+                                        _mm256_cmpeq_epi32(bb, zero));
+  return _mm256_andnot_si256(a_or_b_zero, r);
+}
+
+/* One k-step of add_bf16_avx2 and i32_to_bf16_avx2:
+ * k = (m < lt) ? n : 0; m <<= k; e -= k;
+ */
+#define DISPATCH_AVX2_STEP_LEFT(m, e, lt, n)                                   \
+  do {                                                                         \
+    __m256i k = _mm256_and_si256(                                              \
+        _mm256_cmpgt_epi32(_mm256_set1_epi32(lt), m), _mm256_set1_epi32(n)); \
+    m = _mm256_sllv_epi32(m, k);                                               \
+    e = _mm256_sub_epi32(e, k);                                                \
+  } while (0)
+
+/* add_bf16 of 8 lanes */
+DISPATCH_AVX2 static inline __m256i add_bf16_avx2(__m256i ba, __m256i bb) {
+  const __m256i c_exp = _mm256_set1_epi32(0x7F800000);
+  const __m256i c_man = _mm256_set1_epi32(0x007F0000);
+  const __m256i c_127 = _mm256_set1_epi32(127);
+  const __m256i c_80 = _mm256_set1_epi32(0x80);
+  const __m256i c_1 = _mm256_set1_epi32(1);
+  const __m256i c_7f = _mm256_set1_epi32(0x7F);
+  const __m256i zero = _mm256_setzero_si256();
+
+  __m256i ea = _mm256_sub_epi32(
+      _mm256_srli_epi32(_mm256_and_si256(ba, c_exp), 23), c_127);
+  __m256i eb = _mm256_sub_epi32(
+      _mm256_srli_epi32(_mm256_and_si256(bb, c_exp), 23), c_127);
+  __m256i ma =
+      _mm256_or_si256(_mm256_srli_epi32(_mm256_and_si256(ba, c_man), 16), c_80);
+  __m256i mb =
+      _mm256_or_si256(_mm256_srli_epi32(_mm256_and_si256(bb, c_man), 16), c_80);
+
+  // normalization
+  __m256i a_lt_b = _mm256_cmpgt_epi32(eb, ea);
+  __m256i e = _mm256_max_epi32(ea, eb);
+  __m256i d = _mm256_min_epi32(_mm256_abs_epi32(_mm256_sub_epi32(ea, eb)),
+                               _mm256_set1_epi32(8));
+  ma = _mm256_srav_epi32(ma, _mm256_and_si256(a_lt_b, d));
+  mb = _mm256_srav_epi32(mb, _mm256_andnot_si256(a_lt_b, d));
+
+  // addition
+  ma = _mm256_sign_epi32(ma, _mm256_or_si256(ba, c_1));  // negate if sa
+  mb = _mm256_sign_epi32(mb, _mm256_or_si256(bb, c_1));  // negate if sb
+  __m256i m = _mm256_add_epi32(ma, mb);
+
+  // negative result
+  __m256i s = _mm256_srli_epi32(m, 31);
+  m = _mm256_abs_epi32(m);
+
+  // carry and leading one
+  __m256i k = _mm256_and_si256(_mm256_srli_epi32(m, 8), c_1);
+  m = _mm256_srlv_epi32(m, k);
+  e = _mm256_add_epi32(e, k);
+  DISPATCH_AVX2_STEP_LEFT(m, e, 0x08, 4);
+  DISPATCH_AVX2_STEP_LEFT(m, e, 0x20, 2);
+  DISPATCH_AVX2_STEP_LEFT(m, e, 0x40, 1);
+  DISPATCH_AVX2_STEP_LEFT(m, e, 0x80, 1);
+  e = _mm256_blendv_epi8(e, _mm256_set1_epi32(-127),
+                         _mm256_cmpeq_epi32(m, zero));
+
+  s = _mm256_slli_epi32(s, 31);
+  e = _mm256_slli_epi32(_mm256_add_epi32(e, c_127), 23);
+  m = _mm256_slli_epi32(_mm256_and_si256(m, c_7f), 16);
+  return _mm256_or_si256(_mm256_or_si256(s, e), m);
+}
+
+/* i32_to_bf16 of 8 lanes, for -2^24 < x < 2^24 */
+DISPATCH_AVX2 static inline __m256i i32_to_bf16_avx2(__m256i x) {
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i s = _mm256_slli_epi32(_mm256_srli_epi32(x, 31), 31);
+  __m256i e = _mm256_set1_epi32(7);
+  __m256i m = _mm256_abs_epi32(x);
+  DISPATCH_AVX2_STEP_LEFT(m, e, 0x08, 4);
+  DISPATCH_AVX2_STEP_LEFT(m, e, 0x20, 2);
+  DISPATCH_AVX2_STEP_LEFT(m, e, 0x40, 1);
+  DISPATCH_AVX2_STEP_LEFT(m, e, 0x80, 1);
+  // k = (m >= t) ? n : 0; m >>= k; e += k;
+  static const i32 t[5][2] = {
+      {0x10000, 8}, {0x1000, 4}, {0x400, 2}, {0x200, 1}, {0x100, 1}};
+  for (int i = 0; i < 5; i++) {
+    __m256i k = _mm256_andnot_si256(
+        _mm256_cmpgt_epi32(_mm256_set1_epi32(t[i][0]), m),
+        _mm256_set1_epi32(t[i][1]));
+    m = _mm256_srlv_epi32(m, k);
+    e = _mm256_add_epi32(e, k);
+  }
+  e = _mm256_slli_epi32(_mm256_add_epi32(e, _mm256_set1_epi32(127)), 23);
+  m = _mm256_slli_epi32(_mm256_and_si256(m, _mm256_set1_epi32(0x7F)), 16);
+  __m256i r = _mm256_or_si256(_mm256_or_si256(s, e), m);
+  return _mm256_andnot_si256(_mm256_cmpeq_epi32(x, zero), r);
+}
+
+DISPATCH_AVX2 void ln_bf16_array_avx2(const bf16 *x, bf16 *y, u32 n) {
+  const __m256i lnc0 = _mm256_set1_epi32(0xBFBF0000);  // -1.49
+  const __m256i lnc1 = _mm256_set1_epi32(0x40070000);  // 2.11
+  const __m256i lnc2 = _mm256_set1_epi32(0xBF3B0000);  // -0.73
+  const __m256i lnc3 = _mm256_set1_epi32(0x3DE10000);  // 0.109
+  const __m256i ln2 = _mm256_set1_epi32(0x3F310000);   // 0.69
+  const __m256i one = _mm256_set1_epi32(0x3F800000);
+  const __m256i c_127 = _mm256_set1_epi32(127);
+
+  u32 i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256i bx = _mm256_loadu_si256((const __m256i *)(x + i));
+    bx = _mm256_and_si256(bx, _mm256_set1_epi32(0x7FFF0000));
+    __m256i exp =
+        i32_to_bf16_avx2(_mm256_sub_epi32(_mm256_srli_epi32(bx, 23), c_127));
+    __m256i xm = _mm256_or_si256(
+        one, _mm256_and_si256(bx, _mm256_set1_epi32(0x7F0000)));
+    __m256i t = add_bf16_avx2(lnc2, mul_bf16_avx2(lnc3, xm));
+    t = add_bf16_avx2(lnc1, mul_bf16_avx2(t, xm));
+    t = add_bf16_avx2(lnc0, mul_bf16_avx2(t, xm));
+    t = add_bf16_avx2(t, mul_bf16_avx2(ln2, exp));
+    t = _mm256_blendv_epi8(t, _mm256_set1_epi32(0xFF800000),
+                           _mm256_cmpeq_epi32(bx, _mm256_setzero_si256()));
+    _mm256_storeu_si256((__m256i *)(y + i), t);
+  }
+  ln_bf16_array_scalar(x + i, y + i, n - i);
+}
+
+// ┌-------------------------------------------------------┐
+// |                      AVX-512 tier                     |
+// └-------------------------------------------------------┘
+
+#define DISPATCH_AVX512 __attribute__((target("avx512f")))
+
+DISPATCH_AVX512 void fp32_to_bf16_array_avx512(const float *x, bf16 *y,
+                                               u32 n) {
+  const __m512i mask_exp = _mm512_set1_epi32(0x7F800000);
+  const __m512i mask_se = _mm512_set1_epi32(0xFF800000);
+  const __m512i mask_bf16 = _mm512_set1_epi32(0xFFFF0000);
+  const __m512 inv_256 = _mm512_set1_ps(1.0f / 0x100);
+
+  u32 i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m512i bx = _mm512_loadu_si512(x + i);
+    __m512 r = _mm512_castsi512_ps(_mm512_and_si512(bx, mask_se));
+    __m512 s =
+        _mm512_add_ps(_mm512_castsi512_ps(bx), _mm512_mul_ps(r, inv_256));
+    __m512i by = _mm512_and_si512(_mm512_castps_si512(s), mask_bf16);
+    __mmask16 special =
+        _mm512_cmpeq_epi32_mask(_mm512_and_si512(bx, mask_exp), mask_exp);
+    by = _mm512_mask_blend_epi32(special, by, bx);
+    _mm512_storeu_si512(y + i, by);
+  }
+  fp32_to_bf16_array_scalar(x + i, y + i, n - i);
+}
+
+DISPATCH_AVX512 void bf16_to_fp32_array_avx512(const bf16 *x, float *y,
+                                               u32 n) {
+  const __m512i mask_bf16 = _mm512_set1_epi32(0xFFFF0000);
+  u32 i = 0;
+  for (; i + 16 <= n; i += 16)
+    _mm512_storeu_si512(y + i,
+                        _mm512_and_si512(_mm512_loadu_si512(x + i), mask_bf16));
+  bf16_to_fp32_array_scalar(x + i, y + i, n - i);
+}
+
+/* dot_bf16_input and dot_bf16_ftz of 16 lanes */
+DISPATCH_AVX512 static inline __m512 dot_bf16_flush_avx512(__m512 x,
+                                                           __m512i mask) {
+  const __m512i mask_exp = _mm512_set1_epi32(0x7F800000);
+  const __m512i mask_sign = _mm512_set1_epi32(0x80000000);
+  __m512i bx = _mm512_and_si512(_mm512_castps_si512(x), mask);
+  __mmask16 tiny = _mm512_testn_epi32_mask(bx, mask_exp);
+  bx = _mm512_mask_and_epi32(bx, tiny, bx, mask_sign);
+  return _mm512_castsi512_ps(bx);
+}
+
+/* One block of dot_bf16_scalar; lane[j] is in acc at position j. */
+DISPATCH_AVX512 static inline __m512 dot_bf16_block_avx512(const bf16 *a,
+                                                           const bf16 *b,
+                                                           __m512 acc) {
+  const __m512i mask_bf16 = _mm512_set1_epi32(0xFFFF0000);
+  const __m512i mask_all = _mm512_set1_epi32(0xFFFFFFFF);
+  const __m512i odd = _mm512_setr_epi32(1, 3, 5, 7, 9, 11, 13, 15, 17, 19,
+                                        21, 23, 25, 27, 29, 31);
+  const __m512i even = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18,
+                                         20, 22, 24, 26, 28, 30);
+  __m512 a0 = dot_bf16_flush_avx512(_mm512_loadu_ps(a), mask_bf16);
+  __m512 a1 = dot_bf16_flush_avx512(_mm512_loadu_ps(a + 16), mask_bf16);
+  __m512 b0 = dot_bf16_flush_avx512(_mm512_loadu_ps(b), mask_bf16);
+  __m512 b1 = dot_bf16_flush_avx512(_mm512_loadu_ps(b + 16), mask_bf16);
+  acc = _mm512_fmadd_ps(_mm512_permutex2var_ps(a0, odd, a1),
+                        _mm512_permutex2var_ps(b0, odd, b1), acc);
+  acc = dot_bf16_flush_avx512(acc, mask_all);
+  acc = _mm512_fmadd_ps(_mm512_permutex2var_ps(a0, even, a1),
+                        _mm512_permutex2var_ps(b0, even, b1), acc);
+  return dot_bf16_flush_avx512(acc, mask_all);
+}
+
+DISPATCH_AVX512 float dot_bf16_avx512(const bf16 *a, const bf16 *b, u32 n) {
+  __m512 acc = _mm512_setzero_ps();
+  u32 i = 0;
+  for (; i + 2 * DOT_BF16_LANES <= n; i += 2 * DOT_BF16_LANES)
+    acc = dot_bf16_block_avx512(a + i, b + i, acc);
+  if (i < n) {  // the last block, padded with zeros
+    bf16 pa[2 * DOT_BF16_LANES] = {0}, pb[2 * DOT_BF16_LANES] = {0};
+    memcpy(pa, a + i, (n - i) * sizeof(bf16));
+    memcpy(pb, b + i, (n - i) * sizeof(bf16));
+    acc = dot_bf16_block_avx512(pa, pb, acc);
+  }
+
+  float lane[DOT_BF16_LANES];
+  _mm512_storeu_ps(lane, acc);
+  return dot_bf16_reduce(lane);
+}
+
+/* mul_bf16 of 16 lanes */
+DISPATCH_AVX512 static inline __m512i mul_bf16_avx512(__m512i ba,
+                                                      __m512i bb) {
+  const __m512i c_exp = _mm512_set1_epi32(0x7F800000);
+  const __m512i c_man = _mm512_set1_epi32(0x007F0000);
+  const __m512i c_127 = _mm512_set1_epi32(127);
+  const __m512i c_80 = _mm512_set1_epi32(0x80);
+  const __m512i c_1 = _mm512_set1_epi32(1);
+  const __m512i c_7f = _mm512_set1_epi32(0x7F);
+  const __m512i zero = _mm512_setzero_si512();
+
+  __m512i s = _mm512_srli_epi32(_mm512_xor_si512(ba, bb), 31);
+  __m512i ea = _mm512_sub_epi32(
+      _mm512_srli_epi32(_mm512_and_si512(ba, c_exp), 23), c_127);
+  __m512i eb = _mm512_sub_epi32(
+      _mm512_srli_epi32(_mm512_and_si512(bb, c_exp), 23), c_127);
+  __m512i ma =
+      _mm512_or_si512(_mm512_srli_epi32(_mm512_and_si512(ba, c_man), 16), c_80);
+  __m512i mb =
+      _mm512_or_si512(_mm512_srli_epi32(_mm512_and_si512(bb, c_man), 16), c_80);
+
+  __m512i e = _mm512_add_epi32(ea, eb);
+  __m512i m = _mm512_srli_epi32(_mm512_mullo_epi32(ma, mb), 7);
+  __m512i k = _mm512_and_si512(_mm512_srli_epi32(m, 8), c_1);
+  m = _mm512_srlv_epi32(m, k);
+  e = _mm512_add_epi32(e, k);
+
+  s = _mm512_slli_epi32(s, 31);
+  e = _mm512_slli_epi32(_mm512_add_epi32(e, c_127), 23);
+  __m512i r = _mm512_or_si512(
+      _mm512_or_si512(s, e), _mm512_slli_epi32(_mm512_and_si512(m, c_7f), 16));
+  r = _mm512_mask_blend_epi32(_mm512_cmpeq_epi32_mask(m, zero), r, s);
+  __mmask16 a_or_b_zero =
+      _mm512_cmpeq_epi32_mask(ba, zero) | _mm512_cmpeq_epi32_mask(bb, zero);
+  return _mm512_maskz_mov_epi32(~a_or_b_zero, r);
+}
+
+/* One k-step of add_bf16_avx512 and i32_to_bf16_avx512:
+ * k = (m < lt) ? n : 0; m <<= k; e -= k;
+ */
+#define DISPATCH_AVX512_STEP_LEFT(m, e, lt, n)                            \
+  do {                                                                    \
+    __m512i k = _mm512_maskz_mov_epi32(                                   \
+        _mm512_cmplt_epi32_mask(m, _mm512_set1_epi32(lt)),                \
+        _mm512_set1_epi32(n));                                            \
+    m = _mm512_sllv_epi32(m, k);                                          \
+    e = _mm512_sub_epi32(e, k);                                           \
+  } while (0)
+
+/* add_bf16 of 16 lanes */
+DISPATCH_AVX512 static inline __m512i add_bf16_avx512(__m512i ba,
+                                                      __m512i bb) {
+  const __m512i c_exp = _mm512_set1_epi32(0x7F800000);
+  const __m512i c_man = _mm512_set1_epi32(0x007F0000);
+  const __m512i c_127 = _mm512_set1_epi32(127);
+  const __m512i c_80 = _mm512_set1_epi32(0x80);
+  const __m512i c_1 = _mm512_set1_epi32(1);
+  const __m512i c_7f = _mm512_set1_epi32(0x7F);
+  const __m512i zero = _mm512_setzero_si512();
+
+  __m512i ea = _mm512_sub_epi32(
+      _mm512_srli_epi32(_mm512_and_si512(ba, c_exp), 23), c_127);
+  __m512i eb = _mm512_sub_epi32(
+      _mm512_srli_epi32(_mm512_and_si512(bb, c_exp), 23), c_127);
+  __m512i ma =
+      _mm512_or_si512(_mm512_srli_epi32(_mm512_and_si512(ba, c_man), 16), c_80);
+  __m512i mb =
+      _mm512_or_si512(_mm512_srli_epi32(_mm512_and_si512(bb, c_man), 16), c_80);
+
+  // normalization
+  __mmask16 a_lt_b = _mm512_cmplt_epi32_mask(ea, eb);
+  __m512i e = _mm512_max_epi32(ea, eb);
+  __m512i d = _mm512_min_epi32(_mm512_abs_epi32(_mm512_sub_epi32(ea, eb)),
+                               _mm512_set1_epi32(8));
+  ma = _mm512_srav_epi32(ma, _mm512_maskz_mov_epi32(a_lt_b, d));
+  mb = _mm512_srav_epi32(mb, _mm512_maskz_mov_epi32(~a_lt_b, d));
+
+  // addition
+  ma = _mm512_mask_sub_epi32(ma, _mm512_cmplt_epi32_mask(ba, zero), zero, ma);
+  mb = _mm512_mask_sub_epi32(mb, _mm512_cmplt_epi32_mask(bb, zero), zero, mb);
+  __m512i m = _mm512_add_epi32(ma, mb);
+
+  // negative result
+  __m512i s = _mm512_srli_epi32(m, 31);
+  m = _mm512_abs_epi32(m);
+
+  // carry and leading one
+  __m512i k = _mm512_and_si512(_mm512_srli_epi32(m, 8), c_1);
+  m = _mm512_srlv_epi32(m, k);
+  e = _mm512_add_epi32(e, k);
+  DISPATCH_AVX512_STEP_LEFT(m, e, 0x08, 4);
+  DISPATCH_AVX512_STEP_LEFT(m, e, 0x20, 2);
+  DISPATCH_AVX512_STEP_LEFT(m, e, 0x40, 1);
+  DISPATCH_AVX512_STEP_LEFT(m, e, 0x80, 1);
+  e = _mm512_mask_mov_epi32(e, _mm512_cmpeq_epi32_mask(m, zero),
+                            _mm512_set1_epi32(-127));
+
+  s = _mm512_slli_epi32(s, 31);
+  e = _mm512_slli_epi32(_mm512_add_epi32(e, c_127), 23);
+  m = _mm512_slli_epi32(_mm512_and_si512(m, c_7f), 16);
+  return _mm512_or_si512(_mm512_or_si512(s, e), m);
+}
+
+/* i32_to_bf16 of 16 lanes, for -2^24 < x < 2^24 */
+DISPATCH_AVX512 static inline __m512i i32_to_bf16_avx512(__m512i x) {
+  __m512i s = _mm512_slli_epi32(_mm512_srli_epi32(x, 31), 31);
+  __m512i e = _mm512_set1_epi32(7);
+  __m512i m = _mm512_abs_epi32(x);
+  DISPATCH_AVX512_STEP_LEFT(m, e, 0x08, 4);
+  DISPATCH_AVX512_STEP_LEFT(m, e, 0x20, 2);
+  DISPATCH_AVX512_STEP_LEFT(m, e, 0x40, 1);
+  DISPATCH_AVX512_STEP_LEFT(m, e, 0x80, 1);
+  // k = (m >= t) ? n : 0; m >>= k; e += k;
+  static const i32 t[5][2] = {
+      {0x10000, 8}, {0x1000, 4}, {0x400, 2}, {0x200, 1}, {0x100, 1}};
+  for (int i = 0; i < 5; i++) {
+    __m512i k = _mm512_maskz_mov_epi32(
+        _mm512_cmpge_epi32_mask(m, _mm512_set1_epi32(t[i][0])),
+        _mm512_set1_epi32(t[i][1]));
+    m = _mm512_srlv_epi32(m, k);
+    e = _mm512_add_epi32(e, k);
+  }
+  e = _mm512_slli_epi32(_mm512_add_epi32(e, _mm512_set1_epi32(127)), 23);
+  m = _mm512_slli_epi32(_mm512_and_si512(m, _mm512_set1_epi32(0x7F)), 16);
+  __m512i r = _mm512_or_si512(_mm512_or_si512(s, e), m);
+  return _mm512_maskz_mov_epi32(_mm512_test_epi32_mask(x, x), r);
+}
+
+DISPATCH_AVX512 void ln_bf16_array_avx512(const bf16 *x, bf16 *y, u32 n) {
+  const __m512i lnc0 = _mm512_set1_epi32(0xBFBF0000);  // -1.49
+  const __m512i lnc1 = _mm512_set1_epi32(0x40070000);  // 2.11
+  const __m512i lnc2 = _mm512_set1_epi32(0xBF3B0000);  // -0.73
+  const __m512i lnc3 = _mm512_set1_epi32(0x3DE10000);  // 0.109
+  const __m512i ln2 = _mm512_set1_epi32(0x3F310000);   // 0.69
+  const __m512i one = _mm512_set1_epi32(0x3F800000);
+  const __m512i c_127 = _mm512_set1_epi32(127);
+
+  u32 i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m512i bx = _mm512_loadu_si512(x + i);
+    bx = _mm512_and_si512(bx, _mm512_set1_epi32(0x7FFF0000));
+    __m512i exp =
+        i32_to_bf16_avx512(_mm512_sub_epi32(_mm512_srli_epi32(bx, 23), c_127));
+    __m512i xm = _mm512_or_si512(
+        one, _mm512_and_si512(bx, _mm512_set1_epi32(0x7F0000)));
+    __m512i t = add_bf16_avx512(lnc2, mul_bf16_avx512(lnc3, xm));
+    t = add_bf16_avx512(lnc1, mul_bf16_avx512(t, xm));
+    t = add_bf16_avx512(lnc0, mul_bf16_avx512(t, xm));
+    t = add_bf16_avx512(t, mul_bf16_avx512(ln2, exp));
+    t = _mm512_mask_mov_epi32(t, _mm512_testn_epi32_mask(bx, bx),
+                              _mm512_set1_epi32(0xFF800000));
+    _mm512_storeu_si512(y + i, t);
+  }
+  ln_bf16_array_scalar(x + i, y + i, n - i);
+}
+
+// ┌-------------------------------------------------------┐
+// |                   AVX-512 BF16 tier                   |
+// └-------------------------------------------------------┘
+
+#define DISPATCH_AVX512BF16 __attribute__((target("avx512f,avx512bf16")))
+
+/* One block of dot_bf16_scalar with vdpbf16ps, which adds the products of
+ * the odd and then the even elements of each pair to the lane (FMA, with
+ * subnormal inputs and results as zeros). vcvtne2ps2bf16 packs the
+ * inputs; it is exact after the extra bits are removed, and it also
+ * takes subnormals as zeros.
+ */
+DISPATCH_AVX512BF16 static inline __m512 dot_bf16_block_avx512bf16(
+    const bf16 *a, const bf16 *b, __m512 acc) {
+  const __m512i mask_bf16 = _mm512_set1_epi32(0xFFFF0000);
+#define DISPATCH_LOAD_BF16(p) \
+  _mm512_castsi512_ps(_mm512_and_si512(_mm512_loadu_si512(p), mask_bf16))
+  __m512 a0 = DISPATCH_LOAD_BF16(a), a1 = DISPATCH_LOAD_BF16(a + 16);
+  __m512 b0 = DISPATCH_LOAD_BF16(b), b1 = DISPATCH_LOAD_BF16(b + 16);
+#undef DISPATCH_LOAD_BF16
+  return _mm512_dpbf16_ps(acc, _mm512_cvtne2ps_pbh(a1, a0),
+                          _mm512_cvtne2ps_pbh(b1, b0));
+}
+
+DISPATCH_AVX512BF16 float dot_bf16_avx512bf16(const bf16 *a, const bf16 *b,
+                                              u32 n) {
+  __m512 acc = _mm512_setzero_ps();
+  u32 i = 0;
+  for (; i + 2 * DOT_BF16_LANES <= n; i += 2 * DOT_BF16_LANES)
+    acc = dot_bf16_block_avx512bf16(a + i, b + i, acc);
+  if (i < n) {  // the last block, padded with zeros
+    bf16 pa[2 * DOT_BF16_LANES] = {0}, pb[2 * DOT_BF16_LANES] = {0};
+    memcpy(pa, a + i, (n - i) * sizeof(bf16));
+    memcpy(pb, b + i, (n - i) * sizeof(bf16));
+    acc = dot_bf16_block_avx512bf16(pa, pb, acc);
+  }
+
+  float lane[DOT_BF16_LANES];
+  _mm512_storeu_ps(lane, acc);
+  return dot_bf16_reduce(lane);
+}
+
+#endif  // DISPATCH_BF16_X86
+
+// ┌-------------------------------------------------------┐
+// |                        Dispatch                       |
+// └-------------------------------------------------------┘
+
+enum {
+  BF16_TIER_SCALAR,
+  BF16_TIER_AVX2,
+  BF16_TIER_AVX512,
+  BF16_TIER_AVX512BF16,
+  BF16_N_TIERS
+};
+
+static const bf16_kernels bf16_tiers[BF16_N_TIERS] = {
+    {"scalar", fp32_to_bf16_array_scalar, bf16_to_fp32_array_scalar,
+     dot_bf16_scalar, ln_bf16_array_scalar},
+#ifdef DISPATCH_BF16_X86
+    {"avx2", fp32_to_bf16_array_avx2, bf16_to_fp32_array_avx2, dot_bf16_avx2,
+     ln_bf16_array_avx2},
+    {"avx512", fp32_to_bf16_array_avx512, bf16_to_fp32_array_avx512,
+     dot_bf16_avx512, ln_bf16_array_avx512},
+    {"avx512bf16", fp32_to_bf16_array_avx512, bf16_to_fp32_array_avx512,
+     dot_bf16_avx512bf16, ln_bf16_array_avx512},
+#endif  // DISPATCH_BF16_X86
+};
+
+/* Returns whether the running CPU (and OS) supports the tier. */
+int bf16_tier_supported(int tier) {
+  if (tier == BF16_TIER_SCALAR) return 1;
+#ifdef DISPATCH_BF16_X86
+  u32 a, b, c, d;
+  if (!__get_cpuid_count(1, 0, &a, &b, &c, &d)) return 0;
+  int avx = (c >> 28) & 1, fma = (c >> 12) & 1, osxsave = (c >> 27) & 1;
+  if (!osxsave) return 0;
+
+  // the OS saves the YMM (bits 1, 2) and ZMM (bits 5, 6, 7) registers
+  u32 xcr0_lo, xcr0_hi;
+  __asm__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+  int os_ymm = (xcr0_lo & 0x06) == 0x06;
+  int os_zmm = (xcr0_lo & 0xE6) == 0xE6;
+
+  if (!__get_cpuid_count(7, 0, &a, &b, &c, &d)) return 0;
+  int avx2 = (b >> 5) & 1, avx512f = (b >> 16) & 1;
+  int avx512bf16 = 0;
+  if (a >= 1 && __get_cpuid_count(7, 1, &a, &b, &c, &d))
+    avx512bf16 = (a >> 5) & 1;
+
+  switch (tier) {
+    case BF16_TIER_AVX2:
+      return avx && fma && avx2 && os_ymm;
+    case BF16_TIER_AVX512:
+      return avx512f && os_zmm;
+    case BF16_TIER_AVX512BF16:
+      return avx512f && avx512bf16 && os_zmm;
+  }
+#endif  // DISPATCH_BF16_X86
+  return 0;
+}
+
+/* Returns the kernels of the tier named `name` if it is supported,
+ * otherwise (or if name is NULL) the ones of the best supported tier.
+ */
+const bf16_kernels *bf16_kernels_for(const char *name) {
+  int best = BF16_TIER_SCALAR;
+  for (int t = 0; t < BF16_N_TIERS; t++) {
+    if (!bf16_tiers[t].name || !bf16_tier_supported(t)) continue;
+    if (name && strcmp(name, bf16_tiers[t].name) == 0) return &bf16_tiers[t];
+    best = t;
+  }
+  return &bf16_tiers[best];
+}
+
+// the kernels bound at start-up; written once before main, and only read
+// afterwards, so that threads can call the kernels without locking
+static const bf16_kernels *bf16_bound = NULL;
+
+__attribute__((constructor)) static void bf16_dispatch_init() {
+  bf16_bound = bf16_kernels_for(getenv("BF16_TIER"));
+}
+
+/* Returns the kernels bound at start-up, as chosen by
+ * bf16_kernels_for(getenv("BF16_TIER")). Before that (e.g. from another
+ * constructor), it chooses them again at every call without binding them.
+ */
+const bf16_kernels *bf16_dispatch() {
+  return bf16_bound ? bf16_bound : bf16_kernels_for(getenv("BF16_TIER"));
+}
+
+/* Returns whether the other units (e.g. expr_bf16.c) should run their
+ * AVX2 copies of a loop: the kernels are not the scalar ones (which
+ * BF16_TIER=scalar forces) and the CPU supports AVX2.
+ */
+int bf16_dispatch_avx2() {
+  return bf16_dispatch() != &bf16_tiers[BF16_TIER_SCALAR] &&
+         bf16_tier_supported(BF16_TIER_AVX2);
+}
+
+void fp32_to_bf16_array(const float *x, bf16 *y, u32 n) {
+  bf16_dispatch()->fp32_to_bf16(x, y, n);
+}
+
+void bf16_to_fp32_array(const bf16 *x, float *y, u32 n) {
+  bf16_dispatch()->bf16_to_fp32(x, y, n);
+}
+
+float dot_bf16(const bf16 *a, const bf16 *b, u32 n) {
+  return bf16_dispatch()->dot(a, b, n);
+}
+
+void ln_bf16_array(const bf16 *x, bf16 *y, u32 n) {
+  bf16_dispatch()->ln(x, y, n);
+}
+
+#ifdef DISPATCH_BF16_TEST
+
+#define DISPATCH_BF16_TEST_N 1031  // not a multiple of any vector width
+
+/* a small, fixed pseudo-random generator (xorshift) */
+static u32 dispatch_rng_state = 32;
+u32 dispatch_rng() {
+  dispatch_rng_state ^= dispatch_rng_state << 13;
+  dispatch_rng_state ^= dispatch_rng_state >> 17;
+  dispatch_rng_state ^= dispatch_rng_state << 5;
+  return dispatch_rng_state;
+}
+
+/* Fill x with n random finite numbers, with all the 32 bits random and
+ * exponents in [127 + e - 8, 127 + e + 7], some of them replaced by
+ * zeros and subnormals.
+ */
+void dispatch_random(float *x, u32 n, i32 e) {
+  for (u32 i = 0; i < n; i++) {
+    u32 r = dispatch_rng();
+    u32 b = (r & 0x807FFFFF) | ((u32)(127 + e - 8 + (r >> 27)) << 23);
+    if (r % 37 == 0) b &= 0x80000000;  // +-0
+    if (r % 41 == 0) b &= 0x807FFFFF;  // subnormal
+    x[i] = as_bf16(b);
+  }
+}
+
+/* Returns whether two arrays have identical bits. */
+int dispatch_same(const float *x, const float *y, u32 n) {
+  return memcmp(x, y, n * sizeof(float)) == 0;
+}
+
+/* Test the functionalities in this unit.
+ * Return 0 if successes. Otherwise, return a non-zero number,
+ * which indicates the first failed test.
+ */
+int test_dispatch_bf16() {
+  static float x[DISPATCH_BF16_TEST_N], w[DISPATCH_BF16_TEST_N];
+  static float y[DISPATCH_BF16_TEST_N], z[DISPATCH_BF16_TEST_N];
+  static const u32 lengths[] = {0, 1, 7, 8, 15, 16, 31, 32, 33, 100,
+                                DISPATCH_BF16_TEST_N};
+
+  // 1: the scalar tier is always supported, the kernels bound at start-up
+  //    follow BF16_TIER (try `BF16_TIER=scalar ./dispatch_bf16`), and so
+  //    does the choice of the AVX2 loops of the other units
+  if (strcmp(bf16_kernels_for("scalar")->name, "scalar") != 0) return 1;
+  if (bf16_dispatch() != bf16_kernels_for(getenv("BF16_TIER"))) return 1;
+  if (bf16_dispatch() == &bf16_tiers[BF16_TIER_SCALAR] && bf16_dispatch_avx2())
+    return 1;
+
+  // 2: unknown tiers fall back to the best one
+  if (bf16_kernels_for("sse9") != bf16_kernels_for(NULL)) return 2;
+
+  // 3: dot({1, 2, 3}, {4, 5, 6}) = 32
+  x[0] = 1, x[1] = 2, x[2] = 3;
+  w[0] = 4, w[1] = 5, w[2] = 6;
+  if (dot_bf16_scalar(x, w, 3) != 32) return 3;
+
+  // 4: 2^-100 * 2^-30 is subnormal in fp32, so it is flushed to 0
+  x[0] = as_bf16(0x0D800000);  // 2^-100
+  w[0] = as_bf16(0x30800000);  // 2^-30
+  if (as_u32(dot_bf16_scalar(x, w, 1)) != 0) return 4;
+
+  // 5: dot of 64 ones with the lanes reduced pairwise
+  for (u32 i = 0; i < 64; i++) x[i] = w[i] = 1;
+  if (dot_bf16_scalar(x, w, 64) != 64) return 5;
+
+  for (int t = 1; t < BF16_N_TIERS; t++) {
+    if (!bf16_tiers[t].name || !bf16_tier_supported(t)) continue;
+    const bf16_kernels *k = &bf16_tiers[t];
+
+    // 6: conversions are identical to the scalar ones, including zeros,
+    //    subnormals, infinity, NaN and ties
+    for (i32 e = -120; e <= 120; e += 30) {
+      dispatch_random(x, DISPATCH_BF16_TEST_N, e);
+      x[0] = as_bf16(0x7F800000), x[1] = as_bf16(0xFFC12345);
+      x[2] = as_bf16(0x3F808000), x[3] = as_bf16(0x7F7FFFFF);
+      for (u32 i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        u32 n = lengths[i];
+        fp32_to_bf16_array_scalar(x, y, n);
+        k->fp32_to_bf16(x, z, n);
+        if (!dispatch_same(y, z, n)) return 6;
+        bf16_to_fp32_array_scalar(x, y, n);
+        k->bf16_to_fp32(x, z, n);
+        if (!dispatch_same(y, z, n)) return 6;
+      }
+    }
+
+    // 7: dot products are identical to the scalar ones,
+    //    also when the products or the sums are subnormal
+    for (i32 e = -64; e <= 64; e += 16) {
+      dispatch_random(x, DISPATCH_BF16_TEST_N, e);
+      dispatch_random(w, DISPATCH_BF16_TEST_N, -e / 2 - 2);
+      for (u32 i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        u32 n = lengths[i];
+        float r = dot_bf16_scalar(x, w, n);
+        float s = k->dot(x, w, n);
+        if (as_u32(r) != as_u32(s)) return 7;
+      }
+    }
+
+    // 8: ln_bf16 of all the 2^16 bf16 numbers is identical to the scalar
+    //    one; 2^16 is split into the lengths above
+    for (u32 i = 0; i < DISPATCH_BF16_TEST_N; i++)
+      x[i] = as_bf16(i * 0x10000 + dispatch_rng() % 0x10000);
+    for (u32 i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+      u32 n = lengths[i];
+      ln_bf16_array_scalar(x, y, n);
+      k->ln(x, z, n);
+      if (!dispatch_same(y, z, n)) return 8;
+    }
+    for (u32 b = 0; b < 0x10000; b += DISPATCH_BF16_TEST_N) {
+      u32 n = (0x10000 - b < DISPATCH_BF16_TEST_N) ? 0x10000 - b
+                                                  : DISPATCH_BF16_TEST_N;
+      for (u32 i = 0; i < n; i++) x[i] = as_bf16((b + i) << 16);
+      ln_bf16_array_scalar(x, y, n);
+      k->ln(x, z, n);
+      if (!dispatch_same(y, z, n)) return 8;
+    }
+  }
+
+  return 0;
+}
+
+#ifdef DISPATCH_BF16_BENCH
+void bench_dispatch_bf16() {
+  const u32 n = 1 << 16;
+  const int repeat = 200;
+  static float x[1 << 16], w[1 << 16], y[1 << 16];
+  volatile float sink;
+  dispatch_random(x, n, 0);
+  dispatch_random(w, n, 0);
+
+  for (int t = 0; t < BF16_N_TIERS; t++) {
+    if (!bf16_tiers[t].name || !bf16_tier_supported(t)) continue;
+    const bf16_kernels *k = &bf16_tiers[t];
+    BENCH_MEASURE(n, repeat, k->fp32_to_bf16(x, y, n), "%-12s %-20s",
+                  k->name, "fp32_to_bf16_array");
+    BENCH_MEASURE(n, repeat, k->bf16_to_fp32(x, y, n), "%-12s %-20s",
+                  k->name, "bf16_to_fp32_array");
+    BENCH_MEASURE(n, repeat, sink = k->dot(x, w, n), "%-12s %-20s",
+                  k->name, "dot_bf16");
+    BENCH_MEASURE(n, repeat, k->ln(x, y, n), "%-12s %-20s", k->name,
+                  "ln_bf16_array");
+  }
+  (void)sink;
+}
+#endif  // DISPATCH_BF16_BENCH
+
+int main() {
+  int error_code = test_dispatch_bf16();
+  if (error_code == 0) {
+    puts("Test for dispatch_bf16.c passed.");
+  } else {
+    printf("Test %d for dispatch_bf16.c failed.\n", error_code);
+    return 1;
+  }
+  for (int t = 0; t < BF16_N_TIERS; t++)
+    if (bf16_tiers[t].name)
+      printf("%-12s %s\n", bf16_tiers[t].name,
+             bf16_tier_supported(t) ? "supported" : "not supported");
+
+#ifdef DISPATCH_BF16_BENCH
+  bench_dispatch_bf16();
+#endif  // DISPATCH_BF16_BENCH
+  return 0;
+}
+#endif  // DISPATCH_BF16_TEST
+
+#endif  // DISPATCH_BF16_C
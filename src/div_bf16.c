@@ -0,0 +1,263 @@
+/*
+ * This program implements and tests the following functionality:
+ *   Reciprocal and division of bf16 numbers.
+ *
+ * RV32I has no divide instruction, so the reciprocal of the mantissa
+ * 1.f in [1, 2) is seeded from a 16-entry table indexed by the upper 4
+ * bits of f, and refined by one Newton step in the form
+ *   y = y + y * (1 - m * y),
+ * with mul_bf16, sub_bf16 and add_bf16; the correction y * (1 - m * y) is
+ * small, so the final addition loses less than y * (2 - m * y) would.
+ * The exponent is negated separately.
+ *
+ * a / b = a * (1 / b) is also calculated on the mantissas, so that neither
+ * the reciprocal nor the product can overflow or underflow on the way.
+ * As mul_bf16 truncates, the product alone is up to 2.2 ulp off and
+ * misses half of the exact quotients (e.g. 6 / 3 = 1.992); so a second
+ * Newton step is taken on the quotient itself,
+ *   q = q + y * (a - b * q),
+ * which brings it within 1.5 ulp.
+ *
+ * Subnormal inputs are treated as zeros, and results below 2^-126 are
+ * flushed to zeros, like the other units.
+ *
+ * Reference: https://en.wikipedia.org/wiki/Division_algorithm
+ *            (Newton–Raphson division)
+ *
+ * Version: 0.0
+ * Tested: 2026-10-18T21:40:00+08:00
+ */
+
+#ifndef DIV_BF16_C
+#define DIV_BF16_C
+
+#include "add_sub_bf16.c"
+#include "bit_cast.h"
+#include "mul_bf16.c"
+#include "type_def.h"
+
+// uncomment the following line to test this program
+// #define DIV_BF16_TEST
+#ifdef DIV_BF16_TEST
+#include <math.h>   // fabs, ldexp, ilogb
+#include <stdio.h>  // puts, printf
+#endif              // DIV_BF16_TEST
+
+// the initial guesses of 1 / 1.f, indexed by the upper 4 bits of f;
+// each one is found by an exhaustive search of the bf16 numbers in
+// [0.5, 1] for the smallest error after the Newton step over its 8
+// mantissas, and then for the most correctly rounded results
+static const u32 recip_bf16_table[16] = {
+    0x3F730000, 0x3F650000, 0x3F530000, 0x3F4B0000,  // 1.0000 ~ 1.2422
+    0x3F420000, 0x3F380000, 0x3F410000, 0x3F2D0000,  // 1.2500 ~ 1.4922
+    0x3F220000, 0x3F1C0000, 0x3F170000, 0x3F120000,  // 1.5000 ~ 1.7422
+    0x3F1D0000, 0x3F060000, 0x3F120000, 0x3F000000,  // 1.7500 ~ 1.9922
+};
+
+/* Reciprocal of the mantissa of a bf16 number (its sign and exponent are
+ * ignored), i.e., 1 / 1.f in (0.5, 1], within 1 ulp.
+ *
+ * Input format: bf16
+ * Output format: bf16
+ */
+bf16 recip_mantissa_bf16(u32 bx) {
+  bf16 m = as_bf16(0x3F800000 | (bx & 0x007F0000));  // 1.f
+  bf16 y = as_bf16(recip_bf16_table[(bx >> 19) & 0xF]);
+
+  // one Newton step: y = y + y * (1 - m * y)
+  bf16 e = sub_bf16(as_bf16(0x3F800000), mul_bf16(m, y));  // e is small
+  return add_bf16(y, mul_bf16(y, e));
+}
+
+/* Reciprocal of a bf16 number.
+ * Returns 1 / x, within 1 ulp for the normal numbers.
+ * Returns +-inf for +-0, +-0 for +-inf and for |1 / x| < 2^-126, and NaN
+ * for NaN.
+ *
+ * Input format: bf16
+ * Output format: bf16
+ */
+bf16 recip_bf16(bf16 x) {
+  u32 bx = as_u32(x) & 0xFFFF0000;  // remove extra bits
+  u32 s = bx & 0x80000000;
+  i32 ex = (bx >> 23) & 0xFF;
+
+  // handle NaN, +-inf and +-0
+  if (ex == 0xFF) return as_bf16((bx & 0x007F0000) ? 0x7FC00000 : s);
+  if (ex == 0) return as_bf16(s | 0x7F800000);
+
+  // 1 / (1.f * 2^(ex - 127)) = (1 / 1.f) * 2^(127 - ex)
+  u32 by = as_u32(recip_mantissa_bf16(bx));
+  i32 e = ((by >> 23) & 0xFF) + 127 - ex;
+  if (e <= 0) return as_bf16(s);  // underflow; e < 0xFF always
+  return as_bf16(s | e << 23 | (by & 0x007F0000));
+}
+
+/* Division of two bf16 numbers.
+ * Returns a / b = a * (1 / b), within 1.5 ulp for the normal numbers.
+ * Returns NaN for 0 / 0, inf / inf and NaN operands, +-inf for x / 0,
+ * inf / x and overflow, and +-0 for 0 / x, x / inf and underflow.
+ *
+ * Input format: bf16
+ * Output format: bf16
+ */
+bf16 div_bf16(bf16 a, bf16 b) {
+  u32 ba = as_u32(a) & 0xFFFF0000;  // remove extra bits
+  u32 bb = as_u32(b) & 0xFFFF0000;
+  u32 s = (ba ^ bb) & 0x80000000;
+  i32 ea = (ba >> 23) & 0xFF;
+  i32 eb = (bb >> 23) & 0xFF;
+
+  // handle NaN, +-inf and +-0
+  if ((ea == 0xFF && (ba & 0x007F0000)) || (eb == 0xFF && (bb & 0x007F0000)))
+    return as_bf16(0x7FC00000);  // NaN / x, x / NaN
+  if (ea == 0xFF)
+    return as_bf16(eb == 0xFF ? 0x7FC00000 : s | 0x7F800000);  // inf / x
+  if (eb == 0xFF) return as_bf16(s);                            // x / inf
+  if (eb == 0)
+    return as_bf16(ea == 0 ? 0x7FC00000 : s | 0x7F800000);  // x / 0
+  if (ea == 0) return as_bf16(s);                           // 0 / x
+
+  // q = 1.fa / 1.fb in (0.5, 2), and then add the exponents back
+  bf16 ma = as_bf16(0x3F800000 | (ba & 0x007F0000));
+  bf16 mb = as_bf16(0x3F800000 | (bb & 0x007F0000));
+  bf16 y = recip_mantissa_bf16(bb);
+  bf16 q = mul_bf16(ma, y);
+
+  // the second Newton step, on q: q = q + y * (ma - mb * q)
+  bf16 r = sub_bf16(ma, mul_bf16(mb, q));  // r is small
+  q = add_bf16(q, mul_bf16(r, y));
+  i32 e = ((as_u32(q) >> 23) & 0xFF) + ea - eb;
+  if (e >= 0xFF) return as_bf16(s | 0x7F800000);  // overflow
+  if (e <= 0) return as_bf16(s);                   // underflow
+  return as_bf16(s | e << 23 | (as_u32(q) & 0x007F0000));
+}
+
+#ifdef DIV_BF16_TEST
+/* Error of r against the exact x in ulp of x.
+ */
+double ulp_error_div_bf16(bf16 r, double x) {
+  return fabs(r - x) / ldexp(1, ilogb(x) - 7);
+}
+
+/* Test the functionalities in this unit.
+ * Return 0 if successes. Otherwise, return a non-zero number,
+ * which indicates the first failed test.
+ */
+int test_div_bf16() {
+  bf16 r;
+  u32 s;
+
+  // 1: recip(2) = 0.5
+  r = recip_bf16(as_bf16(0x40000000));  // 0 10000000 0000000
+  s = 0x3F000000;                       // 0 01111110 0000000
+  if (as_u32(r) != s) return 1;
+
+  // 2: recip(-3) = -0.3320 (-0.33333)
+  r = recip_bf16(as_bf16(0xC0400000));  // 1 10000000 1000000
+  s = 0xBEAA0000;                       // 1 01111101 0101010
+  if (as_u32(r) != s) return 2;
+
+  // 3: recip(+-0) = +-inf, recip(+-inf) = +-0, recip(NaN) = NaN,
+  //    recip(2^127) = 0 (underflow)
+  r = recip_bf16(as_bf16(0x80000000));  // 1 00000000 0000000
+  if (as_u32(r) != 0xFF800000) return 3;
+  r = recip_bf16(as_bf16(0x7F800000));  // 0 11111111 0000000
+  if (as_u32(r) != 0x00000000) return 3;
+  r = recip_bf16(as_bf16(0xFF800000));  // 1 11111111 0000000
+  if (as_u32(r) != 0x80000000) return 3;
+  r = recip_bf16(as_bf16(0x7FC10000));  // 0 11111111 1000001
+  if (as_u32(r) != 0x7FC00000) return 3;
+  r = recip_bf16(as_bf16(0x7F000000));  // 0 11111110 0000000
+  if (as_u32(r) != 0x00000000) return 3;
+
+  // 4: 6 / 3 = 2, 1 / 10 = 0.1001 (0.1), -7 / 0.5 = -14
+  r = div_bf16(as_bf16(0x40C00000), as_bf16(0x40400000));
+  s = 0x40000000;  // 0 10000000 0000000
+  if (as_u32(r) != s) return 4;
+  r = div_bf16(as_bf16(0x3F800000), as_bf16(0x41200000));
+  s = 0x3DCD0000;  // 0 01111011 1001101
+  if (as_u32(r) != s) return 4;
+  r = div_bf16(as_bf16(0xC0E00000), as_bf16(0x3F000000));
+  s = 0xC1600000;  // 1 10000010 1100000
+  if (as_u32(r) != s) return 4;
+
+  // 5: 0 / 0 = inf / inf = NaN, -1 / 0 = -inf, -inf / 2 = -inf,
+  //    -0 / 2 = -0, 1 / -inf = -0
+  r = div_bf16(as_bf16(0x00000000), as_bf16(0x80000000));
+  if (as_u32(r) != 0x7FC00000) return 5;
+  r = div_bf16(as_bf16(0x7F800000), as_bf16(0xFF800000));
+  if (as_u32(r) != 0x7FC00000) return 5;
+  r = div_bf16(as_bf16(0xBF800000), as_bf16(0x00000000));
+  if (as_u32(r) != 0xFF800000) return 5;
+  r = div_bf16(as_bf16(0xFF800000), as_bf16(0x40000000));
+  if (as_u32(r) != 0xFF800000) return 5;
+  r = div_bf16(as_bf16(0x80000000), as_bf16(0x40000000));
+  if (as_u32(r) != 0x80000000) return 5;
+  r = div_bf16(as_bf16(0x3F800000), as_bf16(0xFF800000));
+  if (as_u32(r) != 0x80000000) return 5;
+
+  // 6: 2^127 / 0.5 = inf (overflow), 2^-126 / 4 = 0 (underflow)
+  r = div_bf16(as_bf16(0x7F000000), as_bf16(0x3F000000));
+  if (as_u32(r) != 0x7F800000) return 6;
+  r = div_bf16(as_bf16(0x00800000), as_bf16(0x40800000));
+  if (as_u32(r) != 0x00000000) return 6;
+
+  // 7: all the bf16 numbers; the normal results are within 1 ulp
+  for (u32 b = 0; b < 0x10000; b++) {
+    bf16 x = as_bf16(b << 16);
+    double t = 1.0 / x;
+    r = recip_bf16(x);
+    if (x != x) {
+      if (as_u32(r) != 0x7FC00000) return 7;
+    } else if ((b & 0x7F80) == 0 || (b & 0x7F80) == 0x7F80 ||
+               fabs(t) < 0x1p-126) {
+      if (as_u32(r) != (as_u32(x) & 0x80000000 ? 0x80000000 : 0) +
+                           ((b & 0x7F80) == 0 ? 0x7F800000 : 0))
+        return 7;
+    } else if (ulp_error_div_bf16(r, t) > 1) {
+      return 7;
+    }
+  }
+
+  // 8: all the pairs of mantissas (and signs), which decide the error;
+  //    all the pairs of exponents, which decide overflow and underflow
+  for (u32 i = 0; i < 0x10000; i++) {
+    u32 ba = (i >> 14 & 1) << 31 | 0x3F800000 | (i & 0x7F) << 16;
+    u32 bb = (i >> 15 & 1) << 31 | 0x3F800000 | (i >> 7 & 0x7F) << 16;
+    double t = (double)as_bf16(ba) / as_bf16(bb);
+    if (ulp_error_div_bf16(div_bf16(as_bf16(ba), as_bf16(bb)), t) > 1.5)
+      return 8;
+  }
+  for (u32 ea = 1; ea < 0xFF; ea++) {
+    for (u32 eb = 1; eb < 0xFF; eb++) {
+      for (u32 f = 0; f < 0x80; f += 0x7F) {
+        u32 ba = ea << 23 | f << 16;
+        u32 bb = eb << 23 | (0x7F - f) << 16;
+        double t = (double)as_bf16(ba) / as_bf16(bb);
+        r = div_bf16(as_bf16(ba), as_bf16(bb));
+        if (t >= 0x1p128 || t < 0x1p-126) {
+          if (as_u32(r) != (t >= 0x1p128 ? 0x7F800000 : 0)) return 8;
+        } else if (ulp_error_div_bf16(r, t) > 1.5) {
+          return 8;
+        }
+      }
+    }
+  }
+
+  return 0;
+}
+
+int main() {
+  int error_code = test_div_bf16();
+  if (error_code == 0) {
+    puts("Test for div_bf16.c passed.");
+    return 0;
+  } else {
+    printf("Test %d for div_bf16.c failed.\n", error_code);
+    return 1;
+  }
+}
+#endif  // DIV_BF16_TEST
+
+#endif  // DIV_BF16_C
@@ -3,13 +3,14 @@
  *   Natural logarithm of fp32 and bf16 numbers.
  *
  * Version: 0.2
- * Tested: 2023-10-07T22:39:00+08:00
+ * Tested: 2026-10-18T14:20:00+08:00
  */
 
 #ifndef LN_BF16_C
 #define LN_BF16_C
 
 #include "add_sub_bf16.c"
+#include "bit_cast.h"
 #include "i32_bf16.c"
 #include "mul_bf16.c"
 #include "type_def.h"
@@ -41,22 +42,19 @@
  * Reference: https://quadst.rip/ln-approx.html
  */
 float ln_fp32(float x) {
-  i32 *px = (i32 *)&x;
+  i32 bx = as_i32(x);
 
   // catch zero
-  if (*px == 0) {
-    *px = 0xFF800000;  // -inf
-    return *(bf16 *)px;
-  }
+  if (bx == 0) return as_bf16(0xFF800000);  // -inf
 
   // discard x's sign
-  *px &= 0x7FFFFFFF;
+  bx &= 0x7FFFFFFF;
 
   // get exponent
-  i32 exp = (*px >> 23) - 127;
+  i32 exp = (bx >> 23) - 127;
 
   // set x's exponent to 0, which is 127 after normalization.
-  *px = 0x3F800000 | (*px & 0x7FFFFF);
+  x = as_bf16(0x3F800000 | (bx & 0x7FFFFF));
 
   return -1.49278 + (2.11263 + (-0.729104 + 0.10969 * x) * x) * x +
          0.6931471806 * exp;
@@ -81,26 +79,19 @@ bf16 ln_bf16(bf16 x) {
   const u32 u_ln2 = 0x3F310000;   // 0.69
 
   // constants for this function in the precision of bf16
-  const bf16 lnc0 = *(bf16 *)&u_lnc0;  // -1.49
-  const bf16 lnc1 = *(bf16 *)&u_lnc1;  // 2.11
-  const bf16 lnc2 = *(bf16 *)&u_lnc2;  // -0.73
-  const bf16 lnc3 = *(bf16 *)&u_lnc3;  // 0.109
-  const bf16 ln2 = *(bf16 *)&u_ln2;    // 0.69
+  const bf16 lnc0 = as_bf16(u_lnc0);  // -1.49
+  const bf16 lnc1 = as_bf16(u_lnc1);  // 2.11
+  const bf16 lnc2 = as_bf16(u_lnc2);  // -0.73
+  const bf16 lnc3 = as_bf16(u_lnc3);  // 0.109
+  const bf16 ln2 = as_bf16(u_ln2);    // 0.69
 
-  u32 *px = (u32 *)&x;
   // remove extra bits (otherwise, offset-by-one bug occurs)
-  *px = *px & 0x7FFF0000;
-
-  // catch zero
-  if (*px == 0) {
-    *px = 0xFF800000;
-    return *(bf16 *)px;
-  }
+  u32 bx = as_u32(x) & 0x7FFF0000;
 
-  bf16 exp = i32_to_bf16(((*px & 0x7F800000) >> 23) - 127);
+  bf16 exp = i32_to_bf16(((bx & 0x7F800000) >> 23) - 127);
 
   // set x's exponent to 0, which is 127 after normalization.
-  *px = 0x3F800000 | (*px & 0x7F0000);
+  x = as_bf16(0x3F800000 | (bx & 0x7F0000));
 
   // return lnc0 + (lnc1 + (lnc2 + lnc3 * x) * x) * x + ln2 * exp;
   bf16 t;
@@ -108,6 +99,9 @@ bf16 ln_bf16(bf16 x) {
   t = add_bf16(lnc1, mul_bf16(t, x));     // t = lnc1 + t * x
   t = add_bf16(lnc0, mul_bf16(t, x));     // t = lnc0 + t * x
   t = add_bf16(t, mul_bf16(ln2, exp));    // t = t + ln2 * exp
+
+  // catch zero
+  if (bx == 0) t = as_bf16(0xFF800000);  // -inf
   return t;
 }
 
@@ -122,8 +116,8 @@ void print_fp32_bf16_comparison_header() {
 
 void print_fp32_bf16_comparison_row(float x, float t, float f, bf16 b) {
   bf16 bf_in = fp32_to_bf16(x);
-  printf("%4.2f, %5s%08X, %6.3f, ", x, "0x", *(u32 *)&bf_in, t);
-  printf("%10.3f, %10.3f, %8s%08X, ", f, b, "0x", *(u32 *)&b);
+  printf("%4.2f, %5s%08X, %6.3f, ", x, "0x", as_u32(bf_in), t);
+  printf("%10.3f, %10.3f, %8s%08X, ", f, b, "0x", as_u32(b));
   printf("%7.3f\n", t - b);
 }
 #endif  // LN_BF16_GENERATE_DATASET
@@ -0,0 +1,238 @@
+/*
+ * This program implements and tests the following functionality:
+ *   Natural logarithm of bf16 numbers in 32-bit fixed point.
+ *
+ * ln|x| = (e + log2(m)) * ln2, where x = m * 2^e and 1 <= m < 2.
+ * log2(m) is found digit by digit, like CORDIC: m is multiplied by
+ * (1 + 2^-k) for k = 1, 2, ..., 8 whenever the product stays <= 2, and
+ * the logarithms of the factors are taken from a table. Then the
+ * exponent is added as an integer, the sum is multiplied by ln2 in fixed
+ * point, and the result is rounded and packed once.
+ *
+ * Only shifts, additions and comparisons are needed (the multiplication
+ * by ln2 is by a constant), so that the RV32I implementation
+ * (asm/ln_fixed_bf16.s) needs neither the soft bf16 add/mul nor a
+ * multiplication routine.
+ *
+ * Notice: This function only works with normal numbers (i.e., x > 2^-126).
+ *
+ * Version: 0.0
+ * Tested: 2026-10-18T15:40:00+08:00
+ */
+
+#ifndef LN_FIXED_BF16_C
+#define LN_FIXED_BF16_C
+
+#include "bit_cast.h"
+#include "type_def.h"
+
+// uncomment the following line to test this program
+// #define LN_FIXED_BF16_TEST
+#ifdef LN_FIXED_BF16_TEST
+#include <math.h>   // fabsf, logf, isfinite
+#include <stdio.h>  // puts, printf
+
+#include "fp32_bf16.c"
+#include "ln_bf16.c"  // the Remez version, for comparison
+#endif                // LN_FIXED_BF16_TEST
+
+/* log2(1 + 2^-k) in Q24 (i.e., scaled by 2^24), for k = 1, 2, ..., 8 */
+static const u32 ln_fixed_log2_table[8] = {
+    0x0095C01A, 0x005269E1, 0x002B8034, 0x001663F7,
+    0x000B5D6A, 0x0005B9E6, 0x0002DFCA, 0x0001709C,
+};
+
+/* ln(abs(x))
+ * Returns ln(abs(x)), rounded to the nearest bf16 (ties away from zero),
+ * within about 0.5 ulp.
+ *
+ * Input format: bf16
+ * Output format: bf16
+ */
+bf16 ln_fixed_bf16(bf16 x) {
+  // remove sign and extra bits
+  u32 bx = as_u32(x) & 0x7FFF0000;
+
+  // catch zero
+  if (bx == 0) return as_bf16(0xFF800000);  // -inf
+
+  i32 e = (i32)(bx >> 23) - 127;
+
+  // f = log2(m) in Q24, 0 <= f < 2^24, with z = m in Q30.
+  // after the factors are taken, 2 / (1 + 2^-8) < z <= 2, and
+  //   log2(m) = 1 - (sum of the log2(1 + 2^-k) taken) - log2(2 / z),
+  //   where log2(2 / z) ~= (2 - z) / 2 / ln2 ~= (2 - z) / 2 * 1.4375.
+  u32 f = 0;
+  u32 z = ((bx & 0x7F0000) << 7) | 0x40000000;
+  if (z != 0x40000000) {  // log2(1.0) = 0 exactly
+    f = 1 << 24;
+    for (int k = 1; k <= 8; k++) {
+      u32 t = z + (z >> k);
+      if (t <= 0x80000000) {
+        z = t;
+        f -= ln_fixed_log2_table[k - 1];
+      }
+    }
+    u32 d = (0x80000000 - z) >> 7;  // (2 - z) / 2 in Q24
+    f -= d + (d >> 1) - (d >> 4);
+  }
+
+  // l = abs(log2(x)) in Q24, s = sign of log2(x)
+  u32 s = (e < 0) ? 0x80000000 : 0;
+  u32 l = (e < 0) ? ((u32)-e << 24) - f : ((u32)e << 24) + f;
+
+  // catch one
+  if (l == 0) return as_bf16(0);
+
+  // normalization: make 0x8000 <= l < 0x10000, where l = l' * 2^k;
+  // smaller bits are dropped (floored).
+  // note: abs(log2(x)) >= log2(256 / 255) > 2^-8, so l >= 2^16 here.
+  i32 k = 0;
+  if (l >= 0x1000000) {
+    l >>= 8;
+    k += 8;
+  }
+  if (l >= 0x100000) {
+    l >>= 4;
+    k += 4;
+  }
+  if (l >= 0x40000) {
+    l >>= 2;
+    k += 2;
+  }
+  if (l >= 0x20000) {
+    l >>= 1;
+    k += 1;
+  }
+  if (l >= 0x10000) {
+    l >>= 1;
+    k += 1;
+  }
+
+  // p = l * ln2, where ln2 = 0xB172 / 2^16; 0x58B90000 <= p < 0xB1720000.
+  // abs(ln(x)) = p * 2^(k - 40) = (p / 2^31) * 2^(k - 9)
+  u32 p = l * 0xB172;
+  i32 ep = k - 9;
+  if (p < 0x80000000) {
+    p <<= 1;
+    ep -= 1;
+  }
+
+  // round to 8 significant bits (ties away from zero)
+  u32 m = ((p >> 23) + 1) >> 1;
+  if (m == 0x100) {
+    m = 0x80;
+    ep += 1;
+  }
+
+  u32 r = s | ((u32)(ep + 127) << 23) | ((m & 0x7F) << 16);
+  return as_bf16(r);
+}
+
+#ifdef LN_FIXED_BF16_TEST
+
+/* Compare ln_fixed_bf16 and ln_bf16 with logf.
+ * The errors are measured on n_rows + 1 points in [0, 2], as in
+ * ln_bf16.c, and in ulp of the exact results over all the positive
+ * normal bf16 numbers.
+ */
+void compare_ln_bf16(float n_rows, float average_error[2],
+                     float maximal_error[2], float maximal_ulp[2]) {
+  for (int i = 0; i < 2; i++)
+    average_error[i] = maximal_error[i] = maximal_ulp[i] = 0;
+
+  float step = 2.0 / n_rows;
+  for (float f = 0; f <= 2.0001; f += step) {
+    bf16 x = fp32_to_bf16(f);
+    float t = logf(x);
+    float error[2] = {fabsf(t - ln_fixed_bf16(x)), fabsf(t - ln_bf16(x))};
+    for (int i = 0; i < 2; i++) {
+      if (!isfinite(error[i])) continue;
+      average_error[i] += error[i] / n_rows;
+      if (error[i] > maximal_error[i]) maximal_error[i] = error[i];
+    }
+  }
+
+  for (u32 b = 0x00800000; b < 0x7F800000; b += 0x10000) {
+    float t = logf(as_bf16(b));
+    if (t == 0) continue;
+    float ulp = ldexpf(1, ilogbf(t) - 7);
+    float error[2] = {fabsf(t - ln_fixed_bf16(as_bf16(b))) / ulp,
+                      fabsf(t - ln_bf16(as_bf16(b))) / ulp};
+    for (int i = 0; i < 2; i++)
+      if (error[i] > maximal_ulp[i]) maximal_ulp[i] = error[i];
+  }
+}
+
+/* Test the functionalities in this unit.
+ * Return 0 if successes. Otherwise, return a non-zero number,
+ * which indicates the first failed test.
+ */
+int test_ln_fixed_bf16() {
+  u32 s;
+  bf16 r;
+
+  // 1: ln(0) = -inf
+  r = ln_fixed_bf16(as_bf16(0));
+  s = 0xFF800000;  // 1 11111111 0000000
+  if (as_u32(r) != s) return 1;
+
+  // 2: ln(1) = 0
+  r = ln_fixed_bf16(as_bf16(0x3F800000));
+  s = 0;  // 0 00000000 0000000
+  if (as_u32(r) != s) return 2;
+
+  // 3: ln(2) = 0.691 (0.6931)
+  r = ln_fixed_bf16(as_bf16(0x40000000));
+  s = 0x3F310000;  // 0 01111110 0110001
+  if (as_u32(r) != s) return 3;
+
+  // 4: ln(0.05) = -3.0 (-2.9948)
+  r = ln_fixed_bf16(as_bf16(0x3D4D0000));
+  s = 0xC0400000;  // 1 10000000 1000000
+  if (as_u32(r) != s) return 4;
+
+  // 5: ln(1.0078) = 0.00778 (0.007782), the smallest result above 0
+  r = ln_fixed_bf16(as_bf16(0x3F810000));
+  s = 0x3BFF0000;  // 0 01110111 1111111
+  if (as_u32(r) != s) return 5;
+
+  // 6: ln(0.9961) = -0.0039 (-0.003914), the largest result below 0
+  r = ln_fixed_bf16(as_bf16(0xBF7F0000));  // ln(abs(-0.9961))
+  s = 0xBB800000;  // 1 01110111 0000000
+  if (as_u32(r) != s) return 6;
+
+  // 7: ln(3.39e38) = 88.5 (88.72), the largest result
+  r = ln_fixed_bf16(as_bf16(0x7F7F0000));
+  s = 0x42B10000;  // 0 10000101 0110001
+  if (as_u32(r) != s) return 7;
+
+  // 8: within 1 ulp for all the positive normal numbers
+  float average_error[2], maximal_error[2], maximal_ulp[2];
+  compare_ln_bf16(40, average_error, maximal_error, maximal_ulp);
+  if (maximal_ulp[0] > 1) return 8;
+
+  return 0;
+}
+
+int main() {
+  int error_code = test_ln_fixed_bf16();
+  if (error_code != 0) {
+    printf("Test %d for ln_fixed_bf16.c failed.\n", error_code);
+    return 1;
+  }
+  puts("Test for ln_fixed_bf16.c passed.");
+
+  float average_error[2], maximal_error[2], maximal_ulp[2];
+  compare_ln_bf16(40, average_error, maximal_error, maximal_ulp);
+  printf("%-14s %13s %13s %12s\n", "", "average error", "maximal error",
+         "maximal ulp");
+  printf("%-14s %13.4f %13.4f %12.2f\n", "ln_fixed_bf16", average_error[0],
+         maximal_error[0], maximal_ulp[0]);
+  printf("%-14s %13.4f %13.4f %12.2f\n", "ln_bf16", average_error[1],
+         maximal_error[1], maximal_ulp[1]);
+  return 0;
+}
+#endif  // LN_FIXED_BF16_TEST
+
+#endif  // LN_FIXED_BF16_C
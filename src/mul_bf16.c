@@ -10,12 +10,13 @@
  * Reference: https://en.wikipedia.org/wiki/Bfloat16_floating-point_format
  *
  * Version: 0.1
- * Tested: 2023-10-07T17:22:00+08:00
+ * Tested: 2026-10-18T14:20:00+08:00
  */
 
 #ifndef MUL_BF16_C
 #define MUL_BF16_C
 
+#include "bit_cast.h"
 #include "type_def.h"
 
 // uncomment the following line to test this program
@@ -39,9 +40,8 @@
  * Output format: bf16
  */
 bf16 mul_bf16(bf16 a, bf16 b) {
-  u32 ba = *(u32 *)&a;
-  u32 bb = *(u32 *)&b;
-  if (ba == 0 || bb == 0) return 0;
+  u32 ba = as_u32(a);
+  u32 bb = as_u32(b);
 
   // extract sign, exponent and mantissa of a and b
   u32 sa = (ba & 0x80000000) >> 31;
@@ -68,31 +68,29 @@ bf16 mul_bf16(bf16 a, bf16 b) {
   // * 0x80 m <= 0x1FC
 
   // handle carry bit; make m <= 0xFF
-  if (m & 0x100) {
-    m >>= 1;
-    e += 1;
-  }
-
-  // handle result of +-0
-  if (m == 0) {
-    s = s << 31;
-    return *(bf16 *)&s;
-  }
+  i32 k = (m >> 8) & 1;
+  m >>= k;
+  e += k;
 
   // construct the result
   s = s << 31;
   e = (e + 127) << 23;
-  m = (m & 0x7F) << 16;
-  u32 r = s | e | m;
+  u32 r = s | e | ((m & 0x7F) << 16);
+
+  // handle result of +-0 and a or b of 0
+  // note: they are selected here instead of returned early,
+  //       so that loops over this function can be vectorized.
+  if (m == 0) r = s;
+  if (ba == 0 || bb == 0) r = 0;
 
 #ifdef MUL_BF16_DEBUG
   printf("(multiplication result)\n");
   printf("%1s %8s %7s\n", "s", "exp", "mantissa");
-  print_bf16_binary(*(bf16 *)&r);
+  print_bf16_binary(as_bf16(r));
   puts("");
 #endif  // MUL_BF16_DEBUG
 
-  return *(bf16 *)&r;
+  return as_bf16(r);
 }
 
 /* Test the functionalities in this unit.
@@ -102,37 +100,34 @@ bf16 mul_bf16(bf16 a, bf16 b) {
 int test_mul_bf16() {
   bf16 a, b, r;
   u32 s;
-  u32 *pa = (u32 *)&a;
-  u32 *pb = (u32 *)&b;
-  u32 *pr = (u32 *)&r;
 
   // 1: a = b = 1
-  *pa = 0x3F800000;  // 0 01111111 0000000
-  *pb = 0x3F800000;  // 0 01111111 0000000
-  s = 0x3F800000;    // 0 10000000 0100110
+  a = as_bf16(0x3F800000);  // 0 01111111 0000000
+  b = as_bf16(0x3F800000);  // 0 01111111 0000000
+  s = 0x3F800000;           // 0 10000000 0100110
   r = mul_bf16(a, b);
-  if (*pr != s) return 1;
+  if (as_u32(r) != s) return 1;
 
   // 2: a = 0.5, b = 4
-  *pa = 0x3F000000;  // 0 01111110 0000000
-  *pb = 0x40800000;  // 0 10000001 0000000
-  s = 0x40000000;    // 0 10000000 0000000
+  a = as_bf16(0x3F000000);  // 0 01111110 0000000
+  b = as_bf16(0x40800000);  // 0 10000001 0000000
+  s = 0x40000000;           // 0 10000000 0000000
   r = mul_bf16(a, b);
-  if (*pr != s) return 2;
+  if (as_u32(r) != s) return 2;
 
   // 3: a < 0, b > 0, mantissa carries
-  *pa = 0xBF400000;  // 1 01111110 1000000
-  *pb = 0x40B00000;  // 0 10000001 0110000
-  s = 0xC0840000;    // 1 10000001 0000100
+  a = as_bf16(0xBF400000);  // 1 01111110 1000000
+  b = as_bf16(0x40B00000);  // 0 10000001 0110000
+  s = 0xC0840000;           // 1 10000001 0000100
   r = mul_bf16(a, b);
-  if (*pr != s) return 3;
+  if (as_u32(r) != s) return 3;
 
   // 4: a = 4, b = 0
-  *pa = 0x40800000;  // 0 10000001 0000000
-  *pb = 0;           // 0 00000000 0000000
-  s = 0;             // 0 00000000 0000000
+  a = as_bf16(0x40800000);  // 0 10000001 0000000
+  b = as_bf16(0);           // 0 00000000 0000000
+  s = 0;                    // 0 00000000 0000000
   r = mul_bf16(a, b);
-  if (*pr != s) return 4;
+  if (as_u32(r) != s) return 4;
 
   return 0;
 }
@@ -0,0 +1,403 @@
+/*
+ * This program implements and tests the following functionality:
+ *   RMS normalization and layer normalization of bfloat16 (bf16) arrays.
+ *
+ *   rmsnorm:   y = x / sqrt(mean(x^2) + eps) * w
+ *   layernorm: y = (x - mean(x)) / sqrt(var(x) + eps) * gamma + beta
+ *
+ * Each kernel takes two passes over x and needs no temporary buffer:
+ * the first pass accumulates the statistics, and the second pass
+ * normalizes and scales each element.
+ *
+ * The sums are accumulated in an integer mantissa with a separate
+ * exponent (norm_acc), instead of in bf16, so that adding many small
+ * terms to a large sum does not lose them to the 8-bit mantissa.
+ * The variance is computed from the differences to the first element,
+ * so that a large mean does not cancel out the variance.
+ *
+ * Notice: The inputs are expected to be finite normal numbers or zeros.
+ *
+ * Version: 0.0
+ * Tested: 2026-10-18T17:30:00+08:00
+ */
+
+#ifndef NORM_BF16_C
+#define NORM_BF16_C
+
+#include "add_sub_bf16.c"
+#include "bit_cast.h"
+#include "mul_bf16.c"
+#include "rsqrt_bf16.c"
+#include "type_def.h"
+
+// uncomment the following line to test this program
+// #define NORM_BF16_TEST
+#ifdef NORM_BF16_TEST
+#include <math.h>    // fabs, sqrt, sqrtf
+#include <stdio.h>   // puts, printf
+#include <stdlib.h>  // rand, srand
+
+// uncomment the following line to measure the throughput
+// #define NORM_BF16_BENCH
+#ifdef NORM_BF16_BENCH
+#include "bench_time.h"  // seconds, BENCH_MEASURE
+#endif  // NORM_BF16_BENCH
+#endif             // NORM_BF16_TEST
+
+/* An extended accumulator, whose value is m * 2^e, where abs(m) < 2^30. */
+typedef struct {
+  i32 m;
+  i32 e;
+} norm_acc;
+
+/* Add m * 2^e, where abs(m) < 2^30, to the accumulator.
+ * The addend with the smaller exponent is shifted to the larger one,
+ * and its bits beyond the 30 bits of the accumulator are dropped.
+ */
+void norm_acc_add(norm_acc *acc, i32 m, i32 e) {
+  if (acc->m == 0) {
+    acc->m = m;
+    acc->e = e;
+    return;
+  }
+
+  // alignment; note: shifting by 32 or more is undefined
+  i32 d = acc->e - e;
+  if (d >= 0) {
+    m >>= (d < 31) ? d : 31;  // arithmetic right shift
+  } else {
+    acc->m >>= (-d < 31) ? -d : 31;
+    acc->e = e;
+  }
+
+  // abs(m) < 2^31; make abs(m) < 2^30
+  m += acc->m;
+  if (m >= 0x40000000 || m <= -0x40000000) {
+    m >>= 1;
+    acc->e += 1;
+  }
+  acc->m = m;
+}
+
+/* Add x^2 to the accumulator. Zeros (and subnormals) are skipped. */
+void norm_acc_add_square(norm_acc *acc, bf16 x) {
+  u32 bx = as_u32(x);
+  i32 ex = (bx >> 23) & 0xFF;
+  i32 mx = ((bx >> 16) & 0x7F) | 0x80;
+  // x^2 = mx^2 * 2^(2 * (ex - 127 - 7)), where 2^14 <= mx^2 < 2^16
+  if (ex != 0) norm_acc_add(acc, (mx * mx) << 14, 2 * ex - 268 - 14);
+}
+
+/* Add x to the accumulator. Zeros (and subnormals) are skipped. */
+void norm_acc_add_bf16(norm_acc *acc, bf16 x) {
+  u32 bx = as_u32(x);
+  i32 ex = (bx >> 23) & 0xFF;
+  // x = m * 2^(ex - 127 - 7 - 22), where 2^29 <= abs(m) < 2^30; the
+  // magnitude is shifted before the sign is applied, as shifting a
+  // negative number left is undefined
+  i32 m = (i32)((((bx >> 16) & 0x7F) | 0x80) << 22);
+  if (bx >> 31) m = -m;
+  if (ex != 0) norm_acc_add(acc, m, ex - 134 - 22);
+}
+
+/* Round the accumulator to the nearest bf16 (ties away from zero).
+ * Returns +-inf if it overflows, and +-0 if it underflows.
+ */
+bf16 norm_acc_to_bf16(norm_acc acc) {
+  if (acc.m == 0) return as_bf16(0);
+  u32 s = (acc.m < 0) ? 0x80000000 : 0;
+  u32 a = (acc.m < 0) ? -acc.m : acc.m;
+
+  // normalization: make 2^30 <= a < 2^31
+  i32 e = acc.e + 30;
+  while (a < 0x40000000) {
+    a <<= 1;
+    e -= 1;
+  }
+
+  // round to 8 significant bits
+  u32 m = (a + (1 << 22)) >> 23;
+  if (m == 0x100) {
+    m = 0x80;
+    e += 1;
+  }
+
+  e += 127;
+  if (e >= 0xFF) return as_bf16(s | 0x7F800000);
+  if (e <= 0) return as_bf16(s);
+  return as_bf16(s | ((u32)e << 23) | ((m & 0x7F) << 16));
+}
+
+/* Reciprocal of a positive integer.
+ * Returns 1 / n, rounded to the nearest bf16 (ties away from zero).
+ * Only the 16 most significant bits of n are used.
+ */
+bf16 norm_inv_n(u32 n) {
+  // normalization: make 2^15 <= n < 2^16, where 1 / n = (1 / n') * 2^k
+  i32 k = 0;
+  while (n >= 0x10000) {
+    n >>= 1;
+    k -= 1;
+  }
+  while (n < 0x8000) {
+    n <<= 1;
+    k += 1;
+  }
+
+  // 2^15 < q <= 2^16, where 1 / n' = q * 2^-31
+  u32 q = 0x80000000 / n;
+  i32 e = k - 16;
+  if (q == 0x10000) {
+    q = 0x8000;
+    e += 1;
+  }
+
+  // round to 8 significant bits
+  u32 m = (q + 0x80) >> 8;
+  if (m == 0x100) {
+    m = 0x80;
+    e += 1;
+  }
+  return as_bf16(((u32)(e + 127) << 23) | ((m & 0x7F) << 16));
+}
+
+/* Mean of the n terms in the accumulator.
+ * Returns acc / n, rounded to bf16.
+ * The exponent of 1 / n is added to the accumulator exactly, and only
+ * the mantissa of 1 / n is multiplied in bf16, so that a sum beyond the
+ * range of bf16 still gives its mean.
+ */
+bf16 norm_acc_mean(norm_acc acc, u32 n) {
+  u32 inv = as_u32(norm_inv_n(n));
+  acc.e += (i32)(inv >> 23) - 127;
+  bf16 m = as_bf16(0x3F800000 | (inv & 0x7F0000));  // in [1, 2)
+  return mul_bf16(norm_acc_to_bf16(acc), m);
+}
+
+/* RMS normalization of n bf16 numbers.
+ *
+ * Input format:
+ *   x: n bf16 numbers
+ *   w: n bf16 numbers, the weights
+ *   n: the number of elements (n >= 1)
+ *   eps: bf16, added to the mean square
+ * Output format:
+ *   y: n bf16 numbers; y may be x
+ */
+void rmsnorm_bf16(const bf16 *x, const bf16 *w, bf16 *y, u32 n, bf16 eps) {
+  // pass 1: mean square
+  norm_acc s2 = {0, 0};
+  for (u32 i = 0; i < n; i++) norm_acc_add_square(&s2, x[i]);
+  bf16 ms = norm_acc_mean(s2, n);
+  bf16 r = rsqrt_bf16(add_bf16(ms, eps));
+
+  // pass 2: normalize and scale
+  for (u32 i = 0; i < n; i++) y[i] = mul_bf16(mul_bf16(x[i], r), w[i]);
+}
+
+/* Layer normalization of n bf16 numbers.
+ *
+ * Input format:
+ *   x: n bf16 numbers
+ *   gamma: n bf16 numbers, the weights
+ *   beta: n bf16 numbers, the biases
+ *   n: the number of elements (n >= 1)
+ *   eps: bf16, added to the variance
+ * Output format:
+ *   y: n bf16 numbers; y may be x
+ */
+void layernorm_bf16(const bf16 *x, const bf16 *gamma, const bf16 *beta,
+                    bf16 *y, u32 n, bf16 eps) {
+  // pass 1: mean and variance of d = x - x[0]
+  bf16 k = x[0];
+  norm_acc s1 = {0, 0}, s2 = {0, 0};
+  for (u32 i = 0; i < n; i++) {
+    bf16 d = sub_bf16(x[i], k);
+    norm_acc_add_bf16(&s1, d);
+    norm_acc_add_square(&s2, d);
+  }
+  bf16 mean_d = norm_acc_mean(s1, n);
+  bf16 var = sub_bf16(norm_acc_mean(s2, n), mul_bf16(mean_d, mean_d));
+  if (as_u32(var) & 0x80000000) var = as_bf16(0);  // rounding errors
+  bf16 r = rsqrt_bf16(add_bf16(var, eps));
+
+  // pass 2: normalize, scale and shift
+  // note: x - x[0] is exact for most x, and mean_d is as small as the
+  //       spread of x, so that (x - x[0]) - mean_d is more precise than
+  //       x - mean when the mean is large.
+  for (u32 i = 0; i < n; i++) {
+    bf16 t = sub_bf16(sub_bf16(x[i], k), mean_d);
+    y[i] = add_bf16(mul_bf16(mul_bf16(t, r), gamma[i]), beta[i]);
+  }
+}
+
+#ifdef NORM_BF16_TEST
+
+#define NORM_BF16_TEST_N 1000
+
+/* fp32 versions with libm, as references and baselines */
+void rmsnorm_fp32(const float *x, const float *w, float *y, u32 n,
+                  float eps) {
+  float s2 = 0;
+  for (u32 i = 0; i < n; i++) s2 += x[i] * x[i];
+  float r = 1 / sqrtf(s2 / n + eps);
+  for (u32 i = 0; i < n; i++) y[i] = x[i] * r * w[i];
+}
+
+void layernorm_fp32(const float *x, const float *gamma, const float *beta,
+                    float *y, u32 n, float eps) {
+  float s1 = 0, s2 = 0;
+  for (u32 i = 0; i < n; i++) {
+    s1 += x[i];
+    s2 += x[i] * x[i];
+  }
+  float mean = s1 / n;
+  float r = 1 / sqrtf(s2 / n - mean * mean + eps);
+  for (u32 i = 0; i < n; i++) y[i] = (x[i] - mean) * r * gamma[i] + beta[i];
+}
+
+/* Fill x with n random bf16 numbers, c + u * 2^e, where -1 <= u < 1. */
+void random_norm_bf16(bf16 *x, u32 n, float c, i32 e) {
+  for (u32 i = 0; i < n; i++) {
+    float u = ldexpf((float)rand() / RAND_MAX * 2 - 1, e);
+    x[i] = as_bf16(as_u32(c + u) & 0xFFFF0000);
+  }
+}
+
+/* Returns the largest error of y, relative to the largest magnitude of
+ * the exact results in double.
+ */
+double norm_error(const bf16 *x, const bf16 *g, const bf16 *b, const bf16 *y,
+                  u32 n, float eps, int is_layer) {
+  double s1 = 0, s2 = 0;
+  for (u32 i = 0; i < n; i++) s1 += x[i];
+  double mean = is_layer ? s1 / n : 0;
+  for (u32 i = 0; i < n; i++) s2 += (x[i] - mean) * (x[i] - mean);
+  double r = 1 / sqrt(s2 / n + eps);
+
+  double max_t = 0, max_e = 0;
+  for (u32 i = 0; i < n; i++) {
+    double t = (x[i] - mean) * r * g[i] + (is_layer ? b[i] : 0);
+    if (fabs(t) > max_t) max_t = fabs(t);
+    if (fabs(t - y[i]) > max_e) max_e = fabs(t - y[i]);
+  }
+  return max_e / max_t;
+}
+
+/* Test the functionalities in this unit.
+ * Return 0 if successes. Otherwise, return a non-zero number,
+ * which indicates the first failed test.
+ */
+int test_norm_bf16() {
+  bf16 x[4], w[4], b[4], y[4];
+
+  // 1: 1 / 1 = 1, 1 / 3 = 0.3340 (0.3333), 1 / 4 = 0.25, 1 / 1000
+  if (as_u32(norm_inv_n(1)) != 0x3F800000) return 1;     // 0 01111111 0000000
+  if (as_u32(norm_inv_n(3)) != 0x3EAB0000) return 1;     // 0 01111101 0101011
+  if (as_u32(norm_inv_n(4)) != 0x3E800000) return 1;     // 0 01111101 0000000
+  if (as_u32(norm_inv_n(1000)) != 0x3A830000) return 1;  // 0 01110101 0000011
+
+  // 2: 1 + 2^-8 + ... + 2^-8 (256 times) = 2, which is 1 in bf16 sums
+  norm_acc acc = {0, 0};
+  norm_acc_add_bf16(&acc, as_bf16(0x3F800000));
+  for (int i = 0; i < 256; i++) norm_acc_add_bf16(&acc, as_bf16(0x3B800000));
+  if (as_u32(norm_acc_to_bf16(acc)) != 0x40000000) return 2;
+
+  // 3: rmsnorm({3, 4}) = {0.8477, 1.1328} ({0.8485, 1.1314})
+  x[0] = as_bf16(0x40400000);  // 0 10000000 1000000
+  x[1] = as_bf16(0x40800000);  // 0 10000001 0000000
+  w[0] = w[1] = as_bf16(0x3F800000);
+  rmsnorm_bf16(x, w, y, 2, as_bf16(0));
+  if (as_u32(y[0]) != 0x3F590000) return 3;  // 0 01111110 1011001
+  if (as_u32(y[1]) != 0x3F910000) return 3;  // 0 01111111 0010001
+
+  // 4: rmsnorm({-1, 1, ..., 1}) = {-1, 1, ..., 1}, where a bf16 sum of
+  //    the squares would stop at 256
+  static bf16 ones[NORM_BF16_TEST_N], ry[NORM_BF16_TEST_N];
+  for (u32 i = 0; i < NORM_BF16_TEST_N; i++) ones[i] = as_bf16(0x3F800000);
+  ones[0] = as_bf16(0xBF800000);
+  rmsnorm_bf16(ones, ones + 1, ry, NORM_BF16_TEST_N - 1, as_bf16(0));
+  if (as_u32(ry[0]) != 0xBF800000) return 4;
+  for (u32 i = 1; i < NORM_BF16_TEST_N - 1; i++)
+    if (as_u32(ry[i]) != 0x3F800000) return 4;
+
+  // 5: layernorm({1, 2, 3, 4}) = {-1.3438, -0.4492, 0.4492, 1.3438}
+  //    ({-1.3416, -0.4472, 0.4472, 1.3416})
+  x[0] = as_bf16(0x3F800000);  // 0 01111111 0000000
+  x[1] = as_bf16(0x40000000);  // 0 10000000 0000000
+  x[2] = as_bf16(0x40400000);  // 0 10000000 1000000
+  x[3] = as_bf16(0x40800000);  // 0 10000001 0000000
+  for (int i = 0; i < 4; i++) {
+    w[i] = as_bf16(0x3F800000);
+    b[i] = as_bf16(0);
+  }
+  layernorm_bf16(x, w, b, y, 4, as_bf16(0));
+  if (as_u32(y[0]) != 0xBFAC0000 || as_u32(y[1]) != 0xBEE60000) return 5;
+  if (as_u32(y[2]) != 0x3EE60000 || as_u32(y[3]) != 0x3FAC0000) return 5;
+
+  // 6: random arrays, also with large means and large or small magnitudes,
+  //    within 2^-4 (8 ulp) of the largest exact result, since each of the
+  //    truncating bf16 operations per element loses up to 1 ulp
+  static bf16 rx[NORM_BF16_TEST_N], rw[NORM_BF16_TEST_N];
+  static bf16 rb[NORM_BF16_TEST_N];
+  srand(30);
+  for (i32 e = -60; e <= 60; e += 20) {
+    float c = ldexpf(1, e + 3);  // the mean is 8 times the spread
+    random_norm_bf16(rx, NORM_BF16_TEST_N, 0, e);
+    random_norm_bf16(rw, NORM_BF16_TEST_N, 1, -2);
+    random_norm_bf16(rb, NORM_BF16_TEST_N, 0, -2);
+    rmsnorm_bf16(rx, rw, ry, NORM_BF16_TEST_N, as_bf16(0));
+    if (norm_error(rx, rw, rb, ry, NORM_BF16_TEST_N, 0, 0) > 0x1p-4) return 6;
+    layernorm_bf16(rx, rw, rb, ry, NORM_BF16_TEST_N, as_bf16(0));
+    if (norm_error(rx, rw, rb, ry, NORM_BF16_TEST_N, 0, 1) > 0x1p-4) return 6;
+    random_norm_bf16(rx, NORM_BF16_TEST_N, c, e);
+    layernorm_bf16(rx, rw, rb, ry, NORM_BF16_TEST_N, as_bf16(0));
+    if (norm_error(rx, rw, rb, ry, NORM_BF16_TEST_N, 0, 1) > 0x1p-4) return 6;
+  }
+
+  // 7: eps dominates a constant array
+  for (u32 i = 0; i < NORM_BF16_TEST_N; i++) rx[i] = as_bf16(0x40400000);
+  layernorm_bf16(rx, rw, rb, ry, NORM_BF16_TEST_N, as_bf16(0x3C230000));
+  for (u32 i = 0; i < NORM_BF16_TEST_N; i++)
+    if (as_u32(ry[i]) != as_u32(rb[i])) return 7;
+
+  return 0;
+}
+
+#ifdef NORM_BF16_BENCH
+void bench_norm_bf16() {
+  const u32 n = 4096;  // a typical hidden size
+  const int repeat = 2000;
+  static bf16 x[4096], w[4096], b[4096], y[4096];
+  random_norm_bf16(x, n, 0.5, 0);
+  random_norm_bf16(w, n, 1, -2);
+  random_norm_bf16(b, n, 0, -2);
+
+  BENCH_MEASURE(n, repeat, rmsnorm_bf16(x, w, y, n, 1e-5f), "%-20s",
+                "rmsnorm_bf16");
+  BENCH_MEASURE(n, repeat, rmsnorm_fp32(x, w, y, n, 1e-5f), "%-20s",
+                "rmsnorm_fp32");
+  BENCH_MEASURE(n, repeat, layernorm_bf16(x, w, b, y, n, 1e-5f),
+                "%-20s", "layernorm_bf16");
+  BENCH_MEASURE(n, repeat, layernorm_fp32(x, w, b, y, n, 1e-5f),
+                "%-20s", "layernorm_fp32");
+}
+#endif  // NORM_BF16_BENCH
+
+int main() {
+  int error_code = test_norm_bf16();
+  if (error_code == 0) {
+    puts("Test for norm_bf16.c passed.");
+  } else {
+    printf("Test %d for norm_bf16.c failed.\n", error_code);
+    return 1;
+  }
+
+#ifdef NORM_BF16_BENCH
+  bench_norm_bf16();
+#endif  // NORM_BF16_BENCH
+  return 0;
+}
+#endif  // NORM_BF16_TEST
+
+#endif  // NORM_BF16_C
@@ -11,11 +11,12 @@
 #include <stdio.h>   // printf
 #include <string.h>  // sprintf, strncpy
 
+#include "bit_cast.h"
 #include "type_def.h"
 
 void print_bf16_hex_dec(bf16 x) {
   char buffer[11] = {0};
-  sprintf(buffer, "%08x", *(int *)&x);
+  sprintf(buffer, "%08x", as_u32(x));
   memset(buffer + 4, 0, 4 * sizeof(char));
   printf("%s %.6f\n", buffer, x);
 }
@@ -33,7 +34,7 @@ void sprint_binary(char *buffer, u32 x, u32 n_bits) {
 
 /* Print the bf16 number in binary. */
 void print_bf16_binary(bf16 x) {
-  u32 bx = (*(u32 *)&x) >> 16;
+  u32 bx = as_u32(x) >> 16;
   char buffer[17];
   sprint_binary(buffer, bx, 16);
 
@@ -0,0 +1,432 @@
+/*
+ * This program implements and tests the following functionality:
+ *   Block-scaled quantization of bfloat16 (bf16) arrays to 8-bit
+ *   integers (q8), and vice versa.
+ *
+ * Definition of the q8 format:
+ * (1) The array is split into blocks of Q8_BLOCK consecutive elements
+ *     (the last block may be shorter).
+ * (2) Each block has one bf16 scale, which is absmax / 127 rounded to
+ *     bf16, where absmax is the largest magnitude in the block.
+ * (3) Each element is stored as round(x / scale), saturated to
+ *     [-127, 127], so that x is approximately q * scale.
+ *
+ * Only integer operations are used, so that the same results can be
+ * produced by the RV32I implementation (asm/q8_bf16.s). The division
+ * by the scale is replaced by a multiplication with a 23-bit reciprocal
+ * of the scale's mantissa, which is computed once per block.
+ *
+ * Notice: The inputs are expected to be finite. Blocks whose absmax is
+ *   smaller than 2^-119 get a scale of 0 and are quantized to 0.
+ *
+ * Version: 0.0
+ * Tested: 2026-10-18T14:20:00+08:00
+ */
+
+#ifndef Q8_BF16_C
+#define Q8_BF16_C
+
+#include "bit_cast.h"
+#include "type_def.h"
+
+// uncomment the following line to test this program
+// #define Q8_BF16_TEST
+#ifdef Q8_BF16_TEST
+#include <stdio.h>   // puts, printf
+#include <stdlib.h>  // rand, srand
+#include <string.h>  // memcmp, memcpy
+
+// uncomment the following line to measure the throughput
+// #define Q8_BF16_BENCH
+#ifdef Q8_BF16_BENCH
+#include "bench_time.h"  // seconds, BENCH_MEASURE
+#endif  // Q8_BF16_BENCH
+#endif             // Q8_BF16_TEST
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif  // __AVX2__
+
+// number of elements sharing one scale
+#define Q8_BLOCK 32
+
+/* Compute the scale of a block from the bf16 bit pattern (without sign,
+ * i.e., the upper 16 bits & 0x7FFF) of its largest magnitude.
+ * Returns the scale (bf16 bit pattern in the higher 16 bits), and stores
+ * the reciprocal of the scale's mantissa, round(2^23 / ms), to *inv.
+ * Returns 0 if the block should be quantized to 0.
+ */
+u32 q8_scale(u32 amax, u32 *inv) {
+  u32 em = amax >> 7;             // exponent of absmax
+  u32 mm = (amax & 0x7F) | 0x80;  // mantissa of absmax
+  *inv = 0;
+  if (em <= 7) return 0;  // absmax < 2^-119; scale would not be normal
+
+  // scale = absmax / 127 = (mm / 127) * 2^(em - 127 - 7)
+  // mm / 127 is in [1.0079, 2.0079]; keep 16 fraction bits.
+  u32 qt = (mm << 16) / 127;
+  u32 es = em - 7;
+  if (qt >= 0x20000) {  // mm / 127 >= 2.0
+    qt >>= 1;
+    es += 1;
+  }
+  // round to 8 bits of mantissa (half up); never carries out.
+  u32 ms = (qt + 0x100) >> 9;
+
+  *inv = ((1 << 23) + (ms >> 1)) / ms;
+  return (es << 23) | ((ms & 0x7F) << 16);
+}
+
+/* Quantize one element with the scale and reciprocal from q8_scale.
+ * Input format:
+ *   x: bf16
+ *   scale: bf16 bit pattern of the block's scale (nonzero)
+ *   inv: round(2^23 / mantissa of scale)
+ * Output format: i32 in [-127, 127]
+ */
+i32 q8_from_bf16(bf16 x, u32 scale, u32 inv) {
+  u32 bx = as_u32(x);
+  u32 a = (bx >> 16) & 0x7FFF;
+  i32 ex = a >> 7;
+  i32 es = scale >> 23;
+  if (ex == 0) return 0;  // zero (or subnormal)
+
+  // |x| / scale = (mx * inv) * 2^(ex - es - 23)
+  i32 d = 23 + es - ex;  // d >= 16, for |x| <= absmax
+  if (d > 24) return 0;  // |x| / scale < 0.5
+  u32 mx = (a & 0x7F) | 0x80;
+  u32 q = (mx * inv + (1u << (d - 1))) >> d;  // round half up
+  if (q > 127) q = 127;                       // saturate
+
+  return (bx & 0x80000000) ? -(i32)q : (i32)q;
+}
+
+/* Dequantize one element.
+ * Returns q * scale, rounded to the nearest bf16 (ties to even).
+ *
+ * Input format:
+ *   q: i32 in [-127, 127]
+ *   scale: bf16
+ * Output format: bf16
+ */
+bf16 q8_to_bf16_1(i32 q, bf16 scale) {
+  u32 bs = as_u32(scale);
+  u32 s = ((q < 0) ? 0x80000000 : 0) ^ (bs & 0x80000000);
+  u32 mq = (q < 0) ? -q : q;
+  u32 es = (bs >> 23) & 0xFF;
+  if (mq == 0 || es == 0) return as_bf16(s);  // +-0
+
+  // 0x80 <= p <= 0x7E81 (127 * 0xFF)
+  u32 p = mq * (((bs >> 16) & 0x7F) | 0x80);
+
+  // normalization: make 0x80 <= m < 0x100
+  u32 k = 0;
+  while ((p >> k) >= 0x100) k++;
+  u32 m = p >> k;
+  u32 e = es + k;
+
+  // round to nearest, ties to even
+  if (k != 0) {
+    u32 rem = p & ((1 << k) - 1);
+    u32 half = 1 << (k - 1);
+    if (rem > half || (rem == half && (m & 1))) m += 1;
+    if (m == 0x100) {
+      m = 0x80;
+      e += 1;
+    }
+  }
+
+  u32 r = (e >= 0xFF) ? (s | 0x7F800000)  // overflow: inf
+                      : (s | (e << 23) | ((m & 0x7F) << 16));
+  return as_bf16(r);
+}
+
+/* Quantize n bf16 numbers to q8, one block at a time.
+ *
+ * Input format:
+ *   x: n bf16 numbers
+ * Output format:
+ *   q: n 8-bit integers
+ *   scale: (n + Q8_BLOCK - 1) / Q8_BLOCK bf16 numbers
+ */
+void bf16_to_q8_scalar(const bf16 *x, i8 *q, bf16 *scale, u32 n) {
+  for (u32 i = 0; i < n; i += Q8_BLOCK, x += Q8_BLOCK, q += Q8_BLOCK) {
+    u32 len = (n - i < Q8_BLOCK) ? n - i : Q8_BLOCK;
+
+    // absmax of the block, compared as bit patterns
+    u32 amax = 0;
+    for (u32 j = 0; j < len; j++) {
+      u32 a = (as_u32(x[j]) >> 16) & 0x7FFF;
+      if (a > amax) amax = a;
+    }
+
+    u32 inv;
+    u32 bs = q8_scale(amax, &inv);
+    *scale++ = as_bf16(bs);
+    for (u32 j = 0; j < len; j++)
+      q[j] = (bs == 0) ? 0 : (i8)q8_from_bf16(x[j], bs, inv);
+  }
+}
+
+/* Dequantize n q8 numbers to bf16.
+ *
+ * Input format:
+ *   q: n 8-bit integers
+ *   scale: (n + Q8_BLOCK - 1) / Q8_BLOCK bf16 numbers
+ * Output format:
+ *   x: n bf16 numbers
+ */
+void q8_to_bf16_scalar(const i8 *q, const bf16 *scale, bf16 *x, u32 n) {
+  for (u32 i = 0; i < n; i++) x[i] = q8_to_bf16_1(q[i], scale[i / Q8_BLOCK]);
+}
+
+#ifdef __AVX2__
+/* AVX2 version of bf16_to_q8_scalar; gives bit-identical results. */
+void bf16_to_q8_avx2(const bf16 *x, i8 *q, bf16 *scale, u32 n) {
+  const __m256i mask_abs = _mm256_set1_epi32(0x7FFF);
+  const __m256i mask_man = _mm256_set1_epi32(0x7F);
+  const __m256i hidden = _mm256_set1_epi32(0x80);
+  const __m256i one = _mm256_set1_epi32(1);
+  const __m256i q_max = _mm256_set1_epi32(127);
+  const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+  const __m256i zero = _mm256_setzero_si256();
+
+  u32 i = 0;
+  for (; i + Q8_BLOCK <= n; i += Q8_BLOCK, x += Q8_BLOCK, q += Q8_BLOCK) {
+    __m256i v[4], a[4], r[4];
+    for (int k = 0; k < 4; k++) {
+      v[k] = _mm256_loadu_si256((const __m256i *)(x + 8 * k));
+      a[k] = _mm256_and_si256(_mm256_srli_epi32(v[k], 16), mask_abs);
+    }
+
+    // horizontal max of the block
+    __m256i t = _mm256_max_epi32(_mm256_max_epi32(a[0], a[1]),
+                                 _mm256_max_epi32(a[2], a[3]));
+    t = _mm256_max_epi32(t, _mm256_permute2x128_si256(t, t, 1));
+    t = _mm256_max_epi32(t, _mm256_shuffle_epi32(t, 0x4E));
+    t = _mm256_max_epi32(t, _mm256_shuffle_epi32(t, 0xB1));
+    u32 amax = (u32)_mm256_cvtsi256_si32(t);
+
+    u32 inv;
+    u32 bs = q8_scale(amax, &inv);
+    *scale++ = as_bf16(bs);
+    if (bs == 0) {
+      _mm256_storeu_si256((__m256i *)q, zero);
+      continue;
+    }
+
+    const __m256i v_inv = _mm256_set1_epi32(inv);
+    const __m256i v_d = _mm256_set1_epi32(23 + (bs >> 23));
+    for (int k = 0; k < 4; k++) {
+      __m256i ex = _mm256_srli_epi32(a[k], 7);
+      __m256i mx = _mm256_or_si256(_mm256_and_si256(a[k], mask_man), hidden);
+      __m256i d = _mm256_sub_epi32(v_d, ex);
+      __m256i p = _mm256_mullo_epi32(mx, v_inv);
+      // shifts by 32 or more give 0, which covers (d > 24)
+      __m256i half = _mm256_sllv_epi32(one, _mm256_sub_epi32(d, one));
+      __m256i m = _mm256_srlv_epi32(_mm256_add_epi32(p, half), d);
+      m = _mm256_min_epu32(m, q_max);
+      m = _mm256_andnot_si256(_mm256_cmpeq_epi32(ex, zero), m);
+      __m256i neg = _mm256_srai_epi32(v[k], 31);
+      r[k] = _mm256_sub_epi32(_mm256_xor_si256(m, neg), neg);
+    }
+    __m256i p16 = _mm256_packs_epi16(_mm256_packs_epi32(r[0], r[1]),
+                                     _mm256_packs_epi32(r[2], r[3]));
+    _mm256_storeu_si256((__m256i *)q, _mm256_permutevar8x32_epi32(p16, order));
+  }
+  if (i < n) bf16_to_q8_scalar(x, q, scale, n - i);
+}
+
+/* AVX2 version of q8_to_bf16_scalar; gives bit-identical results.
+ * The product of a 7-bit integer and a bf16 scale is exact in fp32,
+ * so a single rounding from fp32 to bf16 gives the same result.
+ */
+void q8_to_bf16_avx2(const i8 *q, const bf16 *scale, bf16 *x, u32 n) {
+  const __m256i bias = _mm256_set1_epi32(0x7FFF);
+  const __m256i one = _mm256_set1_epi32(1);
+  const __m256i mask_bf16 = _mm256_set1_epi32(0xFFFF0000);
+
+  u32 i = 0;
+  for (; i + Q8_BLOCK <= n; i += Q8_BLOCK, q += Q8_BLOCK, x += Q8_BLOCK) {
+    u32 bs = as_u32(*scale++);
+    if ((bs & 0x7F800000) == 0) bs &= 0x80000000;  // subnormal scale as 0
+    bs &= 0xFFFF0000;
+    const __m256 s = _mm256_castsi256_ps(_mm256_set1_epi32(bs));
+    for (int k = 0; k < 4; k++) {
+      __m128i q8 = _mm_loadl_epi64((const __m128i *)(q + 8 * k));
+      __m256 f = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(q8));
+      __m256i b = _mm256_castps_si256(_mm256_mul_ps(f, s));
+      // round to nearest even: b + 0x7FFF + ((b >> 16) & 1)
+      __m256i lsb = _mm256_and_si256(_mm256_srli_epi32(b, 16), one);
+      b = _mm256_add_epi32(b, _mm256_add_epi32(bias, lsb));
+      _mm256_storeu_si256((__m256i *)(x + 8 * k),
+                          _mm256_and_si256(b, mask_bf16));
+    }
+  }
+  if (i < n) q8_to_bf16_scalar(q, scale, x, n - i);
+}
+#endif  // __AVX2__
+
+/* Quantize n bf16 numbers to q8 with the fastest available version.
+ * See bf16_to_q8_scalar for the formats.
+ */
+void bf16_to_q8(const bf16 *x, i8 *q, bf16 *scale, u32 n) {
+#ifdef __AVX2__
+  bf16_to_q8_avx2(x, q, scale, n);
+#else
+  bf16_to_q8_scalar(x, q, scale, n);
+#endif  // __AVX2__
+}
+
+/* Dequantize n q8 numbers with the fastest available version.
+ * See q8_to_bf16_scalar for the formats.
+ */
+void q8_to_bf16(const i8 *q, const bf16 *scale, bf16 *x, u32 n) {
+#ifdef __AVX2__
+  q8_to_bf16_avx2(q, scale, x, n);
+#else
+  q8_to_bf16_scalar(q, scale, x, n);
+#endif  // __AVX2__
+}
+
+#ifdef Q8_BF16_TEST
+
+#define Q8_BF16_TEST_N (Q8_BLOCK * 64 + 5)
+
+/* Fill x with n random finite bf16 numbers around 2^e, with some zeros. */
+void random_bf16(bf16 *x, u32 n, i32 e) {
+  for (u32 i = 0; i < n; i++) {
+    u32 r = (u32)rand();
+    u32 b = ((r & 1) << 31) | ((u32)(127 + e + (i32)((r >> 1) % 9) - 4) << 23) |
+            ((r >> 8) & 0x7F) << 16;
+    if (r % 29 == 0) b = 0;
+    x[i] = as_bf16(b);
+  }
+}
+
+/* Test the functionalities in this unit.
+ * Return 0 if successes. Otherwise, return a non-zero number,
+ * which indicates the first failed test.
+ */
+int test_q8_bf16() {
+  bf16 x[Q8_BLOCK + 3], y[Q8_BLOCK + 3], scale[2];
+  i8 q[Q8_BLOCK + 3];
+
+  // 1: absmax = 2.0 -> scale = 0.01575 (2 / 127 = 0.015748)
+  for (int i = 0; i < Q8_BLOCK + 3; i++) x[i] = as_bf16(0);
+  x[0] = as_bf16(0x40000000);  // 2.0
+  x[1] = as_bf16(0x3F800000);  // 1.0
+  x[2] = as_bf16(0xBF000000);  // -0.5
+  x[3] = as_bf16(0x3C000000);  // 0.0078 (rounds to 0)
+  x[4] = as_bf16(0xBC810000);  // -0.0158 (rounds to -1)
+  bf16_to_q8_scalar(x, q, scale, Q8_BLOCK);
+  if (as_u32(scale[0]) != 0x3C810000) return 1;  // 0 01111001 0000001
+
+  // 2: quantized values
+  if (q[0] != 127 || q[1] != 64 || q[2] != -32 || q[3] != 0 || q[4] != -1 ||
+      q[5] != 0)
+    return 2;
+
+  // 3: dequantized values are the nearest bf16 of q * scale
+  q8_to_bf16_scalar(q, scale, y, Q8_BLOCK);
+  if (as_u32(y[0]) != 0x40000000 || as_u32(y[1]) != 0x3F810000 ||
+      as_u32(y[2]) != 0xBF010000 || as_u32(y[3]) != 0 ||
+      as_u32(y[4]) != 0xBC810000)
+    return 3;
+
+  // 4: block of zeros and tiny numbers -> scale 0, q = 0
+  for (int i = 0; i < Q8_BLOCK + 3; i++) x[i] = as_bf16(0);
+  x[0] = as_bf16(0x03000000);  // 2^-121
+  x[1] = as_bf16(0x80000000);  // -0.0
+  bf16_to_q8_scalar(x, q, scale, Q8_BLOCK);
+  if (as_u32(scale[0]) != 0 || q[0] != 0 || q[1] != 0) return 4;
+
+  // 5: partial last block has its own scale
+  for (int i = 0; i < Q8_BLOCK + 3; i++) x[i] = as_bf16(0x3F800000);  // 1.0
+  x[Q8_BLOCK + 1] = as_bf16(0xC2FE0000);                              // -127.0
+  bf16_to_q8_scalar(x, q, scale, Q8_BLOCK + 3);
+  if (as_u32(scale[0]) != 0x3C010000 || as_u32(scale[1]) != 0x3F800000)
+    return 5;
+  if (q[0] != 127 || q[Q8_BLOCK] != 1 || q[Q8_BLOCK + 1] != -127) return 5;
+
+  // 6: round trip error is at most half a step (plus bf16 rounding)
+  static bf16 rx[Q8_BF16_TEST_N], ry[Q8_BF16_TEST_N];
+  static i8 rq[Q8_BF16_TEST_N];
+  static bf16 rs[Q8_BF16_TEST_N / Q8_BLOCK + 1];
+  srand(26);
+  random_bf16(rx, Q8_BF16_TEST_N, 3);
+  bf16_to_q8_scalar(rx, rq, rs, Q8_BF16_TEST_N);
+  q8_to_bf16_scalar(rq, rs, ry, Q8_BF16_TEST_N);
+  for (u32 i = 0; i < Q8_BF16_TEST_N; i++) {
+    float s = rs[i / Q8_BLOCK];
+    float e = rx[i] - ry[i];
+    if (e < 0) e = -e;
+    if (e > 0.51f * s + (ry[i] < 0 ? -ry[i] : ry[i]) / 256) return 6;
+  }
+
+#ifdef __AVX2__
+  // 7: the AVX2 versions are bit-identical to the scalar versions
+  static i8 vq[Q8_BF16_TEST_N];
+  static bf16 vs[Q8_BF16_TEST_N / Q8_BLOCK + 1], vy[Q8_BF16_TEST_N];
+  for (i32 e = -118; e <= 120; e += 17) {
+    random_bf16(rx, Q8_BF16_TEST_N, e);
+    bf16_to_q8_scalar(rx, rq, rs, Q8_BF16_TEST_N);
+    bf16_to_q8_avx2(rx, vq, vs, Q8_BF16_TEST_N);
+    if (memcmp(rq, vq, sizeof(rq)) != 0) return 7;
+    if (memcmp(rs, vs, sizeof(rs)) != 0) return 7;
+  }
+
+  // 8: the AVX2 dequantization is bit-identical for all scales
+  for (u32 b = 0; b < 0x7F80; b++) {
+    u32 bs = b << 16;
+    for (u32 i = 0; i < Q8_BLOCK * 8; i++) {
+      vq[i] = (i8)((i % 255) - 127);
+      vs[i / Q8_BLOCK] = as_bf16(bs ^ ((i / Q8_BLOCK) & 1) << 31);
+    }
+    q8_to_bf16_scalar(vq, vs, ry, Q8_BLOCK * 8);
+    q8_to_bf16_avx2(vq, vs, vy, Q8_BLOCK * 8);
+    if (memcmp(ry, vy, Q8_BLOCK * 8 * sizeof(bf16)) != 0) return 8;
+  }
+#endif  // __AVX2__
+
+  return 0;
+}
+
+#ifdef Q8_BF16_BENCH
+void bench_q8_bf16() {
+  const u32 n = 1 << 20;  // 4 MiB of bf16 (in 32-bit slots)
+  const int repeat = 20;
+  static bf16 x[1 << 20], y[1 << 20], scale[(1 << 20) / Q8_BLOCK];
+  static i8 q[1 << 20];
+  random_bf16(x, n, 0);
+
+  BENCH_MEASURE(n, repeat, bf16_to_q8_scalar(x, q, scale, n), "%-20s",
+                "bf16_to_q8_scalar");
+  BENCH_MEASURE(n, repeat, q8_to_bf16_scalar(q, scale, y, n), "%-20s",
+                "q8_to_bf16_scalar");
+#ifdef __AVX2__
+  BENCH_MEASURE(n, repeat, bf16_to_q8_avx2(x, q, scale, n), "%-20s",
+                "bf16_to_q8_avx2");
+  BENCH_MEASURE(n, repeat, q8_to_bf16_avx2(q, scale, y, n), "%-20s",
+                "q8_to_bf16_avx2");
+#endif  // __AVX2__
+}
+#endif  // Q8_BF16_BENCH
+
+int main() {
+  int error_code = test_q8_bf16();
+  if (error_code == 0) {
+    puts("Test for q8_bf16.c passed.");
+  } else {
+    printf("Test %d for q8_bf16.c failed.\n", error_code);
+    return 1;
+  }
+
+#ifdef Q8_BF16_BENCH
+  bench_q8_bf16();
+#endif  // Q8_BF16_BENCH
+  return 0;
+}
+#endif  // Q8_BF16_TEST
+
+#endif  // Q8_BF16_C
@@ -0,0 +1,162 @@
+/*
+ * This program implements and tests the following functionality:
+ *   Reciprocal square root of bf16 numbers.
+ *
+ * The initial guess is the "magic number" trick on the bits of x, i.e.,
+ * halving and negating the exponent (and roughly the mantissa) with one
+ * integer subtraction; then it is refined by one Newton step,
+ *   y = y * (1.5 - 0.5 * x * y * y),
+ * with mul_bf16 and sub_bf16.
+ *
+ * Benchmark (x86-64 with AVX-512, gcc -O3 -march=native, Melem/s):
+ *   rsqrt: 1 / sqrtf 413, rsqrt_bf16 40
+ * On the host, the fp32 baseline is vectorized into hardware square
+ * roots and divisions, while rsqrt_bf16 only uses integer operations, as
+ * on RV32I, where sqrtf and the division are emulated in software.
+ *
+ * Reference: https://en.wikipedia.org/wiki/Fast_inverse_square_root
+ *
+ * Version: 0.0
+ * Tested: 2026-10-18T17:05:00+08:00
+ */
+
+#ifndef RSQRT_BF16_C
+#define RSQRT_BF16_C
+
+#include "add_sub_bf16.c"
+#include "bit_cast.h"
+#include "mul_bf16.c"
+#include "type_def.h"
+
+// uncomment the following line to test this program
+// #define RSQRT_BF16_TEST
+#ifdef RSQRT_BF16_TEST
+#include <math.h>   // sqrtf, fabsf, ldexpf, ilogbf
+#include <stdio.h>  // puts, printf
+
+// uncomment the following line to measure the throughput
+// #define RSQRT_BF16_BENCH
+#ifdef RSQRT_BF16_BENCH
+#include "bench_time.h"  // seconds, BENCH_MEASURE
+#endif  // RSQRT_BF16_BENCH
+#endif              // RSQRT_BF16_TEST
+
+// the magic number for bf16, found by an exhaustive search of the upper
+// 16 bits for the smallest error after the Newton step, among the ones
+// giving exact results for the powers of 4
+#define RSQRT_BF16_MAGIC 0x5F310000
+
+/* Reciprocal square root of a bf16 number.
+ * Returns 1 / sqrt(x), within 2 ulp for the positive normal numbers.
+ * Returns +inf for +-0, 0 for +inf, and NaN for x < 0 and NaN.
+ *
+ * Input format: bf16
+ * Output format: bf16
+ */
+bf16 rsqrt_bf16(bf16 x) {
+  u32 bx = as_u32(x) & 0xFFFF0000;  // remove extra bits
+  if ((bx & 0x7FFFFFFF) == 0) return as_bf16(0x7F800000);  // +inf
+  if (bx == 0x7F800000) return as_bf16(0);                // 0
+  if (bx > 0x7F800000) return as_bf16(0x7FC00000);        // NaN
+
+  // initial guess
+  bf16 y = as_bf16((RSQRT_BF16_MAGIC - (bx >> 1)) & 0xFFFF0000);
+
+  // one Newton step: y = y * (1.5 - 0.5 * t), where t = x * y * y.
+  // note: x * y, which is about sqrt(x), is calculated first,
+  //       so that neither y * y nor 0.5 * x underflows or overflows.
+  bf16 t = mul_bf16(mul_bf16(as_bf16(bx), y), y);  // t is about 1
+  t = as_bf16(as_u32(t) - 0x00800000);             // t = 0.5 * t
+  t = sub_bf16(as_bf16(0x3FC00000), t);            // t = 1.5 - t
+  return mul_bf16(y, t);
+}
+
+#ifdef RSQRT_BF16_TEST
+/* Test the functionalities in this unit.
+ * Return 0 if successes. Otherwise, return a non-zero number,
+ * which indicates the first failed test.
+ */
+int test_rsqrt_bf16() {
+  bf16 r;
+  u32 s;
+
+  // 1: rsqrt(1) = 1
+  r = rsqrt_bf16(as_bf16(0x3F800000));  // 0 01111111 0000000
+  s = 0x3F800000;                       // 0 01111111 0000000
+  if (as_u32(r) != s) return 1;
+
+  // 2: rsqrt(4) = 0.5
+  r = rsqrt_bf16(as_bf16(0x40800000));  // 0 10000001 0000000
+  s = 0x3F000000;                       // 0 01111110 0000000
+  if (as_u32(r) != s) return 2;
+
+  // 3: rsqrt(2) = 0.707 (0.70711)
+  r = rsqrt_bf16(as_bf16(0x40000000));  // 0 10000000 0000000
+  s = 0x3F350000;                       // 0 01111110 0110101
+  if (as_u32(r) != s) return 3;
+
+  // 4: rsqrt(100) = 0.1001 (0.1)
+  r = rsqrt_bf16(as_bf16(0x42C80000));  // 0 10000101 1001000
+  s = 0x3DCD0000;                       // 0 01111011 1001101
+  if (as_u32(r) != s) return 4;
+
+  // 5: rsqrt(0) = +inf, rsqrt(-1) = NaN
+  r = rsqrt_bf16(as_bf16(0x80000000));  // 1 00000000 0000000
+  if (as_u32(r) != 0x7F800000) return 5;
+  r = rsqrt_bf16(as_bf16(0xBF800000));  // 1 01111111 0000000
+  if (as_u32(r) != 0x7FC00000) return 5;
+
+  // 6: within 2 ulp for all the positive normal numbers
+  for (u32 b = 0x00800000; b < 0x7F800000; b += 0x10000) {
+    float t = 1 / sqrtf(as_bf16(b));
+    float ulp = ldexpf(1, ilogbf(t) - 7);
+    if (fabsf(rsqrt_bf16(as_bf16(b)) - t) > 2 * ulp) return 6;
+  }
+
+  return 0;
+}
+
+#ifdef RSQRT_BF16_BENCH
+#define RSQRT_BF16_BENCH_N (1 << 16)
+
+static float bench_x[RSQRT_BF16_BENCH_N], bench_y[RSQRT_BF16_BENCH_N];
+
+/* the fp32 libm baseline */
+void rsqrt_fp32_array(const float *x, float *y, u32 n) {
+  for (u32 i = 0; i < n; i++) y[i] = 1 / sqrtf(x[i]);
+}
+void rsqrt_bf16_loop(const bf16 *x, bf16 *y, u32 n) {
+  for (u32 i = 0; i < n; i++) y[i] = rsqrt_bf16(x[i]);
+}
+
+void bench_rsqrt_bf16() {
+  const int repeat = 1000;
+  for (u32 i = 0; i < RSQRT_BF16_BENCH_N; i++)
+    bench_x[i] = as_bf16(((i * 0x9E37) % 0x1000 + 0x3800)
+                         << 16);  // 2^-15 <= x < 2^17
+  rsqrt_fp32_array(bench_x, bench_y, RSQRT_BF16_BENCH_N);  // warm up
+  BENCH_MEASURE(RSQRT_BF16_BENCH_N, repeat,
+                rsqrt_fp32_array(bench_x, bench_y, RSQRT_BF16_BENCH_N),
+                "%-20s", "rsqrt_fp32 (sqrtf)");
+  BENCH_MEASURE(RSQRT_BF16_BENCH_N, repeat,
+                rsqrt_bf16_loop(bench_x, bench_y, RSQRT_BF16_BENCH_N),
+                "%-20s", "rsqrt_bf16");
+}
+#endif  // RSQRT_BF16_BENCH
+
+int main() {
+  int error_code = test_rsqrt_bf16();
+  if (error_code != 0) {
+    printf("Test %d for rsqrt_bf16.c failed.\n", error_code);
+    return 1;
+  }
+  puts("Test for rsqrt_bf16.c passed.");
+
+#ifdef RSQRT_BF16_BENCH
+  bench_rsqrt_bf16();
+#endif  // RSQRT_BF16_BENCH
+  return 0;
+}
+#endif  // RSQRT_BF16_TEST
+
+#endif  // RSQRT_BF16_C
@@ -0,0 +1,514 @@
+/*
+ * This program implements and tests the following functionality:
+ *   A bf16 tensor (an n-dimensional array with shape and strides) whose
+ *   storage is 64-byte aligned and allocated from an arena, and
+ *   element-wise kernels on tensors.
+ *
+ * Arena (bf16_arena):
+ * (1) One buffer, either allocated once (bf16_arena_init) or provided by
+ *     the caller (bf16_arena_init_with).
+ * (2) Allocations are bumps of an offset, each aligned to
+ *     TENSOR_BF16_ALIGN bytes; nothing is freed one by one. Instead,
+ *     bf16_arena_mark and bf16_arena_release free everything allocated
+ *     after a mark, so that the buffers of a loop body are reused by
+ *     every iteration without calling malloc.
+ *
+ * Tensor (bf16_tensor):
+ * (1) Up to TENSOR_BF16_MAX_DIM dimensions; element (i0, i1, ...) is at
+ *     data[i0 * stride[0] + i1 * stride[1] + ...].
+ * (2) A tensor does not own its data: views (slices, selections and
+ *     transpositions) share the data of the tensor they are made from,
+ *     and tensor_bf16_wrap wraps any memory, e.g., an mmap'd checkpoint.
+ * (3) An invalid request (a full arena, an index out of range, ...)
+ *     returns a tensor whose data is NULL.
+ *
+ * The kernels work row by row (a row is the innermost dimension). Rows
+ * with unit stride are passed to the array kernels of dispatch_bf16.c
+ * directly; other rows are gathered in chunks into an aligned buffer on
+ * the stack first.
+ *
+ * Notice: Like dispatch_bf16.c, this unit must not be compiled with
+ *   -march=native.
+ *
+ * Version: 0.0
+ * Tested: 2026-10-18T20:40:00+08:00
+ */
+
+#ifndef TENSOR_BF16_C
+#define TENSOR_BF16_C
+
+#include <stddef.h>  // size_t
+#include <stdint.h>  // uintptr_t
+#include <stdlib.h>  // aligned_alloc, free
+
+#include "dispatch_bf16.c"
+#include "mul_bf16.c"
+#include "type_def.h"
+
+// uncomment the following line to test this program
+// #define TENSOR_BF16_TEST
+#ifdef TENSOR_BF16_TEST
+#include <stdio.h>  // puts, printf
+#endif              // TENSOR_BF16_TEST
+
+// alignment of the arena allocations (a cache line, and an AVX-512
+// register), in bytes
+#define TENSOR_BF16_ALIGN 64
+
+// maximal number of dimensions of a tensor
+#define TENSOR_BF16_MAX_DIM 4
+
+// number of elements gathered at a time from rows with non-unit stride
+#define TENSOR_BF16_CHUNK 256
+
+// ┌-------------------------------------------------------┐
+// |                         Arena                         |
+// └-------------------------------------------------------┘
+
+typedef struct {
+  char *base;   // aligned start of the buffer
+  size_t size;  // usable bytes from base
+  size_t used;  // bytes allocated, a multiple of TENSOR_BF16_ALIGN
+  void *owned;  // buffer to free, or NULL if provided by the caller
+} bf16_arena;
+
+static inline size_t tensor_bf16_align_up(size_t n) {
+  return (n + TENSOR_BF16_ALIGN - 1) & ~(size_t)(TENSOR_BF16_ALIGN - 1);
+}
+
+/* Initialize an arena with a new buffer of `size` bytes.
+ * Returns 0 if successes, or -1 if the buffer cannot be allocated.
+ */
+int bf16_arena_init(bf16_arena *arena, size_t size) {
+  size = tensor_bf16_align_up(size);
+  arena->owned = aligned_alloc(TENSOR_BF16_ALIGN, size ? size : 1);
+  arena->base = arena->owned;
+  arena->size = arena->owned ? size : 0;
+  arena->used = 0;
+  return arena->owned ? 0 : -1;
+}
+
+/* Initialize an arena on a buffer of `size` bytes provided by the caller,
+ * which must outlive the arena. The buffer need not be aligned; the bytes
+ * before its first aligned address are not used.
+ */
+void bf16_arena_init_with(bf16_arena *arena, void *buffer, size_t size) {
+  size_t skip = tensor_bf16_align_up((uintptr_t)buffer) - (uintptr_t)buffer;
+  arena->owned = NULL;
+  arena->base = (char *)buffer + skip;
+  arena->size = (size > skip) ? size - skip : 0;
+  arena->used = 0;
+}
+
+/* Allocate `size` bytes, aligned to TENSOR_BF16_ALIGN bytes.
+ * Returns NULL if the arena is full.
+ */
+void *bf16_arena_alloc(bf16_arena *arena, size_t size) {
+  size = tensor_bf16_align_up(size);
+  if (size > arena->size - arena->used) return NULL;
+  void *p = arena->base + arena->used;
+  arena->used += size;
+  return p;
+}
+
+/* Returns a mark of the current allocations, for bf16_arena_release. */
+size_t bf16_arena_mark(const bf16_arena *arena) { return arena->used; }
+
+/* Free everything allocated after the mark was taken. */
+void bf16_arena_release(bf16_arena *arena, size_t mark) {
+  if (mark < arena->used) arena->used = mark;
+}
+
+/* Free everything allocated from the arena. */
+void bf16_arena_reset(bf16_arena *arena) { arena->used = 0; }
+
+/* Free the buffer of the arena, if it was allocated by bf16_arena_init. */
+void bf16_arena_free(bf16_arena *arena) {
+  free(arena->owned);
+  arena->owned = NULL;
+  arena->base = NULL;
+  arena->size = arena->used = 0;
+}
+
+// ┌-------------------------------------------------------┐
+// |                         Tensor                        |
+// └-------------------------------------------------------┘
+
+typedef struct {
+  bf16 *data;                        // element (0, 0, ...), NULL if invalid
+  u32 ndim;                          // number of dimensions
+  u32 shape[TENSOR_BF16_MAX_DIM];    // size of each dimension
+  i32 stride[TENSOR_BF16_MAX_DIM];   // distance between elements, in bf16
+} bf16_tensor;
+
+/* Returns the number of elements of a tensor (1 for 0 dimensions). */
+u32 tensor_bf16_numel(const bf16_tensor *t) {
+  u32 n = 1;
+  for (u32 d = 0; d < t->ndim; d++) n *= t->shape[d];
+  return n;
+}
+
+/* Returns whether the elements are consecutive in memory in row-major
+ * order, i.e., the tensor is the same as a plain array.
+ */
+int tensor_bf16_is_contiguous(const bf16_tensor *t) {
+  i32 stride = 1;
+  for (u32 d = t->ndim; d-- > 0;) {
+    if (t->shape[d] != 1 && t->stride[d] != stride) return 0;
+    stride *= t->shape[d];
+  }
+  return 1;
+}
+
+/* Returns a row-major tensor on `data`, with ndim dimensions of the
+ * given shape. The data is neither copied nor owned by the tensor.
+ */
+bf16_tensor tensor_bf16_wrap(bf16 *data, u32 ndim, const u32 *shape) {
+  bf16_tensor t = {0};
+  if (ndim > TENSOR_BF16_MAX_DIM) return t;
+  t.ndim = ndim;
+  i32 stride = 1;
+  for (u32 d = ndim; d-- > 0;) {
+    t.shape[d] = shape[d];
+    t.stride[d] = stride;
+    stride *= shape[d];
+  }
+  t.data = data;
+  return t;
+}
+
+/* Returns a new row-major tensor of the given shape, allocated from the
+ * arena (uninitialized). The data is NULL if the arena is full.
+ */
+bf16_tensor tensor_bf16_alloc(bf16_arena *arena, u32 ndim, const u32 *shape) {
+  if (ndim > TENSOR_BF16_MAX_DIM) return (bf16_tensor){0};
+  size_t n = 1;
+  for (u32 d = 0; d < ndim; d++) n *= shape[d];
+  return tensor_bf16_wrap(bf16_arena_alloc(arena, n * sizeof(bf16)), ndim,
+                          shape);
+}
+
+/* Returns the address of an element; index has t->ndim entries.
+ * Returns NULL if the index is out of range.
+ */
+bf16 *tensor_bf16_at(const bf16_tensor *t, const u32 *index) {
+  i32 offset = 0;
+  for (u32 d = 0; d < t->ndim; d++) {
+    if (index[d] >= t->shape[d]) return NULL;
+    offset += (i32)index[d] * t->stride[d];
+  }
+  return t->data + offset;
+}
+
+/* Returns the view of the elements start, start + step, ..., before stop
+ * along dimension dim (zero-copy). Requires start <= stop <= shape[dim]
+ * and step >= 1.
+ */
+bf16_tensor tensor_bf16_slice(const bf16_tensor *t, u32 dim, u32 start,
+                              u32 stop, u32 step) {
+  bf16_tensor v = *t;
+  if (dim >= t->ndim || start > stop || stop > t->shape[dim] || step == 0) {
+    v.data = NULL;
+    return v;
+  }
+  v.shape[dim] = (stop - start + step - 1) / step;
+  v.stride[dim] = t->stride[dim] * (i32)step;
+  if (v.data) v.data += (i32)start * t->stride[dim];
+  return v;
+}
+
+/* Returns the view of the elements with the given index along dimension
+ * dim, which has one dimension fewer (zero-copy).
+ */
+bf16_tensor tensor_bf16_select(const bf16_tensor *t, u32 dim, u32 index) {
+  bf16_tensor v = *t;
+  if (dim >= t->ndim || index >= t->shape[dim]) {
+    v.data = NULL;
+    return v;
+  }
+  if (v.data) v.data += (i32)index * t->stride[dim];
+  for (u32 d = dim; d + 1 < t->ndim; d++) {
+    v.shape[d] = t->shape[d + 1];
+    v.stride[d] = t->stride[d + 1];
+  }
+  v.ndim--;
+  v.shape[v.ndim] = 0;
+  v.stride[v.ndim] = 0;
+  return v;
+}
+
+/* Returns the view with dimensions d0 and d1 swapped (zero-copy). */
+bf16_tensor tensor_bf16_transpose(const bf16_tensor *t, u32 d0, u32 d1) {
+  bf16_tensor v = *t;
+  if (d0 >= t->ndim || d1 >= t->ndim) {
+    v.data = NULL;
+    return v;
+  }
+  v.shape[d0] = t->shape[d1], v.shape[d1] = t->shape[d0];
+  v.stride[d0] = t->stride[d1], v.stride[d1] = t->stride[d0];
+  return v;
+}
+
+/* Returns whether two tensors are valid and have the same shape. */
+int tensor_bf16_same_shape(const bf16_tensor *a, const bf16_tensor *b) {
+  if (!a->data || !b->data || a->ndim != b->ndim) return 0;
+  for (u32 d = 0; d < a->ndim; d++)
+    if (a->shape[d] != b->shape[d]) return 0;
+  return 1;
+}
+
+// ┌-------------------------------------------------------┐
+// |                        Kernels                        |
+// └-------------------------------------------------------┘
+
+/* Returns the offset of the first element of row r, where rows are
+ * numbered in row-major order over all the dimensions but the last
+ * (a 0-dim tensor has one row of one element).
+ */
+static i32 tensor_bf16_row(const bf16_tensor *t, u32 r) {
+  i32 offset = 0;
+  for (u32 d = t->ndim ? t->ndim - 1 : 0; d-- > 0;) {
+    offset += (i32)(r % t->shape[d]) * t->stride[d];
+    r /= t->shape[d];
+  }
+  return offset;
+}
+
+/* the length and the stride of the rows of a tensor */
+static inline u32 tensor_bf16_row_length(const bf16_tensor *t) {
+  return t->ndim ? t->shape[t->ndim - 1] : 1;
+}
+static inline i32 tensor_bf16_row_stride(const bf16_tensor *t) {
+  return t->ndim ? t->stride[t->ndim - 1] : 1;
+}
+
+/* y[i] = p[i * stride] and p[i * stride] = y[i], for i < n */
+static void tensor_bf16_gather(const bf16 *p, i32 stride, bf16 *y, u32 n) {
+  for (u32 i = 0; i < n; i++) y[i] = p[(i32)i * stride];
+}
+static void tensor_bf16_scatter(const bf16 *y, bf16 *p, i32 stride, u32 n) {
+  for (u32 i = 0; i < n; i++) p[(i32)i * stride] = y[i];
+}
+
+void mul_bf16_array(const bf16 *a, const bf16 *b, bf16 *y, u32 n) {
+  for (u32 i = 0; i < n; i++) y[i] = mul_bf16(a[i], b[i]);
+}
+
+/* y = f(x) element-wise, for an array kernel f(x, y, n).
+ * Returns 0 if successes, or -1 if the shapes differ.
+ */
+int tensor_bf16_map(const bf16_tensor *x, const bf16_tensor *y,
+                    void (*f)(const bf16 *, bf16 *, u32)) {
+  if (!tensor_bf16_same_shape(x, y)) return -1;
+  u32 n = tensor_bf16_row_length(x), rows = n ? tensor_bf16_numel(x) / n : 0;
+  i32 sx = tensor_bf16_row_stride(x), sy = tensor_bf16_row_stride(y);
+  _Alignas(TENSOR_BF16_ALIGN) bf16 buffer[TENSOR_BF16_CHUNK];
+
+  for (u32 r = 0; r < rows; r++) {
+    const bf16 *px = x->data + tensor_bf16_row(x, r);
+    bf16 *py = y->data + tensor_bf16_row(y, r);
+    if (sx == 1 && sy == 1) {
+      f(px, py, n);
+      continue;
+    }
+    for (u32 i = 0; i < n; i += TENSOR_BF16_CHUNK) {
+      u32 k = (n - i < TENSOR_BF16_CHUNK) ? n - i : TENSOR_BF16_CHUNK;
+      tensor_bf16_gather(px + (i32)i * sx, sx, buffer, k);
+      f(buffer, buffer, k);
+      tensor_bf16_scatter(buffer, py + (i32)i * sy, sy, k);
+    }
+  }
+  return 0;
+}
+
+/* y = f(a, b) element-wise, for an array kernel f(a, b, y, n).
+ * Returns 0 if successes, or -1 if the shapes differ.
+ */
+int tensor_bf16_map2(const bf16_tensor *a, const bf16_tensor *b,
+                     const bf16_tensor *y,
+                     void (*f)(const bf16 *, const bf16 *, bf16 *, u32)) {
+  if (!tensor_bf16_same_shape(a, b) || !tensor_bf16_same_shape(a, y))
+    return -1;
+  u32 n = tensor_bf16_row_length(a), rows = n ? tensor_bf16_numel(a) / n : 0;
+  i32 sa = tensor_bf16_row_stride(a), sb = tensor_bf16_row_stride(b);
+  i32 sy = tensor_bf16_row_stride(y);
+  _Alignas(TENSOR_BF16_ALIGN) bf16 buffer[2][TENSOR_BF16_CHUNK];
+
+  for (u32 r = 0; r < rows; r++) {
+    const bf16 *pa = a->data + tensor_bf16_row(a, r);
+    const bf16 *pb = b->data + tensor_bf16_row(b, r);
+    bf16 *py = y->data + tensor_bf16_row(y, r);
+    if (sa == 1 && sb == 1 && sy == 1) {
+      f(pa, pb, py, n);
+      continue;
+    }
+    for (u32 i = 0; i < n; i += TENSOR_BF16_CHUNK) {
+      u32 k = (n - i < TENSOR_BF16_CHUNK) ? n - i : TENSOR_BF16_CHUNK;
+      tensor_bf16_gather(pa + (i32)i * sa, sa, buffer[0], k);
+      tensor_bf16_gather(pb + (i32)i * sb, sb, buffer[1], k);
+      f(buffer[0], buffer[1], buffer[0], k);
+      tensor_bf16_scatter(buffer[0], py + (i32)i * sy, sy, k);
+    }
+  }
+  return 0;
+}
+
+/* y = ln(x) element-wise; y may be x. Returns 0, or -1 on a shape error. */
+int tensor_ln_bf16(const bf16_tensor *x, const bf16_tensor *y) {
+  return tensor_bf16_map(x, y, ln_bf16_array);
+}
+
+/* y = a * b element-wise. Returns 0, or -1 on a shape error. */
+int tensor_mul_bf16(const bf16_tensor *a, const bf16_tensor *b,
+                    const bf16_tensor *y) {
+  return tensor_bf16_map2(a, b, y, mul_bf16_array);
+}
+
+/* Convert a row-major fp32 array of y's shape to the tensor y.
+ * Returns 0, or -1 if y is invalid.
+ */
+int tensor_bf16_from_fp32(const float *x, const bf16_tensor *y) {
+  if (!y->data) return -1;
+  if (tensor_bf16_is_contiguous(y)) {
+    fp32_to_bf16_array(x, y->data, tensor_bf16_numel(y));
+    return 0;
+  }
+  // the fp32 source is a row-major tensor of the same shape
+  bf16_tensor src = tensor_bf16_wrap((bf16 *)x, y->ndim, y->shape);
+  return tensor_bf16_map(&src, y, fp32_to_bf16_array);
+}
+
+/* Convert the tensor x to a row-major fp32 array of its shape.
+ * Returns 0, or -1 if x is invalid.
+ */
+int tensor_bf16_to_fp32(const bf16_tensor *x, float *y) {
+  if (!x->data) return -1;
+  bf16_tensor dst = tensor_bf16_wrap(y, x->ndim, x->shape);
+  return tensor_bf16_map(x, &dst, bf16_to_fp32_array);
+}
+
+#ifdef TENSOR_BF16_TEST
+/* Test the functionalities in this unit.
+ * Return 0 if successes. Otherwise, return a non-zero number,
+ * which indicates the first failed test.
+ */
+int test_tensor_bf16() {
+  static char memory[1 << 16];
+  bf16_arena arena;
+  bf16_tensor t, v, w;
+
+  // 1: allocations are aligned, and fail when the arena is full
+  bf16_arena_init_with(&arena, memory + 1, sizeof(memory) - 1);
+  void *p = bf16_arena_alloc(&arena, 3);
+  void *q = bf16_arena_alloc(&arena, 100);
+  if ((uintptr_t)p % TENSOR_BF16_ALIGN || (uintptr_t)q % TENSOR_BF16_ALIGN)
+    return 1;
+  if ((char *)q - (char *)p != TENSOR_BF16_ALIGN) return 1;
+  if (bf16_arena_alloc(&arena, sizeof(memory))) return 1;
+
+  // 2: release frees everything after the mark, so the memory is reused
+  size_t mark = bf16_arena_mark(&arena);
+  void *r = bf16_arena_alloc(&arena, 1000);
+  bf16_arena_release(&arena, mark);
+  if (bf16_arena_alloc(&arena, 1000) != r) return 2;
+  bf16_arena_reset(&arena);
+  if (bf16_arena_alloc(&arena, 1) != p) return 2;
+
+  // 3: a 2 x 3 x 4 tensor from an owned arena, filled with 0, 1, 2, ...
+  bf16_arena_free(&arena);
+  if (bf16_arena_init(&arena, 1 << 20) != 0) return 3;
+  u32 shape[3] = {2, 3, 4};
+  t = tensor_bf16_alloc(&arena, 3, shape);
+  if (!t.data || (uintptr_t)t.data % TENSOR_BF16_ALIGN) return 3;
+  if (tensor_bf16_numel(&t) != 24 || !tensor_bf16_is_contiguous(&t)) return 3;
+  if (t.stride[0] != 12 || t.stride[1] != 4 || t.stride[2] != 1) return 3;
+  for (u32 i = 0; i < 24; i++) t.data[i] = i32_to_bf16(i);
+  u32 index[3] = {1, 2, 3};
+  if (*tensor_bf16_at(&t, index) != 23) return 3;
+  index[1] = 3;
+  if (tensor_bf16_at(&t, index)) return 3;  // out of range
+
+  // 4: views share the data: t[1, :, 1:4:2] is {13, 15, 17, 19, 21, 23}
+  v = tensor_bf16_select(&t, 0, 1);
+  v = tensor_bf16_slice(&v, 1, 1, 4, 2);
+  if (v.ndim != 2 || v.shape[0] != 3 || v.shape[1] != 2) return 4;
+  if (tensor_bf16_is_contiguous(&v)) return 4;
+  index[0] = 2, index[1] = 1;
+  if (*tensor_bf16_at(&v, index) != 23) return 4;
+  *tensor_bf16_at(&v, index) = 99;
+  if (t.data[23] != 99) return 4;
+  t.data[23] = 23;
+
+  // 5: invalid views
+  if (tensor_bf16_slice(&t, 2, 3, 5, 1).data) return 5;
+  if (tensor_bf16_select(&t, 3, 0).data) return 5;
+  if (tensor_bf16_alloc(&arena, 3, (u32[]){1024, 1024, 1}).data) return 5;
+
+  // 6: ln of a transposed view (strided rows), in place, is ln of each
+  //    element; the other elements are unchanged
+  w = tensor_bf16_transpose(&t, 1, 2);  // 2 x 4 x 3
+  w = tensor_bf16_slice(&w, 1, 1, 4, 1);
+  if (tensor_ln_bf16(&w, &w) != 0) return 6;
+  for (u32 i = 0; i < 24; i++) {
+    bf16 s = i32_to_bf16(i);
+    if (i % 4 != 0) s = ln_bf16(s);
+    if (as_u32(t.data[i]) != as_u32(s)) return 6;
+  }
+
+  // 7: mul of tensors with different strides, and a shape error
+  u32 n = 1000;
+  bf16_tensor a = tensor_bf16_alloc(&arena, 1, &n);
+  bf16_tensor b = tensor_bf16_alloc(&arena, 2, (u32[]){n, 2});
+  bf16_tensor y = tensor_bf16_alloc(&arena, 1, &n);
+  for (u32 i = 0; i < n; i++) {
+    a.data[i] = i32_to_bf16(i);
+    b.data[2 * i] = i32_to_bf16(-3);
+    b.data[2 * i + 1] = 0;
+  }
+  w = tensor_bf16_select(&b, 1, 0);
+  if (tensor_mul_bf16(&a, &w, &y) != 0) return 7;
+  for (u32 i = 0; i < n; i++)
+    if (as_u32(y.data[i]) != as_u32(mul_bf16(a.data[i], b.data[2 * i])))
+      return 7;
+  if (tensor_mul_bf16(&a, &b, &y) != -1) return 7;
+
+  // 8: fp32 conversion of a strided view, both ways
+  static float f[24], g[24];
+  for (u32 i = 0; i < 24; i++) f[i] = 1.0f + i / 256.0f;  // ties
+  w = tensor_bf16_transpose(&t, 0, 2);  // 4 x 3 x 2
+  if (tensor_bf16_from_fp32(f, &w) != 0) return 8;
+  if (tensor_bf16_to_fp32(&w, g) != 0) return 8;
+  for (u32 i = 0; i < 24; i++)
+    if (as_u32(g[i]) != as_u32(fp32_to_bf16(f[i]))) return 8;
+  if (*tensor_bf16_at(&t, (u32[]){1, 2, 3}) != g[23]) return 8;
+
+  // 9: wrapping external memory does not copy it; a kernel on a 0-dim
+  //    view changes its one element only
+  static bf16 external[6] = {1, 2, 3, 4, 5, 6};
+  t = tensor_bf16_wrap(external, 2, (u32[]){2, 3});
+  v = tensor_bf16_select(&t, 1, 2);
+  if (v.ndim != 1 || v.shape[0] != 2 || v.data != external + 2) return 9;
+  if (tensor_bf16_numel(&(bf16_tensor){external, 0, {0}, {0}}) != 1) return 9;
+  w = tensor_bf16_select(&v, 0, 1);
+  if (w.ndim != 0 || w.data != external + 5) return 9;
+  if (tensor_ln_bf16(&w, &w) != 0) return 9;
+  if (as_u32(external[5]) != as_u32(ln_bf16(6))) return 9;
+  if (as_u32(external[2]) != as_u32((bf16)3)) return 9;
+
+  bf16_arena_free(&arena);
+  return 0;
+}
+
+int main() {
+  int error_code = test_tensor_bf16();
+  if (error_code == 0) {
+    puts("Test for tensor_bf16.c passed.");
+    return 0;
+  } else {
+    printf("Test %d for tensor_bf16.c failed.\n", error_code);
+    return 1;
+  }
+}
+#endif  // TENSOR_BF16_TEST
+
+#endif  // TENSOR_BF16_C
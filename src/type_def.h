@@ -4,5 +4,8 @@
 typedef float bf16;
 typedef unsigned int u32;
 typedef int i32;
+typedef signed char i8;
+typedef unsigned long long u64;
+typedef long long i64;
 
 #endif  // TYPE_DEF_H
\ No newline at end of file